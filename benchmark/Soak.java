@@ -0,0 +1,390 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Random;
+import java.util.concurrent.atomic.AtomicLong;
+import org.opengis.referencing.crs.CRSAuthorityFactory;
+import org.opengis.referencing.crs.CoordinateReferenceSystem;
+import org.opengis.referencing.crs.GeographicCRS;
+import org.opengis.referencing.crs.ProjectedCRS;
+import org.opengis.referencing.operation.CoordinateOperation;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+import org.opengis.util.FactoryException;
+import org.osgeo.proj.Proj;
+
+
+/**
+ * Runs a mixed workload for a long time and checks that memory usage and throughput are stable.
+ * The workload mixes authority lookups, parsing of WKT strings, searches of coordinate operations
+ * and transformations of points by many threads in parallel. Most created objects are discarded
+ * immediately, which exercises the release of native resources. At regular intervals, this program
+ * samples the resident set size of the process, the Java heap, the native allocator statistics and
+ * the internal counters reported by {@link Proj#getResourceCounts()}.
+ *
+ * <p>After a warmup period, the samples of the first quarter are compared with the samples of the
+ * last quarter. The program exits with status 1 if a measurement grew beyond the tolerance or if
+ * the throughput decayed, and with status 2 if the run was too short for drawing a conclusion.</p>
+ */
+public class Soak {
+    /**
+     * Fraction of the samples to ignore at the beginning, while caches and pools are filled.
+     */
+    private static final double WARMUP = 0.2;
+
+    /**
+     * Minimal number of samples after the warmup for allowing a conclusion.
+     */
+    private static final int MIN_SAMPLES = 8;
+
+    /**
+     * Maximal relative growth of memory measurements, in addition to {@link #MEMORY_SLACK}.
+     */
+    private static final double MEMORY_GROWTH = 0.1;
+
+    /**
+     * Absolute growth of memory measurements which is always tolerated, in bytes.
+     */
+    private static final long MEMORY_SLACK = 32L * 1024 * 1024;
+
+    /**
+     * Maximal growth factor of object counts, in addition to {@link #COUNT_SLACK}.
+     */
+    private static final double COUNT_GROWTH = 1.5;
+
+    /**
+     * Absolute growth of object counts which is always tolerated.
+     */
+    private static final long COUNT_SLACK = 16;
+
+    /**
+     * Minimal ratio of the throughput at the end of the run compared to the beginning.
+     */
+    private static final double MIN_THROUGHPUT = 0.8;
+
+    /**
+     * Number of points to transform in a single call.
+     */
+    private static final int NUM_POINTS = 1000;
+
+    /**
+     * Name of the measurement of the resident set size of the process.
+     */
+    private static final String RSS = "rss";
+
+    /**
+     * Name of the measurement of the Java heap in use.
+     */
+    private static final String HEAP = "heap";
+
+    /**
+     * Names of the measurements which are numbers of bytes. Other measurements are object counts.
+     */
+    private static final List<String> BYTES = Arrays.asList(RSS, HEAP, "mallocInUse");
+
+    /**
+     * The CRS to create from their authority codes.
+     */
+    private final String[] codes;
+
+    /**
+     * WKT of the CRS to parse.
+     */
+    private final String[] wkt;
+
+    /**
+     * Sources and targets of the coordinate operations to search.
+     */
+    private final CoordinateReferenceSystem[] sources, targets;
+
+    /**
+     * Transforms to apply on random points in the conterminous United States.
+     */
+    private final MathTransform[] transforms;
+
+    /**
+     * Number of tasks completed by all threads, and number of tasks which failed.
+     */
+    private final AtomicLong count, errors;
+
+    /**
+     * Time (as given by {@link System#nanoTime()}) when the workers should stop.
+     */
+    private volatile long end;
+
+    /**
+     * Prepares the objects used by the workload.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or a coordinate operation.
+     */
+    private Soak() throws FactoryException {
+        final CRSAuthorityFactory factory = Proj.getAuthorityFactory("EPSG");
+        final List<String> codes = new ArrayList<>();
+        final List<String> wkt = new ArrayList<>();
+        final List<CoordinateReferenceSystem> targets = new ArrayList<>();
+        for (int code = 2000; code < 4000 && codes.size() < 500; code++) {
+            final CoordinateReferenceSystem c;
+            try {
+                c = factory.createCoordinateReferenceSystem(Integer.toString(code));
+            } catch (FactoryException e) {
+                continue;                               // Unused code, ignore.
+            }
+            codes.add(Integer.toString(code));
+            wkt.add(c.toWKT());
+            if (c instanceof ProjectedCRS) {
+                targets.add(c);
+            }
+        }
+        this.codes   = codes.toArray(new String[codes.size()]);
+        this.wkt     = wkt.toArray(new String[wkt.size()]);
+        this.targets = targets.toArray(new CoordinateReferenceSystem[targets.size()]);
+        final String[] geographic = {"4326", "4267", "4269", "4258", "4230", "4277"};
+        sources = new CoordinateReferenceSystem[geographic.length];
+        for (int i=0; i<geographic.length; i++) {
+            sources[i] = factory.createCoordinateReferenceSystem(geographic[i]);
+        }
+        final GeographicCRS nad27 = factory.createGeographicCRS("4267");
+        final GeographicCRS wgs84 = factory.createGeographicCRS("4326");
+        transforms = new MathTransform[] {
+            Proj.createCoordinateOperation(nad27, factory.createGeographicCRS("4269"), null).getMathTransform(),
+            Proj.createCoordinateOperation(wgs84, factory.createProjectedCRS("3395"),  null).getMathTransform(),
+            Proj.createCoordinateOperation(wgs84, factory.createProjectedCRS("3857"),  null).getMathTransform(),
+            Proj.createCoordinateOperation(wgs84, factory.createProjectedCRS("5070"),  null).getMathTransform()
+        };
+        count  = new AtomicLong();
+        errors = new AtomicLong();
+    }
+
+    /**
+     * Runs the soak test.
+     *
+     * @param  args  duration in minutes, number of threads and interval between samples in seconds.
+     * @throws FactoryException if an error occurred while preparing the workload.
+     * @throws InterruptedException if the test has been interrupted.
+     */
+    public static void main(String[] args) throws FactoryException, InterruptedException {
+        final double minutes    = (args.length > 0) ? Double.parseDouble(args[0]) : 10;
+        final int    numThreads = (args.length > 1) ? Integer.parseInt(args[1]) : Runtime.getRuntime().availableProcessors();
+        final double interval   = (args.length > 2) ? Double.parseDouble(args[2]) : 10;
+        final Soak soak = new Soak();
+        System.out.printf("Duration: %.1f minutes, threads: %d, sample interval: %.1f s%n", minutes, numThreads, interval);
+        System.out.printf("Number of CRS: %,d, operation targets: %,d%n%n", soak.codes.length, soak.targets.length);
+
+        final long startTime = System.nanoTime();
+        soak.end = startTime + (long) (minutes * 60E9);
+        final Thread[] threads = new Thread[numThreads];
+        for (int t=0; t<numThreads; t++) {
+            final long seed = t;
+            threads[t] = new Thread(() -> soak.work(new Random(seed)), "Soak worker " + t);
+            threads[t].start();
+        }
+        final List<Map<String,Long>> samples = new ArrayList<>();
+        final List<Double> throughputs = new ArrayList<>();
+        long previousTime  = startTime;
+        long previousCount = 0;
+        boolean header = true;
+        while (System.nanoTime() < soak.end) {
+            Thread.sleep((long) (interval * 1000));
+            final long time  = System.nanoTime();
+            final long count = soak.count.get();
+            final double rate = (count - previousCount) / ((time - previousTime) / 1E9);
+            previousTime  = time;
+            previousCount = count;
+            final Map<String,Long> sample = sample();
+            if (header) {
+                System.out.printf("%8s %10s", "Time (s)", "Tasks/s");
+                for (final String name : sample.keySet()) {
+                    System.out.printf(" %16s", name);
+                }
+                System.out.println();
+                header = false;
+            }
+            System.out.printf("%8.0f %,10.0f", (time - startTime) / 1E9, rate);
+            for (final Long value : sample.values()) {
+                System.out.printf(" %,16d", value);
+            }
+            System.out.println();
+            samples.add(sample);
+            throughputs.add(rate);
+        }
+        for (final Thread thread : threads) {
+            thread.join();
+        }
+        System.out.printf("%nTasks: %,d, errors: %,d%n", soak.count.get(), soak.errors.get());
+        System.exit(verify(samples, throughputs));
+    }
+
+    /**
+     * Executes random tasks until the end of the run.
+     *
+     * @param  random  the generator of random tasks and random points.
+     */
+    private void work(final Random random) {
+        final double[] points = new double[NUM_POINTS * 2];
+        while (System.nanoTime() < end) {
+            try {
+                switch (random.nextInt(4)) {
+                    case 0: {
+                        Proj.getAuthorityFactory("EPSG").createCoordinateReferenceSystem(codes[random.nextInt(codes.length)]);
+                        break;
+                    }
+                    case 1: {
+                        Proj.createFromUserInput(wkt[random.nextInt(wkt.length)]);
+                        break;
+                    }
+                    case 2: {
+                        final CoordinateOperation op = Proj.createCoordinateOperation(
+                                sources[random.nextInt(sources.length)],
+                                targets[random.nextInt(targets.length)], null);
+                        op.getMathTransform();
+                        break;
+                    }
+                    default: {
+                        for (int i=0; i<points.length; i += 2) {
+                            points[i  ] =   25 + 24 * random.nextDouble();        // Latitude
+                            points[i+1] = -124 + 57 * random.nextDouble();        // Longitude
+                        }
+                        transforms[random.nextInt(transforms.length)].transform(points, 0, points, 0, NUM_POINTS);
+                        break;
+                    }
+                }
+            } catch (FactoryException | TransformException e) {
+                errors.incrementAndGet();
+            }
+            count.incrementAndGet();
+        }
+    }
+
+    /**
+     * Takes a sample of memory usage and of the internal counters of PROJ-JNI.
+     * A garbage collection is requested first, so that objects which are no longer
+     * referenced do not hide a leak.
+     *
+     * @return the measurements, in bytes or number of objects. Values are -1 if not available.
+     * @throws InterruptedException if the test has been interrupted.
+     */
+    private static Map<String,Long> sample() throws InterruptedException {
+        System.gc();
+        Thread.sleep(100);                  // Give some time to the cleaner threads.
+        final Runtime rt = Runtime.getRuntime();
+        final Map<String,Long> sample = new LinkedHashMap<>();
+        sample.put(RSS,  residentSetSize());
+        sample.put(HEAP, rt.totalMemory() - rt.freeMemory());
+        sample.putAll(Proj.getResourceCounts());
+        return sample;
+    }
+
+    /**
+     * Returns the resident set size of this process in bytes, or -1 if unknown.
+     * This information is read from {@code /proc/self/status}, which is available on Linux only.
+     *
+     * @return resident set size in bytes, or -1 if unknown.
+     */
+    private static long residentSetSize() {
+        final Path status = Paths.get("/proc/self/status");
+        if (Files.isReadable(status)) try {
+            for (final String line : Files.readAllLines(status)) {
+                if (line.startsWith("VmRSS:")) {
+                    return Long.parseLong(line.substring(6).replace("kB", "").trim()) * 1024;
+                }
+            }
+        } catch (IOException | NumberFormatException e) {
+            // Ignore, will return -1.
+        }
+        return -1;
+    }
+
+    /**
+     * Compares the samples at the beginning and at the end of the run, ignoring the warmup.
+     *
+     * @param  samples      measurements taken at regular intervals.
+     * @param  throughputs  number of tasks per second at the time of each sample.
+     * @return exit status: 0 if the test passed, 1 if it failed, 2 if inconclusive.
+     */
+    private static int verify(final List<Map<String,Long>> samples, final List<Double> throughputs) {
+        final int start = (int) Math.ceil(samples.size() * WARMUP);
+        final int n = samples.size() - start;
+        if (n < MIN_SAMPLES) {
+            System.out.printf("INCONCLUSIVE: %d samples after warmup, need at least %d.%n", Math.max(n, 0), MIN_SAMPLES);
+            return 2;
+        }
+        final int quarter = n / 4;
+        boolean failed = false;
+        for (final String name : samples.get(0).keySet()) {
+            final double[] first = new double[quarter];
+            final double[] last  = new double[quarter];
+            for (int i=0; i<quarter; i++) {
+                first[i] = samples.get(start + i).get(name);
+                last [i] = samples.get(samples.size() - quarter + i).get(name);
+            }
+            final double before = median(first);
+            final double after  = median(last);
+            if (before < 0 || after < 0) {
+                continue;                               // Measurement not available.
+            }
+            final double limit = BYTES.contains(name) ? before * (1 + MEMORY_GROWTH) + MEMORY_SLACK
+                                                      : before * COUNT_GROWTH + COUNT_SLACK;
+            if (after > limit) {
+                System.out.printf("FAILED: %s grew from %,.0f to %,.0f (limit %,.0f).%n", name, before, after, limit);
+                failed = true;
+            }
+        }
+        final double[] first = new double[quarter];
+        final double[] last  = new double[quarter];
+        for (int i=0; i<quarter; i++) {
+            first[i] = throughputs.get(start + i);
+            last [i] = throughputs.get(throughputs.size() - quarter + i);
+        }
+        final double before = median(first);
+        final double after  = median(last);
+        if (after < before * MIN_THROUGHPUT) {
+            System.out.printf("FAILED: throughput decayed from %,.0f to %,.0f tasks/s.%n", before, after);
+            failed = true;
+        }
+        if (failed) {
+            return 1;
+        }
+        System.out.println("PASSED: no growth of memory or internal counters, and no throughput decay.");
+        return 0;
+    }
+
+    /**
+     * Returns the median of the given values. The array is sorted in-place.
+     *
+     * @param  values  the values for which to get the median.
+     * @return median of the given values.
+     */
+    private static double median(final double[] values) {
+        Arrays.sort(values);
+        final int i = values.length / 2;
+        return (values.length & 1) != 0 ? values[i] : (values[i-1] + values[i]) / 2;
+    }
+}
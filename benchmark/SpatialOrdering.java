@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+import java.util.Arrays;
+import java.util.Random;
+import org.opengis.referencing.crs.CRSAuthorityFactory;
+import org.opengis.referencing.operation.CoordinateOperation;
+import org.opengis.referencing.operation.TransformException;
+import org.opengis.util.FactoryException;
+import org.osgeo.proj.BatchTransform;
+import org.osgeo.proj.Proj;
+
+
+/**
+ * Benchmarks the transformation of points in random order with and without spatial ordering.
+ * Points are generated in (latitude, longitude) order, which is the axis order of most
+ * geographic CRS defined by EPSG.
+ */
+public class SpatialOrdering {
+    /**
+     * Number of times to repeat each measurement. The median is reported.
+     */
+    private static final int REPEAT = 7;
+
+    /**
+     * Runs the benchmark.
+     *
+     * @param  args  source and target EPSG codes, south, north, west and east bounds, number of points.
+     * @throws FactoryException    if an error occurred while creating a CRS or the coordinate operation.
+     * @throws TransformException  if an error occurred while applying the operation on coordinate values.
+     */
+    public static void main(String[] args) throws FactoryException, TransformException {
+        if (args.length < 6) {
+            args = new String[] {"4267", "4269", "25", "49", "-124", "-67"};
+        }
+        final double south = Double.parseDouble(args[2]);
+        final double north = Double.parseDouble(args[3]);
+        final double west  = Double.parseDouble(args[4]);
+        final double east  = Double.parseDouble(args[5]);
+        final int numPts   = (args.length > 6) ? Integer.parseInt(args[6]) : 2_000_000;
+
+        CRSAuthorityFactory factory = Proj.getAuthorityFactory("EPSG");
+        CoordinateOperation operation = Proj.createCoordinateOperation(
+                factory.createCoordinateReferenceSystem(args[0]),
+                factory.createCoordinateReferenceSystem(args[1]), null);
+        System.out.printf("Operation: %s%n", operation.getName().getCode());
+        System.out.printf("Number of points: %,d%n%n", numPts);
+
+        final Random random = new Random(42);
+        final double[] source = new double[numPts * 2];
+        for (int i=0; i<source.length; i += 2) {
+            source[i  ] = south + (north - south) * random.nextDouble();
+            source[i+1] = west  + (east  - west)  * random.nextDouble();
+        }
+        final BatchTransform batch = new BatchTransform(operation.getMathTransform());
+        final double[] unordered = new double[source.length];
+        final double[] ordered   = new double[source.length];
+        final long[] times = new long[2];
+        for (int pass = 0; pass < 2; pass++) {              // First pass is warmup.
+            batch.setSpatialOrdering(false);
+            times[0] = measure(batch, source, unordered);
+            batch.setSpatialOrdering(true);
+            times[1] = measure(batch, source, ordered);
+        }
+        if (!Arrays.equals(unordered, ordered)) {
+            System.out.println("WARNING: results differ with spatial ordering.");
+        }
+        System.out.printf("Random order:  %8.1f ms  (%,.0f points/s)%n", times[0] / 1E6, numPts / (times[0] / 1E9));
+        System.out.printf("Morton order:  %8.1f ms  (%,.0f points/s)%n", times[1] / 1E6, numPts / (times[1] / 1E9));
+        System.out.printf("Speedup:       %8.2f×%n", times[0] / (double) times[1]);
+    }
+
+    /**
+     * Returns the median time in nanoseconds for transforming all points.
+     *
+     * @param  batch   the transform to apply.
+     * @param  source  the source coordinates.
+     * @param  target  where to write the transformed coordinates.
+     * @return median execution time in nanoseconds.
+     * @throws TransformException if an error occurred while applying the operation on coordinate values.
+     */
+    private static long measure(BatchTransform batch, double[] source, double[] target) throws TransformException {
+        final long[] times = new long[REPEAT];
+        for (int i=0; i<REPEAT; i++) {
+            final long start = System.nanoTime();
+            batch.transform(source, 0, target, 0, source.length / 2);
+            times[i] = System.nanoTime() - start;
+        }
+        Arrays.sort(times);
+        return times[REPEAT / 2];
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.atomic.AtomicLong;
+import org.opengis.referencing.crs.CRSAuthorityFactory;
+import org.opengis.referencing.crs.CoordinateReferenceSystem;
+import org.opengis.referencing.crs.SingleCRS;
+import org.opengis.util.FactoryException;
+import org.osgeo.proj.Proj;
+
+
+/**
+ * Benchmarks the lookup of existing wrappers for PROJ objects by many threads in parallel.
+ * Each thread asks repeatedly for the components (coordinate system, datum, axes) of a set of CRS.
+ * Those components are already wrapped after the first iteration, so the measurement is dominated
+ * by the search for existing wrappers. The throughput should increase with the number of threads,
+ * up to the number of processors.
+ */
+public class WrapperLookup {
+    /**
+     * Number of times to repeat each measurement. The median is reported.
+     */
+    private static final int REPEAT = 5;
+
+    /**
+     * Duration of each measurement in milliseconds.
+     */
+    private static final long DURATION = 1000;
+
+    /**
+     * Runs the benchmark.
+     *
+     * @param  args  maximal number of threads, or an empty array for the number of processors.
+     * @throws FactoryException if an error occurred while creating the CRS.
+     * @throws InterruptedException if the benchmark has been interrupted.
+     */
+    public static void main(String[] args) throws FactoryException, InterruptedException {
+        final int maxThreads = (args.length != 0) ? Integer.parseInt(args[0]) : Runtime.getRuntime().availableProcessors();
+        final CRSAuthorityFactory factory = Proj.getAuthorityFactory("EPSG");
+        final List<SingleCRS> crs = new ArrayList<>();
+        for (int code = 2000; code < 4000 && crs.size() < 500; code++) {
+            final CoordinateReferenceSystem c;
+            try {
+                c = factory.createCoordinateReferenceSystem(Integer.toString(code));
+            } catch (FactoryException e) {
+                continue;                               // Unused code, ignore.
+            }
+            if (c instanceof SingleCRS) {
+                crs.add((SingleCRS) c);
+            }
+        }
+        final SingleCRS[] objects = crs.toArray(new SingleCRS[crs.size()]);
+        System.out.printf("Number of CRS: %,d%n%n", objects.length);
+        System.out.println("Threads      Lookups/s   Speedup");
+        double reference = 0;
+        for (int n = 1; n <= maxThreads; n *= 2) {
+            lookups(objects, n);                        // Warmup.
+            final double[] rates = new double[REPEAT];
+            for (int i=0; i<REPEAT; i++) {
+                rates[i] = lookups(objects, n);
+            }
+            Arrays.sort(rates);
+            final double rate = rates[REPEAT / 2];
+            if (n == 1) reference = rate;
+            System.out.printf("%7d  %,13.0f  %7.2f×%n", n, rate, rate / reference);
+            if (n < maxThreads && n * 2 > maxThreads) {
+                n = maxThreads / 2;                     // For testing also the maximal number of threads.
+            }
+        }
+    }
+
+    /**
+     * Measures the number of lookups per second when the given number of threads run in parallel.
+     *
+     * @param  objects     the CRS for which to request the components.
+     * @param  numThreads  number of threads to run in parallel.
+     * @return number of lookups per second, all threads together.
+     * @throws InterruptedException if the benchmark has been interrupted.
+     */
+    private static double lookups(final SingleCRS[] objects, final int numThreads) throws InterruptedException {
+        final AtomicLong count = new AtomicLong();
+        final CountDownLatch start = new CountDownLatch(1);
+        final Thread[] threads = new Thread[numThreads];
+        final long[] end = new long[1];
+        for (int t=0; t<numThreads; t++) {
+            final int offset = t * objects.length / numThreads;
+            threads[t] = new Thread(() -> {
+                long n = 0;
+                try {
+                    start.await();
+                    int i = offset;
+                    do {
+                        final SingleCRS c = objects[i];
+                        final int dimension = c.getCoordinateSystem().getDimension();
+                        for (int j=0; j<dimension; j++) {
+                            c.getCoordinateSystem().getAxis(j);
+                        }
+                        c.getDatum();
+                        n += 2 + 2*dimension;
+                        if (++i == objects.length) i = 0;
+                    } while (System.nanoTime() < end[0]);
+                } catch (InterruptedException e) {
+                    return;
+                }
+                count.addAndGet(n);
+            });
+            threads[t].start();
+        }
+        final long startTime = System.nanoTime();
+        end[0] = startTime + DURATION * 1_000_000;
+        start.countDown();
+        for (final Thread thread : threads) {
+            thread.join();
+        }
+        return count.get() / ((System.nanoTime() - startTime) / 1E9);
+    }
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Standalone benchmark of the native code paths used by the PROJ-JNI bindings, without the JVM.
+ * This program exercises the same PROJ functions than `bindings.cpp`: creation of the database
+ * context, authority lookups, search of coordinate operations, export to PROJ string followed by
+ * `proj_create(…)`, and `proj_trans_generic(…)` with the strides and batch sizes used by the bindings.
+ * It is intended for profiling with tools such as `perf` or for builds with sanitizers.
+ *
+ * Results are written on the standard output as one JSON object per line, with the benchmark name,
+ * its parameters, the number of repetitions and the fastest time in nanoseconds per item.
+ * See the "benchmark/README.md" file in the project root directory for usage.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <proj.h>
+#include <proj/crs.hpp>
+#include <proj/io.hpp>
+#include <proj/coordinateoperation.hpp>
+
+using osgeo::proj::crs::CRSNNPtr;
+using osgeo::proj::io::AuthorityFactory;
+using osgeo::proj::io::AuthorityFactoryNNPtr;
+using osgeo::proj::io::DatabaseContext;
+using osgeo::proj::io::DatabaseContextNNPtr;
+using osgeo::proj::io::PROJStringFormatter;
+using osgeo::proj::io::PROJStringFormatterNNPtr;
+using osgeo::proj::operation::CoordinateOperationContext;
+using osgeo::proj::operation::CoordinateOperationContextNNPtr;
+using osgeo::proj::operation::CoordinateOperationFactory;
+using osgeo::proj::operation::CoordinateOperationNNPtr;
+
+
+/**
+ * Options specified on the command line.
+ */
+struct Options {
+    std::string authority = "EPSG";
+    std::string source    = "4326";
+    std::string target    = "3395";
+    double      bbox[4]   = {-80, -180, 80, 180};     // Minimal and maximal values in source CRS axis order.
+    int         repeat    = 5;
+    std::vector<std::string> codes = {"4326", "4979", "3395", "3857", "32631", "2154", "4267", "4269", "27700", "5714"};
+};
+
+
+/**
+ * Executes the given function `repeat` times and returns the fastest execution time in nanoseconds.
+ * A first execution is done before the measurements for warming up caches.
+ *
+ * @param  repeat    Number of measurements.
+ * @param  function  The function to measure.
+ * @return The fastest execution time in nanoseconds.
+ */
+template <class F> double measure(const int repeat, F function) {
+    function();
+    double best = std::numeric_limits<double>::infinity();
+    for (int i=0; i<repeat; i++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+
+/**
+ * Writes the result of a benchmark as a JSON object on a single line.
+ *
+ * @param  name        Name of the benchmark.
+ * @param  parameters  Additional JSON members (without braces), or empty if none.
+ * @param  options     The command-line options, for the number of repetitions.
+ * @param  nanos       The fastest execution time in nanoseconds.
+ * @param  items       Number of items (points, lookups, …) processed in one execution.
+ */
+void report(const char *name, const std::string &parameters, const Options &options, const double nanos, const size_t items) {
+    std::printf("{\"benchmark\":\"%s\",%s%s\"repeat\":%d,\"items\":%zu,\"ns\":%.1f,\"ns_per_item\":%.3f}\n",
+            name, parameters.c_str(), parameters.empty() ? "" : ",",
+            options.repeat, items, nanos, nanos / std::max<size_t>(items, 1));
+    std::fflush(stdout);
+}
+
+
+/**
+ * Measures the creation of a database context with a new PJ_CONTEXT,
+ * as done by `get_database_context(…)` for each new Java `Context`.
+ */
+void bench_database_context(const Options &options) {
+    const double nanos = measure(options.repeat, []() {
+        PJ_CONTEXT *ctx = proj_context_create();
+        {
+            DatabaseContextNNPtr db = DatabaseContext::create(std::string(), std::vector<std::string>(), ctx);
+        }
+        proj_context_destroy(ctx);
+    });
+    report("database_context", "", options, nanos, 1);
+}
+
+
+/**
+ * Measures the creation of CRS from authority codes, as done by `AuthorityFactory.createGeodeticObject(…)`.
+ * The "cold" case uses a new authority factory for each execution, while the "warm" case reuses the same
+ * factory, which benefits from the PROJ cache of objects already created.
+ */
+void bench_authority_lookup(const DatabaseContextNNPtr &db, const Options &options) {
+    const std::vector<std::string> &codes = options.codes;
+    double nanos = measure(options.repeat, [&]() {
+        AuthorityFactoryNNPtr factory = AuthorityFactory::create(db, options.authority);
+        for (const std::string &code : codes) {
+            factory->createCoordinateReferenceSystem(code);
+        }
+    });
+    report("authority_lookup", "\"cache\":\"cold\"", options, nanos, codes.size());
+
+    AuthorityFactoryNNPtr factory = AuthorityFactory::create(db, options.authority);
+    nanos = measure(options.repeat, [&]() {
+        for (const std::string &code : codes) {
+            factory->createCoordinateReferenceSystem(code);
+        }
+    });
+    report("authority_lookup", "\"cache\":\"warm\"", options, nanos, codes.size());
+}
+
+
+/**
+ * Measures the search of coordinate operations, as done by `AuthorityFactory.createOperation(…)`.
+ *
+ * @return The operations found between the source and target CRS.
+ */
+std::vector<CoordinateOperationNNPtr> bench_create_operations(const DatabaseContextNNPtr &db, const Options &options) {
+    AuthorityFactoryNNPtr factory = AuthorityFactory::create(db, options.authority);
+    CRSNNPtr source = factory->createCoordinateReferenceSystem(options.source);
+    CRSNNPtr target = factory->createCoordinateReferenceSystem(options.target);
+    std::vector<CoordinateOperationNNPtr> operations;
+    const double nanos = measure(options.repeat, [&]() {
+        CoordinateOperationContextNNPtr context = CoordinateOperationContext::create(factory.as_nullable(), nullptr, 0);
+        operations = CoordinateOperationFactory::create()->createOperations(source, target, context);
+    });
+    report("create_operations", "\"candidates\":" + std::to_string(operations.size()), options, nanos, 1);
+    return operations;
+}
+
+
+/**
+ * Measures the export to PROJ string followed by `proj_create(…)`, as done by `Context.createPJ(…)`.
+ *
+ * @return The PROJ string of the operation.
+ */
+std::string bench_create_pj(PJ_CONTEXT *ctx, const DatabaseContextNNPtr &db,
+                            const CoordinateOperationNNPtr &operation, const Options &options)
+{
+    std::string definition;
+    const double nanos = measure(options.repeat, [&]() {
+        PROJStringFormatterNNPtr formatter = PROJStringFormatter::create(
+                PROJStringFormatter::Convention::PROJ_5, db.as_nullable());
+        definition = operation->exportToPROJString(formatter.get());
+        proj_destroy(proj_create(ctx, definition.c_str()));
+    });
+    report("create_pj", "", options, nanos, 1);
+    return definition;
+}
+
+
+/**
+ * Measures `proj_trans_generic(…)` for different batch sizes and memory layouts. The "interleaved" layouts
+ * store (x,y,…) tuples of 2, 3 or 4 values as in `Transform.transform(…)`. The "planar" layout stores each
+ * dimension in a separate array. Each measurement transforms a fresh copy of the random source points;
+ * the time of that copy is included but is small compared to the coordinate operation.
+ */
+void bench_trans_generic(PJ_CONTEXT *ctx, const std::string &definition, const Options &options) {
+    PJ *pj = proj_create(ctx, definition.c_str());
+    if (!pj) {
+        std::fprintf(stderr, "Can not create PJ: %s\n", proj_errno_string(proj_context_errno(ctx)));
+        return;
+    }
+    const size_t maxPoints = 65536;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> xs(options.bbox[0], options.bbox[2]);
+    std::uniform_real_distribution<double> ys(options.bbox[1], options.bbox[3]);
+    std::vector<double> x(maxPoints), y(maxPoints);
+    for (size_t i=0; i<maxPoints; i++) {
+        x[i] = xs(random);
+        y[i] = ys(random);
+    }
+    std::vector<double> source, buffer;
+    for (const size_t numPts : {1, 16, 256, 4096, 65536}) {
+        for (const int dimension : {2, 3, 4, 0}) {              // 0 stands for planar layout.
+            const size_t tuple = (dimension != 0) ? dimension : 1;
+            source.assign(numPts * (dimension != 0 ? tuple : 2), 0.0);
+            for (size_t i=0; i<numPts; i++) {
+                if (dimension != 0) {
+                    source[i*tuple    ] = x[i];
+                    source[i*tuple + 1] = y[i];
+                } else {
+                    source[i         ] = x[i];
+                    source[i + numPts] = y[i];
+                }
+            }
+            /*
+             * Small batches are repeated for getting measurable times.
+             */
+            const size_t loops = std::max<size_t>(1, 65536 / numPts);
+            const size_t stride = sizeof(double) * tuple;
+            const double nanos = measure(options.repeat, [&]() {
+                for (size_t loop=0; loop<loops; loop++) {
+                    buffer = source;
+                    double *data = buffer.data();
+                    double *py = (dimension != 0) ? data+1 : data + numPts;
+                    proj_trans_generic(pj, PJ_FWD,
+                            data,                                stride, numPts,
+                            py,                                  stride, numPts,
+                            (dimension >= 3) ? data+2 : nullptr, stride, numPts,
+                            (dimension >= 4) ? data+3 : nullptr, stride, numPts);
+                }
+            });
+            proj_errno_reset(pj);
+            const std::string parameters = "\"points\":" + std::to_string(numPts)
+                    + ",\"layout\":\"" + (dimension != 0 ? "interleaved" : "planar")
+                    + "\",\"stride\":" + std::to_string(stride);
+            report("trans_generic", parameters, options, nanos, numPts * loops);
+        }
+    }
+    proj_destroy(pj);
+}
+
+
+/**
+ * Parses the command-line arguments.
+ *
+ * @return Whether the arguments are valid.
+ */
+bool parse(int argc, char **argv, Options &options) {
+    for (int i=1; i<argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i+1 < argc) ? argv[i+1] : nullptr;
+        if (!value) return false;
+        if      (!std::strcmp(arg, "--authority")) options.authority = value;
+        else if (!std::strcmp(arg, "--source"))    options.source    = value;
+        else if (!std::strcmp(arg, "--target"))    options.target    = value;
+        else if (!std::strcmp(arg, "--repeat"))    options.repeat    = std::max(1, std::atoi(value));
+        else if (!std::strcmp(arg, "--bbox")) {
+            if (std::sscanf(value, "%lf,%lf,%lf,%lf", &options.bbox[0], &options.bbox[1],
+                                                      &options.bbox[2], &options.bbox[3]) != 4) return false;
+        }
+        else return false;
+        i++;
+    }
+    return true;
+}
+
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--authority EPSG] [--source 4326] [--target 3395] "
+                             "[--bbox xmin,ymin,xmax,ymax] [--repeat 5]\n", argv[0]);
+        return 2;
+    }
+    PJ_CONTEXT *ctx = proj_context_create();
+    int status = 0;
+    try {
+        bench_database_context(options);
+        DatabaseContextNNPtr db = DatabaseContext::create(std::string(), std::vector<std::string>(), ctx);
+        bench_authority_lookup(db, options);
+        std::vector<CoordinateOperationNNPtr> operations = bench_create_operations(db, options);
+        if (operations.empty()) {
+            std::fprintf(stderr, "No operation found from %s to %s.\n", options.source.c_str(), options.target.c_str());
+            status = 1;
+        } else {
+            const std::string definition = bench_create_pj(ctx, db, operations[0], options);
+            bench_trans_generic(ctx, definition, options);
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        status = 1;
+    }
+    proj_context_destroy(ctx);
+    return status;
+}
@@ -27,6 +27,17 @@
 #include <string>
 #include <cmath>
 #include <atomic>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
 #include <proj.h>
 #include <proj/crs.hpp>
 #include "org_osgeo_proj_Type.h"
@@ -52,6 +63,44 @@
 #define strcasecmp _stricmp
 #endif
 
+/*
+ * Statically defined tracing probes (USDT) for tools such as `bpftrace` or `perf`. A probe compiles to
+ * a single `nop` instruction plus a note in the ELF file, so it has no measurable cost when not traced.
+ * The probes are enabled by CMake when the <sys/sdt.h> header is found, otherwise they expand to nothing.
+ * Probe arguments are evaluated even when no tool is attached, so they shall be cheap (no allocation).
+ * The list of probes is given in README.md.
+ */
+#ifdef JPJ_HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define JPJ_PROBE1(name, a)             DTRACE_PROBE1(proj_jni, name, a)
+#define JPJ_PROBE2(name, a, b)          DTRACE_PROBE2(proj_jni, name, a, b)
+#define JPJ_PROBE3(name, a, b, c)       DTRACE_PROBE3(proj_jni, name, a, b, c)
+#else
+#define JPJ_PROBE1(name, a)             ((void) 0)
+#define JPJ_PROBE2(name, a, b)          ((void) 0)
+#define JPJ_PROBE3(name, a, b, c)       ((void) 0)
+#endif
+
+/*
+ * The glibc allocator statistics reported by `NativeResource.resourceCounts(…)`.
+ * The `mallinfo2()` function is available since glibc 2.33. On other platforms,
+ * the number of bytes in use by the allocator is reported as unknown.
+ */
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define JPJ_HAVE_MALLINFO2
+#endif
+
+/*
+ * Per-thread locales, for parsing and formatting numbers in text coordinates independently of the
+ * LC_NUMERIC category of the process. POSIX 2008 provides `uselocale`, which is declared in the
+ * <xlocale.h> header on macOS. Windows provides per-thread `setlocale` instead.
+ */
+#include <clocale>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
 using osgeo::proj::common::Angle;
 using osgeo::proj::common::DateTime;
 using osgeo::proj::common::IdentifiedObject;
@@ -76,6 +125,7 @@ using osgeo::proj::crs::EngineeringCRS;
 using osgeo::proj::crs::GeodeticCRS;
 using osgeo::proj::crs::GeodeticCRSNNPtr;
 using osgeo::proj::crs::GeographicCRS;
+using osgeo::proj::crs::GeographicCRSPtr;
 using osgeo::proj::crs::ProjectedCRS;
 using osgeo::proj::crs::SingleCRS;
 using osgeo::proj::crs::SingleCRSPtr;
@@ -203,7 +253,9 @@ using osgeo::proj::util::PropertyMap;
  */
 jfieldID  java_field_for_pointer;
 jfieldID  java_field_debug_level;
-jmethodID java_method_findWrapper;
+jfieldID  java_field_recently_used;
+jfieldID  java_field_inverse;
+jmethodID java_method_close;
 jmethodID java_method_getDefinedUnit;
 jmethodID java_method_wrapGeodeticObject;
 jmethodID java_method_getLogger;
@@ -229,9 +281,21 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_NativeResource_initialize(JNIEnv *env
          */
         java_method_wrapGeodeticObject = env->GetMethodID(caller, "wrapGeodeticObject", "(SJ)Lorg/osgeo/proj/IdentifiableObject;");
         if (java_method_wrapGeodeticObject) {
-            java_method_findWrapper = env->GetMethodID(caller, "findWrapper", "(J)Lorg/osgeo/proj/IdentifiableObject;");
-            if (java_method_findWrapper) {
-                java_method_getDefinedUnit = env->GetStaticMethodID(caller, "getPredefinedUnit", "(ID)Ljavax/measure/Unit;");
+            java_method_getDefinedUnit = env->GetStaticMethodID(caller, "getPredefinedUnit", "(ID)Ljavax/measure/Unit;");
+            if (java_method_getDefinedUnit) {
+                jclass wrapper = env->FindClass("org/osgeo/proj/IdentifiableObject");
+                if (wrapper) {
+                    java_field_recently_used = env->GetFieldID(wrapper, "recentlyUsed", "Z");
+                    if (java_field_recently_used) {
+                        java_method_close = env->GetMethodID(wrapper, "close", "()V");
+                        if (java_method_close) {
+                            jclass tr = env->FindClass("org/osgeo/proj/Transform");
+                            if (tr) {
+                                java_field_inverse = env->GetFieldID(tr, "inverse", "Z");
+                            }
+                        }
+                    }
+                }
             }
         }
     }
@@ -287,6 +351,46 @@ JNIEXPORT jstring JNICALL Java_org_osgeo_proj_NativeResource_version(JNIEnv *env
 }
 
 
+/**
+ * Numbers of native resources currently allocated by the bindings, indexed by the `NativeResource`
+ * constants. Those counters are used for detecting native memory growth in long-running applications.
+ * The last counter (bytes in use by the C allocator) is not stored here but computed when requested.
+ */
+std::atomic<jlong> resource_counts[org_osgeo_proj_NativeResource_MALLOC_IN_USE];
+
+
+/**
+ * Adds the given value to the counter of native resources at the given index.
+ *
+ * @param  index  One of the `org_osgeo_proj_NativeResource_*` constants.
+ * @param  delta  +1 when a resource is allocated, or -1 when it is released.
+ */
+inline void count_resource(const int index, const jlong delta) {
+    resource_counts[index].fetch_add(delta, std::memory_order_relaxed);
+}
+
+
+/**
+ * Gets the numbers of native resources currently allocated by the bindings.
+ *
+ * @param  env     The JNI environment.
+ * @param  caller  The class from which this method has been invoked.
+ * @param  counts  Where to store the counters, indexed by the `NativeResource` constants.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_NativeResource_resourceCounts(JNIEnv *env, jclass caller, jlongArray counts) {
+    jlong values[org_osgeo_proj_NativeResource_NUM_COUNTERS];
+    for (int i=0; i<org_osgeo_proj_NativeResource_MALLOC_IN_USE; i++) {
+        values[i] = resource_counts[i].load(std::memory_order_relaxed);
+    }
+#ifdef JPJ_HAVE_MALLINFO2
+    values[org_osgeo_proj_NativeResource_MALLOC_IN_USE] = static_cast<jlong>(mallinfo2().uordblks);
+#else
+    values[org_osgeo_proj_NativeResource_MALLOC_IN_USE] = -1;
+#endif
+    env->SetLongArrayRegion(counts, 0, org_osgeo_proj_NativeResource_NUM_COUNTERS, values);
+}
+
+
 
 
 // </editor-fold>
@@ -399,6 +503,7 @@ template <class T> inline jlong wrap_shared_ptr(std::shared_ptr<T> &object) {
     std::shared_ptr<T> *wrapper = reinterpret_cast<std::shared_ptr<T>*>(calloc(1, sizeof(std::shared_ptr<T>)));
     if (wrapper) {
         *wrapper = object;          // This assignation also increases object.use_count() by one.
+        count_resource(org_osgeo_proj_NativeResource_SHARED_POINTERS, +1);
     }
     static_assert(sizeof(wrapper) <= sizeof(jlong), "Can not store pointer in a jlong.");
     return reinterpret_cast<jlong>(wrapper);
@@ -431,6 +536,7 @@ template <class T> inline void release_shared_ptr(jlong ptr) {
         std::shared_ptr<T> *wrapper = reinterpret_cast<std::shared_ptr<T>*>(ptr);
         *wrapper = nullptr;     // This assignation decreases object.use_count().
         free(wrapper);
+        count_resource(org_osgeo_proj_NativeResource_SHARED_POINTERS, -1);
     }
 }
 
@@ -563,11 +669,173 @@ void rethrow_as_java_exception(JNIEnv *env, const char *type, const std::excepti
 }
 
 
+/**
+ * Number of independent parts in the map of Java wrappers. Each part has its own lock,
+ * so threads fetching different PROJ objects rarely wait for each other.
+ * Shall be a power of 2.
+ */
+const size_t WRAPPER_MAP_STRIPES = 64;
+
+/**
+ * An entry in the map of Java wrappers. The `block` field is the address of the memory block
+ * created by `wrap_shared_ptr(…)` for the Java wrapper. That address is unique to the wrapper
+ * and is used for verifying, when a wrapper is released, that the entry is still for that wrapper.
+ */
+struct WrapperEntry {
+    jweak wrapper;
+    jlong block;
+};
+
+/**
+ * A part of the map from PROJ objects to the Java objects wrapping them.
+ * The map shall be accessed only while holding the lock. This is required
+ * also for resolving the weak references, since another thread may delete
+ * them as soon as the entry has been removed.
+ */
+struct WrapperStripe {
+    std::mutex lock;
+    std::unordered_map<const BaseObject*, WrapperEntry> wrappers;
+};
+
+/**
+ * The map of Java wrappers, split in parts for reducing lock contention. This map ensures that
+ * the same PROJ object is wrapped by the same Java object, without calls to Java methods when
+ * the wrapper already exists. The references are weak for allowing the garbage collector to
+ * collect the wrappers; the retention policy is managed by the SharedObjects Java class.
+ */
+WrapperStripe wrapper_map[WRAPPER_MAP_STRIPES];
+
+
+/**
+ * Returns the part of the map of Java wrappers where to look for the given PROJ object.
+ * The lowest bits of the address are discarded because they are zero for aligned objects.
+ *
+ * @param  rp  Raw pointer to the PROJ object.
+ * @return The part of the map of Java wrappers for the given object.
+ */
+inline WrapperStripe& wrapper_stripe(const BaseObject *rp) {
+    uintptr_t h = reinterpret_cast<uintptr_t>(rp) >> 4;
+    h ^= h >> 7;
+    return wrapper_map[h & (WRAPPER_MAP_STRIPES - 1)];
+}
+
+
+/**
+ * Returns the Java wrapper for the given PROJ object if it already exists and has not been garbage
+ * collected or released. If found, the wrapper is marked as recently used for the eviction policy of the cache.
+ * This function does not invoke any Java method.
+ *
+ * @param  env  The JNI environment.
+ * @param  rp   Raw pointer to the PROJ object.
+ * @return Local reference to the existing wrapper, or null if none.
+ */
+jobject find_wrapper(JNIEnv *env, const BaseObject *rp) {
+    WrapperStripe &stripe = wrapper_stripe(rp);
+    jobject result = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        auto it = stripe.wrappers.find(rp);
+        if (it != stripe.wrappers.end()) {
+            result = env->NewLocalRef(it->second.wrapper);     // Null if the wrapper has been collected.
+        }
+    }
+    if (result) {
+        /*
+         * A wrapper released concurrently by another thread may still be in the map
+         * for a short time. Its `ptr` field is zero, so it can not be used anymore.
+         */
+        if (env->GetLongField(result, java_field_for_pointer) == 0) {
+            env->DeleteLocalRef(result);
+            return nullptr;
+        }
+        env->SetBooleanField(result, java_field_recently_used, JNI_TRUE);
+    }
+    return result;
+}
+
+
+/**
+ * Registers a newly created Java wrapper for the given PROJ object. If another thread registered
+ * a wrapper for the same object concurrently, then the given wrapper is closed and the existing
+ * wrapper is returned instead. This is the only case where this function invokes a Java method.
+ *
+ * @param  env      The JNI environment.
+ * @param  rp       Raw pointer to the PROJ object.
+ * @param  wrapper  The Java wrapper which has just been created for the PROJ object.
+ * @param  block    Value of the `ptr` field of the given wrapper, as returned by wrap_shared_ptr(…).
+ * @return The wrapper to use, which is usually `wrapper`. May be null if a Java exception occurred.
+ */
+jobject register_wrapper(JNIEnv *env, const BaseObject *rp, jobject wrapper, jlong block) {
+    jweak ref = env->NewWeakGlobalRef(wrapper);
+    if (!ref) {
+        return wrapper;         // Out of memory. The wrapper is still valid, but will not be shared.
+    }
+    WrapperStripe &stripe = wrapper_stripe(rp);
+    jobject existing = nullptr;
+    jweak   obsolete = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        auto it = stripe.wrappers.find(rp);
+        if (it == stripe.wrappers.end()) {
+            stripe.wrappers.emplace(rp, WrapperEntry {ref, block});
+        } else {
+            existing = env->NewLocalRef(it->second.wrapper);
+            if (!existing) {
+                obsolete = it->second.wrapper;      // Wrapper collected but not yet released.
+                it->second = WrapperEntry {ref, block};
+            }
+        }
+    }
+    if (obsolete) {
+        env->DeleteWeakGlobalRef(obsolete);
+    }
+    if (!existing) {
+        return wrapper;         // Normal case.
+    }
+    env->DeleteWeakGlobalRef(ref);
+    env->CallVoidMethod(wrapper, java_method_close);
+    env->DeleteLocalRef(wrapper);
+    if (env->ExceptionCheck()) {
+        env->DeleteLocalRef(existing);
+        return nullptr;
+    }
+    return existing;
+}
+
+
+/**
+ * Removes the entry for the Java wrapper which is about to release the given memory block.
+ * This function does nothing if the entry has already been replaced by another wrapper,
+ * for example because the garbage collector collected the Java wrapper of `block` and
+ * a new wrapper has been created for the same PROJ object before this function call.
+ *
+ * @param  env    The JNI environment.
+ * @param  block  Address returned by wrap_shared_ptr(…). Shall not be zero.
+ */
+void unregister_wrapper(JNIEnv *env, jlong block) {
+    const BaseObject *rp = reinterpret_cast<BaseObjectPtr*>(block)->get();
+    WrapperStripe &stripe = wrapper_stripe(rp);
+    jweak ref = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        auto it = stripe.wrappers.find(rp);
+        if (it != stripe.wrappers.end() && it->second.block == block) {
+            ref = it->second.wrapper;
+            stripe.wrappers.erase(it);
+        }
+    }
+    if (ref) {
+        env->DeleteWeakGlobalRef(ref);
+    }
+}
+
+
 /**
  * Wraps the given PROJ object into the most specific Java object provided by the PROJ-JNI bindings.
- * This function tries to find a more specialized type for the given object, then calls the Java method
- * `wrapGeodeticObject(…)` with that type in argument. If the type is unknown, then this function returns
- * null and an exception is thrown in Java code.
+ * If a wrapper already exists for the given object, it is returned without call to Java methods.
+ * Otherwise this function tries to find a more specialized type for the given object, then calls
+ * the Java method `wrapGeodeticObject(…)` with that type in argument. If the type is unknown,
+ * then this function returns null and an exception is thrown in Java code.
  *
  * @param  env     The JNI environment.
  * @param  caller  The Java object which is creating another object.
@@ -577,10 +845,7 @@ void rethrow_as_java_exception(JNIEnv *env, const char *type, const std::excepti
  */
 jobject specific_subclass(JNIEnv *env, jobject caller, BaseObjectPtr &object, jshort type) {
     BaseObject *rp = object.get();
-    jobject result = env->CallObjectMethod(caller, java_method_findWrapper, reinterpret_cast<jlong>(rp));
-    if (env->ExceptionCheck()) {
-        return nullptr;
-    }
+    jobject result = find_wrapper(env, rp);
     if (!result) {
 again:  switch (type) {
             case org_osgeo_proj_Type_ANY: {
@@ -642,14 +907,18 @@ again:  switch (type) {
          * object of that type. If a Java exception is thrown, we release the PROJ resource and return null.
          * The exception will be propagated in Java code.
          */
+        JPJ_PROBE2(wrapper__entry, rp, type);
         jlong ptr = wrap_shared_ptr<BaseObject>(object);
         if (ptr) {
             result = env->CallObjectMethod(caller, java_method_wrapGeodeticObject, type, ptr);
             if (env->ExceptionCheck() | !result) {              // ExceptionCheck() must be always invoked.
                 release_shared_ptr<BaseObject>(ptr);
                 result = nullptr;
+            } else {
+                result = register_wrapper(env, rp, result, ptr);
             }
         }
+        JPJ_PROBE3(wrapper__exit, rp, type, result != nullptr);
     }
     return result;
 }
@@ -788,6 +1057,7 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_UnitOfMeasure_create
 JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_create(JNIEnv *env, jclass caller, jstring searchPaths, jchar pathSeparator) {
     static_assert(sizeof(PJ_CONTEXT*) <= sizeof(jlong), "Can not store PJ_CONTEXT* in a jlong.");
     PJ_CONTEXT *ctx = proj_context_create();
+    if (ctx) count_resource(org_osgeo_proj_NativeResource_CONTEXTS, +1);
     if (searchPaths != NULL) {
         const char *path = env->GetStringUTFChars(searchPaths, nullptr);
         if (path) {
@@ -839,7 +1109,10 @@ DatabaseContextPtr get_database_context(JNIEnv *env, jobject context) {
         db = unwrap_shared_ptr<DatabaseContext>(dbPtr);
     } else {
         log(env, "Creating PROJ database context.");
-        db = DatabaseContext::create(empty_string, std::vector<std::string>(), get_context(env, context)).as_nullable();
+        PJ_CONTEXT *ctx = get_context(env, context);
+        JPJ_PROBE1(database__entry, ctx);
+        db = DatabaseContext::create(empty_string, std::vector<std::string>(), ctx).as_nullable();
+        JPJ_PROBE2(database__exit, ctx, db.get());
         dbPtr = wrap_shared_ptr<DatabaseContext>(db);
         env->SetLongField(context, fid, dbPtr);
         // dbPtr may be 0 if out of memory, but the only consequence is that DatabaseContext is not cached.
@@ -863,6 +1136,7 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_Context_destroyPJ(JNIEnv *env, jobjec
     }
     jlong ctxPtr = get_and_clear_ptr(env, context);
     proj_context_destroy(reinterpret_cast<PJ_CONTEXT*>(ctxPtr));    // Does nothing if ctxPtr is null.
+    if (ctxPtr) count_resource(org_osgeo_proj_NativeResource_CONTEXTS, -1);
 }
 
 
@@ -1532,6 +1806,9 @@ JNIEXPORT jboolean JNICALL Java_org_osgeo_proj_SharedPointer_getBooleanProperty
                 invalid_parameter_type(env, opv, "This parameter is not a boolean.");
                 break;
             }
+            case org_osgeo_proj_Property_IS_DEPRECATED: {
+                return get_identified_object(env, object)->isDeprecated();
+            }
         }
     } catch (const std::exception &e) {
         rethrow_as_java_exception(env, JPJ_RUNTIME_EXCEPTION, e);
@@ -1540,6 +1817,143 @@ JNIEXPORT jboolean JNICALL Java_org_osgeo_proj_SharedPointer_getBooleanProperty
 }
 
 
+/**
+ * Returns a property value as a string for all objects in the given array.
+ * This function delegates to getStringProperty for each non-null element,
+ * but the caller crosses the JNI boundary only once for the whole column.
+ *
+ * @param  env       The JNI environment.
+ * @param  caller    The class from which this function has been invoked.
+ * @param  objects   The Java objects wrapping the PROJ objects for which to get property values.
+ * @param  property  One of NAME_STRING, etc. values.
+ * @return Values of the specified property, or null if an exception has been thrown.
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_osgeo_proj_SharedPointer_getStringColumn
+    (JNIEnv *env, jclass caller, jobjectArray objects, jshort property)
+{
+    const jsize count = env->GetArrayLength(objects);
+    jclass c = env->FindClass("java/lang/String");
+    if (!c) return nullptr;                             // NoClassDefFoundError will be thrown in Java code.
+    jobjectArray column = env->NewObjectArray(count, c, nullptr);
+    if (!column) return nullptr;                        // OutOfMemoryError will be thrown in Java code.
+    for (jsize i=0; i<count; i++) {
+        jobject object = env->GetObjectArrayElement(objects, i);
+        if (object) {
+            jstring value = Java_org_osgeo_proj_SharedPointer_getStringProperty(env, object, property);
+            env->DeleteLocalRef(object);
+            if (env->ExceptionCheck()) return nullptr;
+            if (value) {
+                env->SetObjectArrayElement(column, i, value);
+                env->DeleteLocalRef(value);
+            }
+        }
+    }
+    return column;
+}
+
+
+/**
+ * Returns a property value as a floating point number for all objects in the given array.
+ * This function delegates to getNumericProperty for each non-null element,
+ * but the caller crosses the JNI boundary only once for the whole column.
+ *
+ * @param  env       The JNI environment.
+ * @param  caller    The class from which this function has been invoked.
+ * @param  objects   The Java objects wrapping the PROJ objects for which to get property values.
+ * @param  property  One of MINIMUM, MAXIMUM, etc. values.
+ * @return Values of the specified property, or null if an exception has been thrown.
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_osgeo_proj_SharedPointer_getNumericColumn
+    (JNIEnv *env, jclass caller, jobjectArray objects, jshort property)
+{
+    const jsize count = env->GetArrayLength(objects);
+    std::vector<jdouble> values(count, NAN);
+    for (jsize i=0; i<count; i++) {
+        jobject object = env->GetObjectArrayElement(objects, i);
+        if (object) {
+            values[i] = Java_org_osgeo_proj_SharedPointer_getNumericProperty(env, object, property);
+            env->DeleteLocalRef(object);
+            if (env->ExceptionCheck()) return nullptr;
+        }
+    }
+    jdoubleArray column = env->NewDoubleArray(count);
+    if (column) {
+        env->SetDoubleArrayRegion(column, 0, count, values.data());
+    }
+    return column;
+}
+
+
+/**
+ * Returns a property value as an array of floating-point values for all objects in the given array.
+ * The arrays are concatenated in a single column where each object uses exactly `length` elements.
+ * Undefined properties and missing values are represented by NaN.
+ *
+ * @param  env       The JNI environment.
+ * @param  caller    The class from which this function has been invoked.
+ * @param  objects   The Java objects wrapping the PROJ objects for which to get property values.
+ * @param  property  One of DOMAIN_OF_VALIDITY, etc. values.
+ * @param  length    Number of values per object.
+ * @return Values of the specified property, or null if an exception has been thrown.
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_osgeo_proj_SharedPointer_getArrayColumn
+    (JNIEnv *env, jclass caller, jobjectArray objects, jshort property, jint length)
+{
+    const jsize count = env->GetArrayLength(objects);
+    std::vector<jdouble> values(static_cast<size_t>(count) * length, NAN);
+    for (jsize i=0; i<count; i++) {
+        jobject object = env->GetObjectArrayElement(objects, i);
+        if (object) {
+            jdoubleArray array = Java_org_osgeo_proj_SharedPointer_getArrayProperty(env, object, property);
+            env->DeleteLocalRef(object);
+            if (env->ExceptionCheck()) return nullptr;
+            if (array) {
+                jsize n = std::min(env->GetArrayLength(array), length);
+                env->GetDoubleArrayRegion(array, 0, n, &values[static_cast<size_t>(i) * length]);
+                env->DeleteLocalRef(array);
+            }
+        }
+    }
+    jdoubleArray column = env->NewDoubleArray(static_cast<jsize>(values.size()));
+    if (column) {
+        env->SetDoubleArrayRegion(column, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return column;
+}
+
+
+/**
+ * Returns a property value as a boolean value for all objects in the given array.
+ * This function delegates to getBooleanProperty for each non-null element,
+ * but the caller crosses the JNI boundary only once for the whole column.
+ *
+ * @param  env       The JNI environment.
+ * @param  caller    The class from which this function has been invoked.
+ * @param  objects   The Java objects wrapping the PROJ objects for which to get property values.
+ * @param  property  One of IS_SPHERE, etc. values.
+ * @return Values of the specified property, or null if an exception has been thrown.
+ */
+JNIEXPORT jbooleanArray JNICALL Java_org_osgeo_proj_SharedPointer_getBooleanColumn
+    (JNIEnv *env, jclass caller, jobjectArray objects, jshort property)
+{
+    const jsize count = env->GetArrayLength(objects);
+    std::vector<jboolean> values(count, JNI_FALSE);
+    for (jsize i=0; i<count; i++) {
+        jobject object = env->GetObjectArrayElement(objects, i);
+        if (object) {
+            values[i] = Java_org_osgeo_proj_SharedPointer_getBooleanProperty(env, object, property);
+            env->DeleteLocalRef(object);
+            if (env->ExceptionCheck()) return nullptr;
+        }
+    }
+    jbooleanArray column = env->NewBooleanArray(count);
+    if (column) {
+        env->SetBooleanArrayRegion(column, 0, count, values.data());
+    }
+    return column;
+}
+
+
 /**
  * Compares this object with the given object for equality.
  *
@@ -1600,7 +2014,15 @@ JNIEXPORT jlong JNICALL Java_org_osgeo_proj_SharedPointer_rawPointer(JNIEnv *env
  * @param  object  The Java object wrapping the shared object to release.
  */
 JNIEXPORT void JNICALL Java_org_osgeo_proj_SharedPointer_release(JNIEnv *env, jobject object) {
-    jlong ptr = get_and_clear_ptr(env, object);
+    /*
+     * Unregister the wrapper before to clear its `ptr` field,
+     * so that `find_wrapper(…)` does not return a released wrapper.
+     */
+    jlong ptr = env->GetLongField(object, java_field_for_pointer);
+    if (ptr) {
+        unregister_wrapper(env, ptr);
+        ptr = get_and_clear_ptr(env, object);
+    }
     release_shared_ptr<BaseObject>(ptr);
 }
 
@@ -2291,6 +2713,7 @@ JNIEXPORT jlong JNICALL Java_org_osgeo_proj_AuthorityFactory_newInstance
         try {
             const std::string authority_str = authority_utf;
             DatabaseContextNNPtr db = NN_CHECK_THROW(get_database_context(env, context));
+            JPJ_PROBE1(factory__new, authority_utf);
             AuthorityFactoryPtr factory = AuthorityFactory::create(db, authority_str).as_nullable();
             result = wrap_shared_ptr<AuthorityFactory>(factory);
             /*
@@ -2391,6 +2814,7 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createGeodeticObj
         const std::string code_str = std::string(code_utf);                     // This constructor creates a copy.
         env->ReleaseStringUTFChars(code, code_utf);
         BaseObjectPtr rp = nullptr;
+        JPJ_PROBE2(factory__entry, type, code_str.c_str());
         try {
             AuthorityFactoryPtr pf = get_and_unwrap_ptr<AuthorityFactory>(env, factory);
             switch (type) {
@@ -2433,6 +2857,7 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createGeodeticObj
         } catch (const std::exception &e) {
             rethrow_as_java_exception(env, JPJ_FACTORY_EXCEPTION, e);
         }
+        JPJ_PROBE3(factory__exit, type, code_str.c_str(), rp.get());
         if (rp) try {
             return specific_subclass(env, factory, rp, type);
         } catch (const std::exception &e) {
@@ -2443,6 +2868,263 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createGeodeticObj
 }
 
 
+/**
+ * Number of sample points along each axis of the grid used for measuring the cost of coordinate operations.
+ * The total number of points is the square of this value. It should be large enough for hiding the cost of
+ * the `proj_trans_generic(…)` call itself, but small enough for keeping operation selection fast.
+ */
+#define COST_GRID_SIZE 16
+
+/**
+ * Number of times that the sample points are transformed when measuring the cost of an operation.
+ * The minimal time is retained, after a first pass which is not timed (it may load datum shift grids).
+ */
+#define COST_REPETITIONS 3
+
+/**
+ * Maximal number of entries in the cache of operation costs. If this limit is reached,
+ * the cache is cleared. A simple strategy is sufficient since this cache is only for
+ * avoiding to repeat the measurements when the same operations are requested often.
+ */
+#define COST_CACHE_CAPACITY 1000
+
+/**
+ * Factor by which the cost of a candidate operation must be lower than the cost of a previous candidate
+ * for being selected instead. Timings vary between runs, so candidates of similar costs are considered
+ * equivalent and the first one in PROJ preference order (usually the most accurate) is kept.
+ */
+#define COST_SIGNIFICANT_RATIO 0.8
+
+/**
+ * Cache of the cost (in nanoseconds per point) of coordinate operations, measured by `operation_cost(…)`.
+ * Keys are the PROJ strings of the operations followed by the bounding box of the sample points.
+ * Infinite values are for operations that failed on the sample points. All accesses shall be
+ * synchronized on `operation_costs_lock`.
+ */
+std::unordered_map<std::string, double> operation_costs;
+std::mutex operation_costs_lock;
+
+
+/**
+ * Gets the first geographic bounding box in the domains of validity of the given object.
+ *
+ * @param  object  the object for which to get the domain of validity.
+ * @param  bbox    where to store the west, east, south and north bounds (in degrees).
+ * @return whether a bounding box has been found.
+ */
+bool get_geographic_bbox(const ObjectUsage &object, double bbox[4]) {
+    for (const ObjectDomainNNPtr &domain : object.domains()) {
+        ExtentPtr extent = domain->domainOfValidity();
+        if (extent) {
+            for (const GeographicExtentNNPtr &ge : extent->geographicElements()) {
+                GeographicBoundingBoxPtr gb = std::dynamic_pointer_cast<GeographicBoundingBox>(ge.as_nullable());
+                if (gb) {
+                    bbox[0] = gb->westBoundLongitude();
+                    bbox[1] = gb->eastBoundLongitude();
+                    bbox[2] = gb->southBoundLatitude();
+                    bbox[3] = gb->northBoundLatitude();
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Computes a grid of sample points in the given source CRS. Points are first distributed regularly
+ * in the given geographic bounding box, then converted to the source CRS using the geographic CRS
+ * on which the source CRS is based. This is usually a map projection or an identity operation.
+ *
+ * @param  ctx     the PROJ context to use.
+ * @param  source  the CRS in which to express the sample points.
+ * @param  bbox    the west, east, south and north bounds (in degrees) of the area where to create points.
+ * @param  points  where to store the (x,y) tuples. Cleared if the points cannot be computed.
+ * @throw  std::exception if an error occurred in a PROJ function.
+ */
+void cost_sample_points(PJ_CONTEXT *ctx, const CRSNNPtr &source, const double bbox[4], std::vector<double> &points) {
+    points.clear();
+    GeographicCRSPtr geographic = source->extractGeographicCRS();
+    if (!geographic) {
+        return;
+    }
+    const std::vector<CoordinateSystemAxisNNPtr> &axes = geographic->coordinateSystem()->axisList();
+    if (axes.size() < 2) {
+        return;
+    }
+    const bool   latFirst = (&axes[0]->direction() == &AxisDirection::NORTH);
+    const double toLat    = (3.14159265358979323846 / 180) / axes[latFirst ? 0 : 1]->unit().conversionToSI();
+    const double toLon    = (3.14159265358979323846 / 180) / axes[latFirst ? 1 : 0]->unit().conversionToSI();
+    double west = bbox[0];
+    double east = bbox[1];
+    if (east < west) east += 360;       // Bounding box crossing the anti-meridian.
+    const double dx = (east     - west)    / COST_GRID_SIZE;
+    const double dy = (bbox[3]  - bbox[2]) / COST_GRID_SIZE;
+    for (int j=0; j<COST_GRID_SIZE; j++) {
+        const double lat = (bbox[2] + dy * (j + 0.5)) * toLat;
+        for (int i=0; i<COST_GRID_SIZE; i++) {
+            double lon = west + dx * (i + 0.5);
+            if (lon > 180) lon -= 360;
+            lon *= toLon;
+            points.push_back(latFirst ? lat : lon);
+            points.push_back(latFirst ? lon : lat);
+        }
+    }
+    /*
+     * Convert the geographic coordinates to the source CRS. If the source CRS is geographic,
+     * PROJ returns an identity operation. The operation context has no authority factory,
+     * which is sufficient for map projections and avoid searching datum shifts.
+     */
+    CoordinateOperationContextNNPtr context = CoordinateOperationContext::create(nullptr, nullptr, 0);
+    std::vector<CoordinateOperationNNPtr> operations = CoordinateOperationFactory::create()->createOperations(
+            NN_NO_CHECK(geographic), source, context);
+    if (!operations.empty()) {
+        PROJStringFormatterNNPtr formatter = PROJStringFormatter::create();
+        PJ *pj = proj_create(ctx, operations[0]->exportToPROJString(formatter.get()).c_str());
+        if (pj) {
+            const size_t n = points.size() / 2;
+            proj_trans_generic(pj, PJ_FWD,
+                    points.data(),   2*sizeof(double), n,
+                    points.data()+1, 2*sizeof(double), n,
+                    nullptr, 0, 0, nullptr, 0, 0);
+            const int err = proj_errno(pj);
+            proj_destroy(pj);
+            if (!err) return;
+        }
+    }
+    points.clear();
+}
+
+
+/**
+ * Measures the cost of the given operation, in nanoseconds per point. The operation is applied
+ * on the given sample points a few times and the fastest time is retained. Operations that fail
+ * on more than half of the sample points are considered unusable in the area of interest.
+ * Results are cached, so the measurement is done only once for each operation and area.
+ *
+ * @param  ctx        the PROJ context to use.
+ * @param  projDef    the PROJ string of the operation to measure.
+ * @param  areaKey    string representation of the area of the sample points, used as a cache key.
+ * @param  points     the sample points as (x,y) tuples in the source CRS.
+ * @param  measured   set to `true` if the cost has been measured by this call instead of read from the cache.
+ * @return the cost in nanoseconds per point, or infinity if the operation is unusable.
+ */
+double operation_cost(PJ_CONTEXT *ctx, const std::string &projDef, const std::string &areaKey,
+                      const std::vector<double> &points, bool &measured)
+{
+    const std::string key = projDef + '\n' + areaKey;
+    {
+        std::lock_guard<std::mutex> guard(operation_costs_lock);
+        auto it = operation_costs.find(key);
+        if (it != operation_costs.end()) {
+            return it->second;
+        }
+    }
+    measured = true;
+    double cost = std::numeric_limits<double>::infinity();
+    PJ *pj = proj_create(ctx, projDef.c_str());
+    if (pj) {
+        const size_t n = points.size() / 2;
+        const size_t stride = 2*sizeof(double);
+        std::vector<double> buffer(points);
+        proj_trans_generic(pj, PJ_FWD,
+                buffer.data(), stride, n, buffer.data()+1, stride, n,
+                nullptr, 0, 0, nullptr, 0, 0);
+        size_t failures = 0;
+        for (size_t i=0; i<n; i++) {
+            if (buffer[i*2] == HUGE_VAL) failures++;
+        }
+        if (failures <= n/2) {
+            for (int r=0; r<COST_REPETITIONS; r++) {
+                std::copy(points.begin(), points.end(), buffer.begin());
+                auto start = std::chrono::steady_clock::now();
+                proj_trans_generic(pj, PJ_FWD,
+                        buffer.data(), stride, n, buffer.data()+1, stride, n,
+                        nullptr, 0, 0, nullptr, 0, 0);
+                std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                cost = std::min(cost, elapsed.count() / n);
+            }
+        }
+        proj_errno_reset(pj);
+        proj_destroy(pj);
+    }
+    std::lock_guard<std::mutex> guard(operation_costs_lock);
+    if (operation_costs.size() >= COST_CACHE_CAPACITY) {
+        operation_costs.clear();
+    }
+    operation_costs[key] = cost;
+    return cost;
+}
+
+
+/**
+ * Selects the fastest operation among the given candidates. All candidates are assumed to meet
+ * the desired accuracy, as PROJ discards the other ones when a desired accuracy is specified.
+ * The cost of each candidate is measured on a grid of sample points in the area of interest,
+ * or in the domain of validity of the source CRS if no area of interest was specified.
+ * If the cost cannot be measured, the first operation is returned.
+ *
+ * Because the costs are wall-clock timings, the selection is not deterministic: it may differ between
+ * machines, between runs, or after the cost cache has been cleared. A candidate replaces a previous one
+ * only if it is significantly faster, which keeps the selection stable when costs are similar.
+ * The selection is logged only when at least one cost has been measured instead of read from the cache.
+ *
+ * @param  env         the JNI environment.
+ * @param  context     the PJ_CONTEXT wrapper for the current thread.
+ * @param  source      the source CRS of all candidate operations.
+ * @param  operations  the candidate operations, in PROJ preference order. Shall not be empty.
+ * @param  db          the database context to use for formatting the PROJ strings.
+ * @param  aoi         the area of interest as west, east, south and north bounds, or NaN if none.
+ * @return index of the fastest operation.
+ * @throw  std::exception if an error occurred in a PROJ function.
+ */
+size_t select_fastest(JNIEnv *env, jobject context, const CRSNNPtr &source,
+                      const std::vector<CoordinateOperationNNPtr> &operations,
+                      const DatabaseContextPtr &db, const double aoi[4])
+{
+    double bbox[4];
+    if (aoi[2] < aoi[3]) {
+        std::copy(aoi, aoi+4, bbox);
+    } else {
+        if (!get_geographic_bbox(*source, bbox) && !get_geographic_bbox(*operations[0], bbox)) {
+            return 0;
+        }
+    }
+    PJ_CONTEXT *ctx = get_context(env, context);
+    std::vector<double> points;
+    cost_sample_points(ctx, source, bbox, points);
+    if (points.empty()) {
+        return 0;
+    }
+    char areaKey[100];
+    snprintf(areaKey, sizeof(areaKey), "%g %g %g %g", bbox[0], bbox[1], bbox[2], bbox[3]);
+    size_t selected = 0;
+    double minCost  = std::numeric_limits<double>::infinity();
+    bool measured   = false;
+    PROJStringFormatterNNPtr formatter = PROJStringFormatter::create(PROJStringFormatter::Convention::PROJ_5, db);
+    for (size_t i=0; i<operations.size(); i++) {
+        std::string projDef;
+        try {
+            projDef = operations[i]->exportToPROJString(formatter.get());
+        } catch (const std::exception &) {
+            continue;       // Operation not instantiable (e.g. ballpark without PROJ equivalent).
+        }
+        const double cost = operation_cost(ctx, projDef, areaKey, points, measured);
+        if (cost < minCost * COST_SIGNIFICANT_RATIO) {
+            minCost  = cost;
+            selected = i;
+        }
+    }
+    if (measured && minCost != std::numeric_limits<double>::infinity()) {
+        log(env, "Selected \"" + operations[selected]->nameStr() + "\" as the fastest of "
+              + std::to_string(operations.size()) + " candidate operations ("
+              + std::to_string(minCost) + " ns per point).");
+    }
+    return selected;
+}
+
+
 /**
  * Finds a list of coordinate operation between the given source and target CRS.
  * The operations are sorted with the most relevant ones first: by descending area
@@ -2466,6 +3148,8 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createGeodeticObj
  * @param  gridAvailabilityUse          How grid availability is used.
  * @param  allowUseIntermediateCRS      Whether an intermediate pivot CRS can be used for researching coordinate operations.
  * @param  discardSuperseded            Whether transformations that are superseded (but not deprecated) should be discarded.
+ * @param  context                      The PJ_CONTEXT wrapper in which to measure the speed of candidate operations,
+ *                                      or null for selecting the first operation in PROJ preference order.
  * @return The coordinate operations.
  */
 JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
@@ -2474,28 +3158,28 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
      jdouble southBoundLatitude, jdouble northBoundLatitude,
      jdouble desiredAccuracy,
      jint sourceAndTargetCRSExtentUse, jint spatialCriterion, jint gridAvailabilityUse, jint allowUseIntermediateCRS,
-     jboolean discardSuperseded)
+     jboolean discardSuperseded, jobject context)
 {
     try {
         CRSNNPtr                        source  = get_shared_object<CRS>(env, sourceCRS);
         CRSNNPtr                        target  = get_shared_object<CRS>(env, targetCRS);
         AuthorityFactoryPtr             pf      = get_and_unwrap_ptr<AuthorityFactory>(env, factory);
-        CoordinateOperationContextNNPtr context = CoordinateOperationContext::create(pf, nullptr, desiredAccuracy);
-        context->setDiscardSuperseded(discardSuperseded);
+        CoordinateOperationContextNNPtr opContext = CoordinateOperationContext::create(pf, nullptr, desiredAccuracy);
+        opContext->setDiscardSuperseded(discardSuperseded);
         if (sourceAndTargetCRSExtentUse >= 0) {
-            context->setSourceAndTargetCRSExtentUse(static_cast<CoordinateOperationContext::SourceTargetCRSExtentUse>(sourceAndTargetCRSExtentUse));
+            opContext->setSourceAndTargetCRSExtentUse(static_cast<CoordinateOperationContext::SourceTargetCRSExtentUse>(sourceAndTargetCRSExtentUse));
         }
         if (spatialCriterion >= 0) {
-            context->setSpatialCriterion(static_cast<CoordinateOperationContext::SpatialCriterion>(spatialCriterion));
+            opContext->setSpatialCriterion(static_cast<CoordinateOperationContext::SpatialCriterion>(spatialCriterion));
         }
         if (gridAvailabilityUse >= 0) {
-            context->setGridAvailabilityUse(static_cast<CoordinateOperationContext::GridAvailabilityUse>(gridAvailabilityUse));
+            opContext->setGridAvailabilityUse(static_cast<CoordinateOperationContext::GridAvailabilityUse>(gridAvailabilityUse));
         }
         if (allowUseIntermediateCRS >= 0) {
-            context->setAllowUseIntermediateCRS(static_cast<CoordinateOperationContext::IntermediateCRSUse>(allowUseIntermediateCRS));
+            opContext->setAllowUseIntermediateCRS(static_cast<CoordinateOperationContext::IntermediateCRSUse>(allowUseIntermediateCRS));
         }
         if (northBoundLatitude > southBoundLatitude || eastBoundLongitude > westBoundLongitude) {
-            context->setAreaOfInterest(Extent::createFromBBOX(
+            opContext->setAreaOfInterest(Extent::createFromBBOX(
                     westBoundLongitude, southBoundLatitude,
                     eastBoundLongitude, northBoundLatitude));
         }
@@ -2503,9 +3187,24 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
          * At this time, it does not seem worth to cache the CoordinateOperationFactory instance.
          */
         CoordinateOperationFactoryNNPtr opf = CoordinateOperationFactory::create();
-        std::vector<CoordinateOperationNNPtr> operations = opf->createOperations(source, target, context);
+        JPJ_PROBE2(operations__entry, source.as_nullable().get(), target.as_nullable().get());
+        std::vector<CoordinateOperationNNPtr> operations = opf->createOperations(source, target, opContext);
+        JPJ_PROBE3(operations__exit, source.as_nullable().get(), target.as_nullable().get(), operations.size());
         if (!operations.empty()) {
-            BaseObjectPtr op = operations[0].as_nullable();
+            size_t selected = 0;
+            /*
+             * If the caller wants the fastest operation meeting the desired accuracy, measure the
+             * cost of each candidate. Without desired accuracy, PROJ returns operations of any
+             * accuracy, in which case the first one (usually the most accurate) is kept.
+             */
+            if (context && desiredAccuracy > 0 && operations.size() > 1) {
+                double aoi[4] = {westBoundLongitude, eastBoundLongitude, southBoundLatitude, northBoundLatitude};
+                if (!(northBoundLatitude > southBoundLatitude)) {
+                    aoi[2] = aoi[3] = std::numeric_limits<double>::quiet_NaN();
+                }
+                selected = select_fastest(env, context, source, operations, pf->databaseContext().as_nullable(), aoi);
+            }
+            BaseObjectPtr op = operations[selected].as_nullable();
             if (op) {
                 return specific_subclass(env, factory, op, org_osgeo_proj_Type_COORDINATE_OPERATION);
             }
@@ -2521,7 +3220,7 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
 
 // </editor-fold>
 // ┌────────────────────────────────────────────────────────────────────────────────────────────┐
-// │                 CLASS Transform + Context.createPJ + SharedPointer.inverse                 │
+// │    CLASS Transform + Context.createPJ + Context.createPipeline + SharedPointer.inverse     │
 // └────────────────────────────────────────────────────────────────────────────────────────────┘
 // <editor-fold desc="Transform">
 
@@ -2533,16 +3232,29 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
  * @param  env          The JNI environment.
  * @param  context      The thread context in which the operation is applied.
  * @param  operation    The Java object wrapping the coordinate operation to use.
- * @return pointer to the PJ object, or null if the creation failed.
+ * @return pointer to the PJ object, or null if the creation failed (in which case a Java exception is pending).
  */
 JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createPJ(JNIEnv *env, jobject context, jobject operation) {
     try {
         CoordinateOperationNNPtr cop       = get_shared_object<CoordinateOperation>(env, operation);
+        JPJ_PROBE1(createpj__entry, cop.as_nullable().get());
         DatabaseContextPtr       dbContext = get_database_context(env, context);
         PROJStringFormatterNNPtr formatter = PROJStringFormatter::create(PROJStringFormatter::Convention::PROJ_5, dbContext);
         std::string              projDef   = cop->exportToPROJString(formatter.get());
         PJ_CONTEXT               *ctx      = get_context(env, context);
         PJ                       *pj       = proj_create(ctx, projDef.c_str());
+        JPJ_PROBE3(createpj__exit, cop.as_nullable().get(), pj, projDef.c_str());
+        if (!pj) {
+            /*
+             * Typically a missing grid file. Report the PROJ error instead of returning 0,
+             * which would be interpreted as an out-of-memory error by the Java code.
+             */
+            const int err = proj_context_errno(ctx);
+            jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+            if (c) env->ThrowNew(c, err ? proj_errno_string(err) : "Can not create PROJ object.");
+        } else {
+            count_resource(org_osgeo_proj_NativeResource_TRANSFORMS, +1);
+        }
         return reinterpret_cast<jlong>(pj);
     } catch (const std::exception &e) {
         rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
@@ -2552,23 +3264,121 @@ JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createPJ(JNIEnv *env, jobjec
 
 
 /**
- * Returns the pointer to PJ for the given Transform object in Java.
+ * Creates the PJ object from a PROJ string, to be wrapped in a Transform. Contrarily to createPJ,
+ * this function does not build any coordinate operation object: the string is given directly to
+ * `proj_create(…)`. The string shall define a coordinate operation, typically a "+proj=pipeline".
  *
- * @param  env      The JNI environment.
- * @param  context  The Transform object.
- * @return The pointer to PJ, or null if none.
+ * @param  env         The JNI environment.
+ * @param  context     The thread context in which the operation is applied.
+ * @param  definition  The PROJ string of the coordinate operation.
+ * @return pointer to the PJ object, or null if the creation failed.
  */
-inline PJ* get_PJ(JNIEnv *env, jobject transform) {
-    return reinterpret_cast<PJ*>(env->GetLongField(transform, java_field_for_pointer));
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createPipeline(JNIEnv *env, jobject context, jstring definition) {
+    PJ_CONTEXT *ctx = get_context(env, context);
+    const char *definition_utf = env->GetStringUTFChars(definition, nullptr);
+    if (definition_utf) {
+        PJ *pj = proj_create(ctx, definition_utf);
+        env->ReleaseStringUTFChars(definition, definition_utf);
+        const char *message = nullptr;
+        if (!pj) {
+            const int err = proj_context_errno(ctx);
+            message = err ? proj_errno_string(err) : "Can not create PROJ object.";
+        } else if (proj_is_crs(pj)) {
+            proj_destroy(pj);
+            message = "The PROJ string defines a CRS instead than a coordinate operation.";
+        } else {
+            count_resource(org_osgeo_proj_NativeResource_TRANSFORMS, +1);
+            return reinterpret_cast<jlong>(pj);
+        }
+        jclass c = env->FindClass(JPJ_FACTORY_EXCEPTION);
+        if (c) env->ThrowNew(c, message);
+    }
+    return 0;
 }
 
 
 /**
- * Assigns a PJ_CONTEXT to the PJ wrapped by the Transform.
- * This method must be invoked before and after call to transform method.
+ * Creates a PJ object converting coordinates in the given CRS to geographic coordinates on the same datum,
+ * with longitude first. This is used for checking whether points are inside the domain of validity of a
+ * coordinate operation before to transform them. The geographic CRS is the geodetic CRS of the given CRS.
  *
- * @param  env        The JNI environment.
- * @param  transform  The Java object wrapping the PJ to use.
+ * Only the target geographic CRS is normalized to (longitude, latitude) in degrees. The source CRS is used
+ * as-is, because the points given to the guard are in the axis order and units of the guarded operation.
+ *
+ * @param  env         The JNI environment.
+ * @param  context     The thread context in which the operation is applied.
+ * @param  definition  The definition (typically WKT) of the source CRS of the guarded operation.
+ * @return pointer to the PJ object, or null if the creation failed.
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createDomainPJ(JNIEnv *env, jobject context, jstring definition) {
+    PJ_CONTEXT *ctx = get_context(env, context);
+    const char *definition_utf = env->GetStringUTFChars(definition, nullptr);
+    if (definition_utf) {
+        PJ *crs = proj_create(ctx, definition_utf);
+        env->ReleaseStringUTFChars(definition, definition_utf);
+        PJ *pj = nullptr;
+        if (crs) {
+            PJ *geodetic = proj_crs_get_geodetic_crs(ctx, crs);
+            if (geodetic) {
+                const PJ_TYPE type = proj_get_type(geodetic);
+                if (type == PJ_TYPE_GEOGRAPHIC_2D_CRS || type == PJ_TYPE_GEOGRAPHIC_3D_CRS) {
+                    PJ *normalized = proj_normalize_for_visualization(ctx, geodetic);
+                    if (normalized) {
+                        PJ *target = proj_crs_alter_cs_angular_unit(ctx, normalized, "degree", 0.0174532925199433, "EPSG", "9122");
+                        if (target) {
+                            pj = proj_create_crs_to_crs_from_pj(ctx, crs, target, nullptr, nullptr);
+                            proj_destroy(target);
+                        }
+                        proj_destroy(normalized);
+                    }
+                }
+                proj_destroy(geodetic);
+            }
+            proj_destroy(crs);
+        }
+        if (pj) {
+            count_resource(org_osgeo_proj_NativeResource_TRANSFORMS, +1);
+            return reinterpret_cast<jlong>(pj);
+        }
+        jclass c = env->FindClass(JPJ_FACTORY_EXCEPTION);
+        if (c) env->ThrowNew(c, "Can not convert the source coordinates to geographic coordinates.");
+    }
+    return 0;
+}
+
+
+/**
+ * Returns the pointer to PJ for the given Transform object in Java.
+ *
+ * @param  env      The JNI environment.
+ * @param  context  The Transform object.
+ * @return The pointer to PJ, or null if none.
+ */
+inline PJ* get_PJ(JNIEnv *env, jobject transform) {
+    return reinterpret_cast<PJ*>(env->GetLongField(transform, java_field_for_pointer));
+}
+
+
+/**
+ * Returns the direction in which to execute the PJ for the given Transform object in Java.
+ * The same PJ is used in both directions: the inverse of a transform created from a PROJ string
+ * is executed with `PJ_INV` instead than creating another PJ.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Transform object.
+ * @return `PJ_INV` if the Transform is used for the inverse operation, or `PJ_FWD` otherwise.
+ */
+inline PJ_DIRECTION get_direction(JNIEnv *env, jobject transform) {
+    return env->GetBooleanField(transform, java_field_inverse) ? PJ_INV : PJ_FWD;
+}
+
+
+/**
+ * Assigns a PJ_CONTEXT to the PJ wrapped by the Transform.
+ * This method must be invoked before and after call to transform method.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Java object wrapping the PJ to use.
  * @param  Context    The context to assign, or null for removing context assignment.
  */
 JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_assign(JNIEnv *env, jobject transform, jobject context) {
@@ -2592,6 +3402,19 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_assign(JNIEnv *env, jobject
 std::atomic_flag arrayCriticalDoesCopies;
 
 
+/**
+ * Returns whether the PJ wrapped by the given Transform can be executed in the inverse direction.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Java object wrapping the PJ to check.
+ * @return Whether the PJ has an inverse operation.
+ */
+JNIEXPORT jboolean JNICALL Java_org_osgeo_proj_Transform_hasInverse(JNIEnv *env, jobject transform) {
+    PJ *pj = get_PJ(env, transform);
+    return (pj && proj_pj_info(pj).has_inverse) ? JNI_TRUE : JNI_FALSE;
+}
+
+
 /**
  * Transforms in-place the coordinates in the given array.
  * The coordinates array shall contain (x,y,z,t,…) tuples,
@@ -2616,6 +3439,7 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transform
 {
     PJ *pj = get_PJ(env, transform);
     if (pj) {
+        JPJ_PROBE3(transform__entry, pj, numPts, dimension);
         const size_t stride = sizeof(jdouble) * dimension;
         /*
          * Using GetPrimitiveArrayCritical/ReleasePrimitiveArrayCritical rather than
@@ -2631,13 +3455,18 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transform
             double *y = (dimension >= 2) ? x+1 : nullptr;
             double *z = (dimension >= 3) ? x+2 : nullptr;
             double *t = (dimension >= 4) ? x+3 : nullptr;
-            proj_trans_generic(pj, PJ_FWD,
+            JPJ_PROBE2(critical__entry, pj, isCopy);
+            JPJ_PROBE2(trans__entry, pj, numPts);
+            proj_trans_generic(pj, get_direction(env, transform),
                     x, stride, numPts,
                     y, stride, numPts,
                     z, stride, numPts,
                     t, stride, numPts);
+            JPJ_PROBE2(trans__exit, pj, numPts);
             env->ReleasePrimitiveArrayCritical(coordinates, data, 0);
+            JPJ_PROBE1(critical__exit, pj);
             const int err = proj_errno(pj);
+            JPJ_PROBE3(transform__exit, pj, numPts, err);
             if (err) {
                 proj_errno_reset(pj);
                 jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
@@ -2704,5 +3533,3005 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_SharedPointer_normalizeForVisualiz
 JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_destroy(JNIEnv *env, jobject transform) {
     jlong pjPtr = get_and_clear_ptr(env, transform);
     proj_destroy(reinterpret_cast<PJ*>(pjPtr));         // Does nothing if pjPtr is null.
+    if (pjPtr) count_resource(org_osgeo_proj_NativeResource_TRANSFORMS, -1);
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                             CLASS Transform (batch operations)                             │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Batch transforms">
+
+
+/**
+ * Number of coordinate tuples processed in each step of a batch transform. Batch transforms copy
+ * the coordinates from the Java arrays into a temporary buffer of this size, transform them, then
+ * copy the results back into the Java arrays. The chunk size is a compromise between the overhead
+ * of JNI calls and the size of the temporary buffer, which should fit in the processor cache.
+ */
+const jint BATCH_CHUNK_SIZE = 1024;
+
+
+/**
+ * Description of a Java array of coordinate tuples to read or to write in a batch transform.
+ * The array can be of type double[], float[], int[] or short[]. For integer types, the values
+ * are converted by an affine transform of the form `x = q*scale + offset` on input, or by the
+ * inverse of this form `q = round(x*scale + offset)` on output.
+ */
+struct TupleArray {
+    jarray  array;          // The Java array of coordinate tuples.
+    jint    type;           // One of the Transform.DOUBLE, FLOAT, INT or SHORT constants.
+    jint    offset;         // Index of the first coordinate value in the Java array.
+    jint    dimension;      // Number of coordinate values per tuple in the Java array.
+    jdouble *scale;         // Scale factor for each dimension, or null if none.
+    jdouble *translate;     // Offset for each dimension, valid only if `scale` is non-null.
+};
+
+
+/**
+ * Converts a coordinate value to an element of a Java array. For integer types, the value is rounded
+ * to the nearest integer and clamped to the range of the integer type. NaN values are mapped to zero.
+ *
+ * @param  value  the coordinate value to convert.
+ * @return the value to store in the Java array.
+ */
+template <class T> inline T to_array_element(jdouble value) {
+    if (std::is_floating_point<T>::value) {
+        return static_cast<T>(value);
+    }
+    if (std::isnan(value)) {
+        return 0;
+    }
+    value = std::round(value);
+    if (value <= std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+    if (value >= std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    return static_cast<T>(value);
+}
+
+
+/**
+ * Copies coordinate tuples from a Java array into a buffer of double values,
+ * applying the dequantization affine transform if any.
+ *
+ * @param  values     the values read from the Java array, `dimension` values per tuple.
+ * @param  source     description of the Java array.
+ * @param  buffer     where to write the coordinates, `stride` values per tuple.
+ * @param  stride     number of values per tuple in the buffer. Shall be ≥ `source.dimension`.
+ * @param  count      number of tuples to copy.
+ */
+template <class T> void load_tuples(const T *values, const TupleArray &source, jdouble *buffer, int stride, jint count) {
+    const int dimension = source.dimension;
+    for (jint i=0; i<count; i++) {
+        for (int j=0; j<dimension; j++) {
+            jdouble value = static_cast<jdouble>(*values++);
+            if (source.scale) {
+                value = value * source.scale[j] + source.translate[j];
+            }
+            buffer[j] = value;
+        }
+        for (int j=dimension; j<stride; j++) {
+            buffer[j] = 0;
+        }
+        buffer += stride;
+    }
+}
+
+
+/**
+ * Copies coordinate tuples from a buffer of double values into the array of values to write
+ * in the Java array, applying the quantization affine transform if any.
+ *
+ * @param  buffer     the transformed coordinates, `stride` values per tuple.
+ * @param  stride     number of values per tuple in the buffer. Shall be ≥ `target.dimension`.
+ * @param  target     description of the Java array.
+ * @param  values     where to write the values to store in the Java array.
+ * @param  count      number of tuples to copy.
+ */
+template <class T> void store_tuples(const jdouble *buffer, int stride, const TupleArray &target, T *values, jint count) {
+    const int dimension = target.dimension;
+    for (jint i=0; i<count; i++) {
+        for (int j=0; j<dimension; j++) {
+            jdouble value = buffer[j];
+            if (target.scale) {
+                value = value * target.scale[j] + target.translate[j];
+            }
+            *values++ = to_array_element<T>(value);
+        }
+        buffer += stride;
+    }
+}
+
+
+/**
+ * Reads a chunk of coordinate tuples from the given Java array.
+ * The `staging` vector is used as a temporary storage for the raw array elements.
+ *
+ * @param  env      The JNI environment.
+ * @param  source   Description of the Java array to read.
+ * @param  start    Index of the first tuple to read, relative to `source.offset`.
+ * @param  count    Number of tuples to read.
+ * @param  buffer   Where to write the coordinate values.
+ * @param  stride   Number of values per tuple in the buffer.
+ * @param  staging  Temporary storage, resized as needed.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool read_tuples(JNIEnv *env, const TupleArray &source, jint start, jint count,
+                 jdouble *buffer, int stride, std::vector<char> &staging)
+{
+    const jsize from = source.offset + start * source.dimension;
+    const jsize n    = count * source.dimension;
+    switch (source.type) {
+        case org_osgeo_proj_Transform_DOUBLE: {
+            staging.resize(n * sizeof(jdouble));
+            jdouble *values = reinterpret_cast<jdouble*>(staging.data());
+            env->GetDoubleArrayRegion(static_cast<jdoubleArray>(source.array), from, n, values);
+            load_tuples(values, source, buffer, stride, count);
+            break;
+        }
+        case org_osgeo_proj_Transform_FLOAT: {
+            staging.resize(n * sizeof(jfloat));
+            jfloat *values = reinterpret_cast<jfloat*>(staging.data());
+            env->GetFloatArrayRegion(static_cast<jfloatArray>(source.array), from, n, values);
+            load_tuples(values, source, buffer, stride, count);
+            break;
+        }
+        case org_osgeo_proj_Transform_INT: {
+            staging.resize(n * sizeof(jint));
+            jint *values = reinterpret_cast<jint*>(staging.data());
+            env->GetIntArrayRegion(static_cast<jintArray>(source.array), from, n, values);
+            load_tuples(values, source, buffer, stride, count);
+            break;
+        }
+        case org_osgeo_proj_Transform_SHORT: {
+            staging.resize(n * sizeof(jshort));
+            jshort *values = reinterpret_cast<jshort*>(staging.data());
+            env->GetShortArrayRegion(static_cast<jshortArray>(source.array), from, n, values);
+            load_tuples(values, source, buffer, stride, count);
+            break;
+        }
+        default: {
+            jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+            if (c) env->ThrowNew(c, "Unsupported array type.");
+            return false;
+        }
+    }
+    return !env->ExceptionCheck();
+}
+
+
+/**
+ * Writes a chunk of coordinate tuples into the given Java array.
+ * The `staging` vector is used as a temporary storage for the raw array elements.
+ *
+ * @param  env      The JNI environment.
+ * @param  target   Description of the Java array to write.
+ * @param  start    Index of the first tuple to write, relative to `target.offset`.
+ * @param  count    Number of tuples to write.
+ * @param  buffer   The coordinate values to write.
+ * @param  stride   Number of values per tuple in the buffer.
+ * @param  staging  Temporary storage, resized as needed.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool write_tuples(JNIEnv *env, const TupleArray &target, jint start, jint count,
+                  const jdouble *buffer, int stride, std::vector<char> &staging)
+{
+    const jsize from = target.offset + start * target.dimension;
+    const jsize n    = count * target.dimension;
+    switch (target.type) {
+        case org_osgeo_proj_Transform_DOUBLE: {
+            staging.resize(n * sizeof(jdouble));
+            jdouble *values = reinterpret_cast<jdouble*>(staging.data());
+            store_tuples(buffer, stride, target, values, count);
+            env->SetDoubleArrayRegion(static_cast<jdoubleArray>(target.array), from, n, values);
+            break;
+        }
+        case org_osgeo_proj_Transform_FLOAT: {
+            staging.resize(n * sizeof(jfloat));
+            jfloat *values = reinterpret_cast<jfloat*>(staging.data());
+            store_tuples(buffer, stride, target, values, count);
+            env->SetFloatArrayRegion(static_cast<jfloatArray>(target.array), from, n, values);
+            break;
+        }
+        case org_osgeo_proj_Transform_INT: {
+            staging.resize(n * sizeof(jint));
+            jint *values = reinterpret_cast<jint*>(staging.data());
+            store_tuples(buffer, stride, target, values, count);
+            env->SetIntArrayRegion(static_cast<jintArray>(target.array), from, n, values);
+            break;
+        }
+        case org_osgeo_proj_Transform_SHORT: {
+            staging.resize(n * sizeof(jshort));
+            jshort *values = reinterpret_cast<jshort*>(staging.data());
+            store_tuples(buffer, stride, target, values, count);
+            env->SetShortArrayRegion(static_cast<jshortArray>(target.array), from, n, values);
+            break;
+        }
+        default: {
+            jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+            if (c) env->ThrowNew(c, "Unsupported array type.");
+            return false;
+        }
+    }
+    return !env->ExceptionCheck();
+}
+
+
+/**
+ * Gets the scale factors and offsets of a quantization from the given Java array.
+ * The Java array shall contain all scale factors followed by all offsets.
+ *
+ * @param  env           The JNI environment.
+ * @param  array         The Java array of scale factors and offsets, or null if none.
+ * @param  dimension     Number of dimensions.
+ * @param  coefficients  Where to store the coefficients.
+ * @param  tuples        The description of the array where to store the pointers to coefficients.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool get_quantization(JNIEnv *env, jdoubleArray array, int dimension, std::vector<jdouble> &coefficients, TupleArray &tuples) {
+    tuples.scale     = nullptr;
+    tuples.translate = nullptr;
+    if (array) {
+        coefficients.resize(2 * dimension);
+        env->GetDoubleArrayRegion(array, 0, 2 * dimension, coefficients.data());
+        if (env->ExceptionCheck()) {
+            return false;
+        }
+        tuples.scale     = coefficients.data();
+        tuples.translate = tuples.scale + dimension;
+    }
+    return true;
+}
+
+
+/**
+ * Transforms in-place the given coordinate tuples.
+ * If PROJ reports an error, the error code is returned and the PJ error state is reset.
+ *
+ * @param  pj           The PJ to use.
+ * @param  direction    `PJ_FWD` or `PJ_INV`.
+ * @param  coordinates  The coordinates to transform, as a sequence of (x,y,z,t,…) tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  count        Number of tuples to transform.
+ * @return The PROJ error code, or 0 if none.
+ */
+int transform_tuples(PJ *pj, PJ_DIRECTION direction, jdouble *coordinates, int dimension, jint count) {
+    const size_t stride = sizeof(jdouble) * dimension;
+    double *x = coordinates;
+    double *y = (dimension >= 2) ? x+1 : nullptr;
+    double *z = (dimension >= 3) ? x+2 : nullptr;
+    double *t = (dimension >= 4) ? x+3 : nullptr;
+    proj_trans_generic(pj, direction,
+            x, stride, count,
+            y, stride, count,
+            z, stride, count,
+            t, stride, count);
+    const int err = proj_errno(pj);
+    if (err) {
+        proj_errno_reset(pj);
+    }
+    return err;
+}
+
+
+/**
+ * Spreads the bits of the given 32 bits integer so that there is a zero bit between each bit of the
+ * original value. This is used for interleaving the bits of two values in a Morton code (Z-order curve).
+ *
+ * @param  value  the value to spread.
+ * @return the value with bits spread over 64 bits.
+ */
+inline uint64_t spread_bits(uint64_t value) {
+    value = (value | (value << 16)) & 0x0000FFFF0000FFFFULL;
+    value = (value | (value <<  8)) & 0x00FF00FF00FF00FFULL;
+    value = (value | (value <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+    value = (value | (value <<  2)) & 0x3333333333333333ULL;
+    value = (value | (value <<  1)) & 0x5555555555555555ULL;
+    return value;
+}
+
+
+/**
+ * Computes an order of the given coordinate tuples which follows a Morton (Z-order) curve over the
+ * two first dimensions. Points close in space are close in that order, which improves the locality
+ * of accesses to datum shift grids in PROJ. Tuples with NaN or infinite coordinates are put last.
+ *
+ * @param  coordinates  The coordinate tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  count        Number of tuples.
+ * @param  order        Where to store the indices of tuples in Morton order.
+ */
+void morton_order(const jdouble *coordinates, int dimension, jint count, std::vector<jint> &order) {
+    const int ny = (dimension >= 2) ? 1 : 0;
+    double xmin = INFINITY, xmax = -INFINITY;
+    double ymin = INFINITY, ymax = -INFINITY;
+    for (jint i=0; i<count; i++) {
+        const double x = coordinates[i*dimension];
+        const double y = coordinates[i*dimension + ny];
+        if (std::isfinite(x) && std::isfinite(y)) {
+            if (x < xmin) xmin = x;
+            if (x > xmax) xmax = x;
+            if (y < ymin) ymin = y;
+            if (y > ymax) ymax = y;
+        }
+    }
+    const double MAX_CELL = 4294967295.0;       // 2³² - 1
+    const double sx = (xmax > xmin) ? MAX_CELL / (xmax - xmin) : 0;
+    const double sy = (ymax > ymin) ? MAX_CELL / (ymax - ymin) : 0;
+    std::vector<std::pair<uint64_t, jint>> keys(count);
+    for (jint i=0; i<count; i++) {
+        const double x = coordinates[i*dimension];
+        const double y = coordinates[i*dimension + ny];
+        uint64_t key = UINT64_MAX;
+        if (std::isfinite(x) && std::isfinite(y)) {
+            const uint64_t cx = static_cast<uint64_t>(std::min((x - xmin) * sx, MAX_CELL));
+            const uint64_t cy = static_cast<uint64_t>(std::min((y - ymin) * sy, MAX_CELL));
+            key = spread_bits(cx) | (spread_bits(cy) << 1);
+        }
+        keys[i] = std::make_pair(key, i);
+    }
+    std::sort(keys.begin(), keys.end());
+    order.resize(count);
+    for (jint i=0; i<count; i++) {
+        order[i] = keys[i].second;
+    }
+}
+
+
+/**
+ * Number of tuples examined for estimating the rate of duplicated tuples in a batch, and minimal rate
+ * for enabling the deduplication. If the duplicates in the first tuples of a batch are less frequent
+ * than this rate, then the deduplication is not worth its cost (hashing all tuples) and is skipped.
+ */
+const jint   DEDUPLICATION_SAMPLE   = 4096;
+const double DEDUPLICATION_MIN_RATE = 0.1;
+
+
+/**
+ * Computes a hash code for the exact bit patterns of the given coordinate tuple.
+ *
+ * @param  tuple      The coordinate values.
+ * @param  dimension  Number of values in the tuple.
+ * @return Hash code of the given tuple.
+ */
+inline uint64_t hash_tuple(const jdouble *tuple, int dimension) {
+    uint64_t h = 0;
+    for (int j=0; j<dimension; j++) {
+        uint64_t bits;
+        std::memcpy(&bits, tuple + j, sizeof(bits));
+        h = (h ^ bits) * 0x100000001B3ULL;
+        h ^= h >> 29;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+
+/**
+ * Finds the tuples which are exact duplicates of a previous tuple. After this function call,
+ * `mapping[i]` is the index of the first tuple having the same bit patterns than tuple `i`.
+ * For the first occurrence of each tuple, `mapping[i] == i`.
+ *
+ * @param  coordinates  The coordinate tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  count        Number of tuples.
+ * @param  mapping      Where to store the index of the first occurrence of each tuple.
+ * @return Number of distinct tuples.
+ */
+jint find_duplicates(const jdouble *coordinates, int dimension, jint count, std::vector<jint> &mapping) {
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(count)) {
+        capacity <<= 1;
+    }
+    const size_t mask = capacity - 1;
+    std::vector<jint> table(capacity, -1);
+    mapping.resize(count);
+    jint distinct = 0;
+    for (jint i=0; i<count; i++) {
+        const jdouble *tuple = coordinates + static_cast<size_t>(i) * dimension;
+        size_t slot = hash_tuple(tuple, dimension) & mask;
+        for (;;) {
+            const jint k = table[slot];
+            if (k < 0) {
+                table[slot] = i;
+                mapping[i] = i;
+                distinct++;
+                break;
+            }
+            if (std::memcmp(coordinates + static_cast<size_t>(k) * dimension, tuple, sizeof(jdouble) * dimension) == 0) {
+                mapping[i] = k;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    return distinct;
+}
+
+
+/**
+ * Finds the duplicated tuples if they are frequent enough for making the deduplication worth its cost.
+ * The rate of duplicates is estimated on the first `DEDUPLICATION_SAMPLE` tuples. If this rate is less
+ * than `DEDUPLICATION_MIN_RATE`, then `mapping` is left empty. Otherwise `mapping` is computed as
+ * documented in `find_duplicates`.
+ *
+ * @param  coordinates  The coordinate tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  count        Number of tuples.
+ * @param  mapping      Where to store the index of the first occurrence of each tuple.
+ */
+void deduplicate(const jdouble *coordinates, int dimension, jint count, std::vector<jint> &mapping) {
+    const jint sample = std::min(count, DEDUPLICATION_SAMPLE);
+    const jint distinct = find_duplicates(coordinates, dimension, sample, mapping);
+    if (sample - distinct < DEDUPLICATION_MIN_RATE * sample) {
+        mapping.clear();
+    } else if (sample != count) {
+        find_duplicates(coordinates, dimension, count, mapping);
+    }
+}
+
+
+/*
+ * Forward declarations of the check of the domain of validity, defined later.
+ */
+struct DomainGuard;
+int transform_guarded(PJ *pj, PJ_DIRECTION direction, DomainGuard *guard, jdouble *coordinates, int dimension, jint count);
+
+
+/**
+ * Transforms in-place the given coordinate tuples in the specified order. The tuples are gathered
+ * in a temporary buffer in the given order, transformed, then scattered back to their original position.
+ *
+ * @param  pj           The PJ to use.
+ * @param  direction    `PJ_FWD` or `PJ_INV`.
+ * @param  guard        The domain of validity check, or null if none.
+ * @param  coordinates  The coordinates to transform, as a sequence of (x,y,z,t,…) tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  order        Indices of the tuples to transform, in the order to process them.
+ * @return The first PROJ error code, or 0 if none.
+ */
+int transform_in_order(PJ *pj, PJ_DIRECTION direction, DomainGuard *guard, jdouble *coordinates, int dimension, const std::vector<jint> &order) {
+    const jint count = static_cast<jint>(order.size());
+    std::vector<jdouble> buffer(static_cast<size_t>(std::min(BATCH_CHUNK_SIZE, count)) * dimension);
+    int error = 0;
+    for (jint start = 0; start < count; start += BATCH_CHUNK_SIZE) {
+        const jint n = std::min(BATCH_CHUNK_SIZE, count - start);
+        for (jint i=0; i<n; i++) {
+            const jdouble *tuple = coordinates + static_cast<size_t>(order[start + i]) * dimension;
+            std::copy(tuple, tuple + dimension, buffer.data() + i*dimension);
+        }
+        const int err = transform_guarded(pj, direction, guard, buffer.data(), dimension, n);
+        if (err && !error) error = err;
+        for (jint i=0; i<n; i++) {
+            const jdouble *tuple = buffer.data() + i*dimension;
+            std::copy(tuple, tuple + dimension, coordinates + static_cast<size_t>(order[start + i]) * dimension);
+        }
+    }
+    return error;
+}
+
+
+/**
+ * Check of the domain of validity of a coordinate operation before the transform. The source coordinates
+ * are converted to geographic coordinates (longitude first, in degrees) by the `domain` PJ, then compared
+ * to the geographic bounding box of the operation. Points outside the domain are not given to the main
+ * PJ. They are transformed by the `fallback` PJ if non-null, or set to NaN otherwise.
+ */
+struct DomainGuard {
+    PJ     *domain;                 // Conversion from source coordinates to geographic coordinates.
+    PJ     *fallback;               // Operation to apply on points outside the domain, or null.
+    PJ_DIRECTION fallbackDirection; // Direction in which to execute the fallback operation.
+    double west, south;             // Minimal longitude and latitude of the domain of validity.
+    double width, north;            // Longitude range (may cross the anti-meridian) and maximal latitude.
+    std::vector<jdouble> geographic;    // Storage for the geographic coordinates.
+    std::vector<jint>    inside;        // Storage for the indices of points inside the domain.
+    std::vector<jint>    outside;       // Storage for the indices of points outside the domain.
+};
+
+
+/**
+ * Initializes the domain guard from the PJ wrapped by the given Java objects and the bounding box.
+ *
+ * @param  env       The JNI environment.
+ * @param  domain    The Java object wrapping the conversion to geographic coordinates.
+ * @param  bounds    The west, east, south and north bounds of the domain of validity in degrees.
+ * @param  fallback  The Java object wrapping the fallback operation, or null if none.
+ * @param  guard     The guard to initialize.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool init_domain_guard(JNIEnv *env, jobject domain, jdoubleArray bounds, jobject fallback, DomainGuard &guard) {
+    jdouble box[4];
+    env->GetDoubleArrayRegion(bounds, 0, 4, box);
+    if (env->ExceptionCheck()) return false;
+    guard.domain   = get_PJ(env, domain);
+    guard.fallback = fallback ? get_PJ(env, fallback) : nullptr;
+    guard.fallbackDirection = fallback ? get_direction(env, fallback) : PJ_FWD;
+    if (!guard.domain) {
+        jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+        if (c) env->ThrowNew(c, "The domain of validity check has been disposed.");
+        return false;
+    }
+    guard.west     = box[0];
+    guard.width    = box[1] - box[0];
+    guard.south    = box[2];
+    guard.north    = box[3];
+    if (guard.width < 0) {
+        guard.width += 360;                     // Bounding box crossing the anti-meridian.
+    }
+    return true;
+}
+
+
+/**
+ * Transforms in-place the given coordinate tuples, checking first the domain of validity if a guard is
+ * specified. If all points are inside the domain (the common case), this function is equivalent to
+ * `transform_tuples`. Otherwise only the points inside the domain are transformed by the main PJ.
+ *
+ * @param  pj           The PJ to use.
+ * @param  direction    `PJ_FWD` or `PJ_INV`.
+ * @param  guard        The domain of validity check, or null if none.
+ * @param  coordinates  The coordinates to transform, as a sequence of (x,y,z,t,…) tuples.
+ * @param  dimension    Number of values per tuple.
+ * @param  count        Number of tuples to transform.
+ * @return The first PROJ error code, or 0 if none.
+ */
+int transform_guarded(PJ *pj, PJ_DIRECTION direction, DomainGuard *guard, jdouble *coordinates, int dimension, jint count) {
+    if (!guard) {
+        return transform_tuples(pj, direction, coordinates, dimension, count);
+    }
+    const size_t length = static_cast<size_t>(count) * dimension;
+    guard->geographic.assign(coordinates, coordinates + length);
+    transform_tuples(guard->domain, PJ_FWD, guard->geographic.data(), dimension, count);   // Failures are outside.
+    guard->inside.clear();
+    guard->outside.clear();
+    const int ny = (dimension >= 2) ? 1 : 0;
+    for (jint i=0; i<count; i++) {
+        const jdouble lon = guard->geographic[static_cast<size_t>(i) * dimension];
+        const jdouble lat = guard->geographic[static_cast<size_t>(i) * dimension + ny];
+        double offset = std::fmod(lon - guard->west, 360.0);
+        if (offset < 0) offset += 360;
+        const bool valid = std::isfinite(lon) && lat >= guard->south && lat <= guard->north
+                        && (offset <= guard->width || guard->width >= 360);
+        (valid ? guard->inside : guard->outside).push_back(i);
+    }
+    if (guard->outside.empty()) {
+        return transform_tuples(pj, direction, coordinates, dimension, count);
+    }
+    int error = guard->inside.empty() ? 0 : transform_in_order(pj, direction, nullptr, coordinates, dimension, guard->inside);
+    if (guard->fallback) {
+        const int err = transform_in_order(guard->fallback, guard->fallbackDirection, nullptr, coordinates, dimension, guard->outside);
+        if (err && !error) error = err;
+    } else {
+        for (const jint i : guard->outside) {
+            std::fill_n(coordinates + static_cast<size_t>(i) * dimension, dimension, std::numeric_limits<jdouble>::quiet_NaN());
+        }
+    }
+    return error;
+}
+
+
+/**
+ * Reductions and filters computed on the transformed coordinates, in the same pass as the copy of the
+ * results into the target Java array. Those reductions are computed on coordinate values before
+ * quantization. A tuple is a failure if a coordinate value is NaN or infinite (PROJ returns infinite
+ * values for the points that it can not transform). A tuple is outside if it is not a failure but
+ * is outside the extent. The envelope is computed on the retained tuples (not failures and not outside).
+ */
+struct Reductions {
+    const jdouble *extent;              // Minimum values followed by maximum values, or null if none.
+    bool           compact;             // Whether to write only the retained tuples, consecutively.
+    jbooleanArray  maskArray;           // Where to store whether each tuple is retained, or null.
+    jint           maskOffset;          // Index in `maskArray` of the flag for the first tuple.
+    jdouble        failures;            // Number of tuples that could not be transformed.
+    jdouble        outside;             // Number of transformed tuples outside the extent.
+    jdouble        retained;            // Number of tuples neither failed nor outside.
+    jint           written;             // Number of tuples written in this call if compaction is enabled.
+    std::vector<jdouble>  minimum;      // Minimal coordinate values of retained tuples.
+    std::vector<jdouble>  maximum;      // Maximal coordinate values of retained tuples.
+    std::vector<jdouble>  bounds;       // Storage for the extent.
+    std::vector<jboolean> mask;         // Storage for a chunk of the mask.
+};
+
+
+/**
+ * Initializes the reductions from the Java arrays. The `summary` array contains the number of failures,
+ * the number of tuples outside the extent, the number of retained tuples, the minimal values then the
+ * maximal values of the envelope. Those values are accumulated to the values computed in this call,
+ * so the same array can be used for many calls on consecutive chunks of the same batch.
+ *
+ * @param  env         The JNI environment.
+ * @param  summary     The accumulated counts and envelope, on `3 + 2*dimension` elements.
+ * @param  extent      The minimum values followed by the maximum values of the extent, or null if none.
+ * @param  mask        Where to store whether each tuple is retained, or null if none.
+ * @param  maskOffset  Index in `mask` of the flag for the first tuple.
+ * @param  compact     Whether to write only the retained tuples.
+ * @param  dimension   Number of dimensions of the target tuples.
+ * @param  reductions  The reductions to initialize.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool init_reductions(JNIEnv *env, jdoubleArray summary, jdoubleArray extent, jbooleanArray mask, jint maskOffset,
+                     bool compact, int dimension, Reductions &reductions)
+{
+    std::vector<jdouble> values(3 + 2 * dimension);
+    env->GetDoubleArrayRegion(summary, 0, static_cast<jsize>(values.size()), values.data());
+    reductions.extent = nullptr;
+    if (extent) {
+        reductions.bounds.resize(2 * dimension);
+        env->GetDoubleArrayRegion(extent, 0, 2 * dimension, reductions.bounds.data());
+        reductions.extent = reductions.bounds.data();
+    }
+    reductions.compact    = compact;
+    reductions.maskArray  = mask;
+    reductions.maskOffset = maskOffset;
+    reductions.failures   = values[0];
+    reductions.outside    = values[1];
+    reductions.retained   = values[2];
+    reductions.written    = 0;
+    reductions.minimum.assign(values.begin() + 3, values.begin() + (3 + dimension));
+    reductions.maximum.assign(values.begin() + (3 + dimension), values.end());
+    return !env->ExceptionCheck();
+}
+
+
+/**
+ * Stores the accumulated counts and envelope in the Java array from which they were initialized.
+ *
+ * @param  env         The JNI environment.
+ * @param  summary     The Java array where to store the counts and envelope.
+ * @param  reductions  The reductions computed by `reduce_tuples`.
+ */
+void store_reductions(JNIEnv *env, jdoubleArray summary, const Reductions &reductions) {
+    std::vector<jdouble> values;
+    values.push_back(reductions.failures);
+    values.push_back(reductions.outside);
+    values.push_back(reductions.retained);
+    values.insert(values.end(), reductions.minimum.begin(), reductions.minimum.end());
+    values.insert(values.end(), reductions.maximum.begin(), reductions.maximum.end());
+    env->SetDoubleArrayRegion(summary, 0, static_cast<jsize>(values.size()), values.data());
+}
+
+
+/**
+ * Updates the reductions with a chunk of transformed coordinate tuples. If compaction is enabled,
+ * the retained tuples are moved to the beginning of the buffer. The mask is stored in the Java array.
+ *
+ * @param  env         The JNI environment.
+ * @param  reductions  The reductions to update.
+ * @param  start       Index of the first tuple of the chunk in the batch.
+ * @param  count       Number of tuples in the chunk.
+ * @param  buffer      The transformed coordinates, `stride` values per tuple.
+ * @param  stride      Number of values per tuple in the buffer.
+ * @param  dimension   Number of dimensions of the target tuples.
+ * @return Number of retained tuples in the chunk, or -1 if a Java exception is pending.
+ */
+jint reduce_tuples(JNIEnv *env, Reductions &reductions, jint start, jint count,
+                   jdouble *buffer, int stride, int dimension)
+{
+    reductions.mask.resize(count);
+    jint kept = 0;
+    for (jint i=0; i<count; i++) {
+        const jdouble *tuple = buffer + static_cast<size_t>(i) * stride;
+        bool failed = false, inside = true;
+        for (int j=0; j<dimension; j++) {
+            const jdouble value = tuple[j];
+            if (!std::isfinite(value)) {
+                failed = true;
+                break;
+            }
+            if (reductions.extent && !(value >= reductions.extent[j] && value <= reductions.extent[dimension + j])) {
+                inside = false;
+            }
+        }
+        const bool retain = !failed && inside;
+        reductions.mask[i] = retain ? JNI_TRUE : JNI_FALSE;
+        if (failed) {
+            reductions.failures++;
+        } else if (!inside) {
+            reductions.outside++;
+        } else {
+            for (int j=0; j<dimension; j++) {
+                const jdouble value = tuple[j];
+                if (value < reductions.minimum[j]) reductions.minimum[j] = value;
+                if (value > reductions.maximum[j]) reductions.maximum[j] = value;
+            }
+            if (reductions.compact && kept != i) {
+                std::copy(tuple, tuple + stride, buffer + static_cast<size_t>(kept) * stride);
+            }
+            kept++;
+        }
+    }
+    reductions.retained += kept;
+    if (reductions.maskArray) {
+        env->SetBooleanArrayRegion(reductions.maskArray, reductions.maskOffset + start, count, reductions.mask.data());
+        if (env->ExceptionCheck()) return -1;
+    }
+    return kept;
+}
+
+
+/**
+ * Writes a chunk of transformed coordinate tuples into the given Java array, after updating the reductions
+ * if any. If compaction is enabled, only the retained tuples are written, after the tuples retained in the
+ * previous chunks. Otherwise this function is equivalent to `write_tuples`.
+ *
+ * @param  env         The JNI environment.
+ * @param  target      Description of the Java array to write.
+ * @param  start       Index of the first tuple to write, relative to `target.offset`.
+ * @param  count       Number of tuples to write.
+ * @param  buffer      The coordinate values to write. May be modified by compaction.
+ * @param  stride      Number of values per tuple in the buffer.
+ * @param  staging     Temporary storage, resized as needed.
+ * @param  reductions  The reductions to update, or null if none.
+ * @return Whether the operation succeeded. If false, a Java exception is pending.
+ */
+bool emit_tuples(JNIEnv *env, const TupleArray &target, jint start, jint count,
+                 jdouble *buffer, int stride, std::vector<char> &staging, Reductions *reductions)
+{
+    if (reductions) {
+        const jint kept = reduce_tuples(env, *reductions, start, count, buffer, stride, target.dimension);
+        if (kept < 0) return false;
+        if (reductions->compact) {
+            start = reductions->written;
+            count = kept;
+            reductions->written += kept;
+        }
+    }
+    return write_tuples(env, target, start, count, buffer, stride, staging);
+}
+
+
+/**
+ * Transforms coordinate tuples from a Java array to another Java array, potentially of different types.
+ * Integer values are dequantized before the transform and quantized after the transform, in a single
+ * pass over the data. The coordinates are processed in chunks of `BATCH_CHUNK_SIZE` tuples.
+ * If PROJ reports an error, the processing continues for the remaining chunks and an exception
+ * is thrown at the end.
+ *
+ * If the `Transform.REORDER` flag is set, then all coordinates are loaded in a temporary buffer
+ * and transformed in the order of a Morton curve before to be written in their original order.
+ * This is more expensive in memory, but can be much faster with operations using datum shift grids
+ * when the input points are in random order.
+ *
+ * If the `Transform.DEDUPLICATE` flag is set, then all coordinates are loaded in a temporary buffer
+ * and only the first occurrence of each distinct tuple is transformed. The result is copied to the
+ * duplicated tuples. This step is skipped if a sample suggests that there is few duplicated tuples.
+ *
+ * If `summary` is non-null, then reductions are computed on the transformed coordinates while they are
+ * in the processor cache: number of failures, number of points outside the extent and envelope of the
+ * other points. The mask of retained points is stored in `mask` if non-null. If the `Transform.COMPACT`
+ * flag is set, only the retained points are written, consecutively. In that case the number of written
+ * points is the increment of the retained count in `summary`. Failures are counted instead of causing an
+ * exception. The counts in `summary` should be initialized to 0 and the envelope to an empty envelope.
+ *
+ * If `domain` is non-null, points outside the domain of validity of the operation are not transformed
+ * by the main PJ. They are transformed by `fallback` if non-null, or set to NaN otherwise. NaN values
+ * are not reported as errors, but are counted as failures in the reductions if `summary` is non-null.
+ *
+ * @param  env         The JNI environment.
+ * @param  transform   The Java object wrapping the PJ to use.
+ * @param  srcDim      Number of dimensions of source tuples.
+ * @param  srcPts      The Java array of source coordinates.
+ * @param  srcType     Type of the source array as one of Transform.DOUBLE, FLOAT, INT or SHORT constants.
+ * @param  srcOff      Index of the first coordinate value in the source array.
+ * @param  dequantize  Scale factors and offsets to apply on source values, or null if none.
+ * @param  dstDim      Number of dimensions of target tuples.
+ * @param  dstPts      The Java array where to write the transformed coordinates.
+ * @param  dstType     Type of the target array as one of Transform.DOUBLE, FLOAT, INT or SHORT constants.
+ * @param  dstOff      Index of the first coordinate value in the target array.
+ * @param  quantize    Scale factors and offsets to apply on target values, or null if none.
+ * @param  numPts      Number of tuples to transform.
+ * @param  flags       Bitmask of Transform.REORDER, DEDUPLICATE and COMPACT, or 0 if none.
+ * @param  extent      Minimal values followed by maximal values of retained target points, or null if none.
+ * @param  mask        Where to store whether each point is retained, or null if none.
+ * @param  maskOff     Index in `mask` of the flag of the first point.
+ * @param  summary     Counts and envelope to update, or null for no reduction.
+ * @param  domain      The Java object wrapping the conversion to geographic coordinates, or null for no guard.
+ * @param  bounds      West, east, south and north bounds of the domain of validity. Ignored if `domain` is null.
+ * @param  fallback    The Java object wrapping the operation for points outside the domain, or null if none.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformBatch
+    (JNIEnv *env, jobject transform, jint srcDim, jobject srcPts, jint srcType, jint srcOff, jdoubleArray dequantize,
+                                     jint dstDim, jobject dstPts, jint dstType, jint dstOff, jdoubleArray quantize,
+                                     jint numPts, jint flags, jdoubleArray extent, jbooleanArray mask, jint maskOff,
+                                     jdoubleArray summary, jobject domain, jdoubleArray bounds, jobject fallback)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (pj) {
+        const PJ_DIRECTION direction = get_direction(env, transform);
+        try {
+            TupleArray source, target;
+            std::vector<jdouble> sourceCoefficients, targetCoefficients;
+            if (!get_quantization(env, dequantize, srcDim, sourceCoefficients, source) ||
+                !get_quantization(env, quantize,   dstDim, targetCoefficients, target))
+            {
+                return;
+            }
+            source.array     = static_cast<jarray>(srcPts);
+            source.type      = srcType;
+            source.offset    = srcOff;
+            source.dimension = srcDim;
+            target.array     = static_cast<jarray>(dstPts);
+            target.type      = dstType;
+            target.offset    = dstOff;
+            target.dimension = dstDim;
+            Reductions reductions, *reduce = nullptr;
+            if (summary) {
+                if (!init_reductions(env, summary, extent, mask, maskOff, (flags & org_osgeo_proj_Transform_COMPACT) != 0, dstDim, reductions)) {
+                    return;
+                }
+                reduce = &reductions;
+            }
+            DomainGuard domainGuard, *guard = nullptr;
+            if (domain) {
+                if (!init_domain_guard(env, domain, bounds, fallback, domainGuard)) {
+                    return;
+                }
+                guard = &domainGuard;
+            }
+            const int dimension = std::max(srcDim, dstDim);
+            std::vector<char> staging;
+            int error = 0;
+            /*
+             * Reordering is done only if there is more than one chunk,
+             * since the order inside a single chunk has less impact on the cache.
+             */
+            const bool reorder = (flags & org_osgeo_proj_Transform_REORDER) && numPts > BATCH_CHUNK_SIZE;
+            const bool dedup   = (flags & org_osgeo_proj_Transform_DEDUPLICATE) && numPts > 1;
+            if (reorder || dedup) {
+                /*
+                 * Load all coordinates, transform the distinct tuples in Morton order (if requested),
+                 * copy the results to duplicated tuples, then write all tuples in original order.
+                 */
+                std::vector<jdouble> coordinates(static_cast<size_t>(numPts) * dimension);
+                for (jint start = 0; start < numPts; start += BATCH_CHUNK_SIZE) {
+                    const jint count = std::min(BATCH_CHUNK_SIZE, numPts - start);
+                    if (!read_tuples(env, source, start, count, coordinates.data() + static_cast<size_t>(start) * dimension, dimension, staging)) {
+                        return;
+                    }
+                }
+                std::vector<jint> mapping, order;
+                if (dedup) {
+                    deduplicate(coordinates.data(), dimension, numPts, mapping);
+                }
+                if (reorder) {
+                    morton_order(coordinates.data(), dimension, numPts, order);
+                    if (!mapping.empty()) {
+                        order.erase(std::remove_if(order.begin(), order.end(),
+                                    [&mapping](jint i) {return mapping[i] != i;}), order.end());
+                    }
+                } else if (!mapping.empty()) {
+                    for (jint i=0; i<numPts; i++) {
+                        if (mapping[i] == i) order.push_back(i);
+                    }
+                }
+                if (order.empty()) {
+                    // Deduplication skipped and no reordering: transform all tuples in their current order.
+                    for (jint start = 0; start < numPts; start += BATCH_CHUNK_SIZE) {
+                        const jint count = std::min(BATCH_CHUNK_SIZE, numPts - start);
+                        const int err = transform_guarded(pj, direction, guard, coordinates.data() + static_cast<size_t>(start) * dimension, dimension, count);
+                        if (err && !error) error = err;
+                    }
+                } else {
+                    error = transform_in_order(pj, direction, guard, coordinates.data(), dimension, order);
+                }
+                for (jint i=0; i < static_cast<jint>(mapping.size()); i++) {
+                    const jint k = mapping[i];
+                    if (k != i) {
+                        const jdouble *tuple = coordinates.data() + static_cast<size_t>(k) * dimension;
+                        std::copy(tuple, tuple + dimension, coordinates.data() + static_cast<size_t>(i) * dimension);
+                    }
+                }
+                for (jint start = 0; start < numPts; start += BATCH_CHUNK_SIZE) {
+                    const jint count = std::min(BATCH_CHUNK_SIZE, numPts - start);
+                    if (!emit_tuples(env, target, start, count, coordinates.data() + static_cast<size_t>(start) * dimension, dimension, staging, reduce)) {
+                        return;
+                    }
+                }
+            } else {
+                std::vector<jdouble> buffer(static_cast<size_t>(std::min(BATCH_CHUNK_SIZE, numPts)) * dimension);
+                for (jint start = 0; start < numPts; start += BATCH_CHUNK_SIZE) {
+                    const jint count = std::min(BATCH_CHUNK_SIZE, numPts - start);
+                    if (!read_tuples(env, source, start, count, buffer.data(), dimension, staging)) {
+                        return;
+                    }
+                    const int err = transform_guarded(pj, direction, guard, buffer.data(), dimension, count);
+                    if (err && !error) error = err;
+                    if (!emit_tuples(env, target, start, count, buffer.data(), dimension, staging, reduce)) {
+                        return;
+                    }
+                }
+            }
+            if (reduce) {
+                store_reductions(env, summary, reductions);
+            } else if (error) {
+                jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+                if (c) env->ThrowNew(c, proj_errno_string(error));
+            }
+        } catch (const std::exception &e) {
+            rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+        }
+    }
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                         CLASS Transform (Arrow C Data Interface)                           │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Arrow C Data Interface">
+
+
+/*
+ * Structures of the Arrow C Data Interface. Those definitions are ABI-stable and are copied from
+ * the Arrow specification, as recommended by that specification, so that PROJ-JNI does not need
+ * any Arrow library. The guard avoids conflicts if an Arrow header has already been included.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+
+/**
+ * The Arrow layouts that can appear in a GeoArrow geometry array. Points are either a struct of
+ * double arrays (separated layout) or a fixed-size list of doubles (interleaved layout). Lines,
+ * polygons and multi-geometries are (large) lists of points, nested one to three times.
+ */
+enum ArrowLayout {
+    ARROW_UNSUPPORTED,
+    ARROW_DOUBLE,           // Format "g".
+    ARROW_LIST,             // Format "+l", with 32 bits offsets.
+    ARROW_LARGE_LIST,       // Format "+L", with 64 bits offsets.
+    ARROW_STRUCT,           // Format "+s".
+    ARROW_FIXED_LIST        // Format "+w:n" where n is the list size.
+};
+
+
+/**
+ * Returns the layout of arrays described by the given Arrow schema.
+ *
+ * @param  schema    The Arrow schema.
+ * @param  listSize  Where to store the list size if the layout is ARROW_FIXED_LIST.
+ * @return The layout, or ARROW_UNSUPPORTED if not a layout used by GeoArrow.
+ */
+ArrowLayout arrow_layout(const ArrowSchema *schema, int *listSize) {
+    const char *format = schema->format;
+    if (!format || schema->dictionary) return ARROW_UNSUPPORTED;
+    if (!strcmp(format, "g"))  return ARROW_DOUBLE;
+    if (!strcmp(format, "+l")) return ARROW_LIST;
+    if (!strcmp(format, "+L")) return ARROW_LARGE_LIST;
+    if (!strcmp(format, "+s")) return ARROW_STRUCT;
+    if (!strncmp(format, "+w:", 3)) {
+        *listSize = std::atoi(format + 3);
+        if (*listSize > 0) return ARROW_FIXED_LIST;
+    }
+    return ARROW_UNSUPPORTED;
+}
+
+
+/**
+ * Location of the coordinates of a GeoArrow point array. The x, y and optional z values are
+ * accessed with a stride, which allows to use the interleaved and separated layouts in the
+ * same way. A GeoArrow "m" dimension, if present, is a measure which is not transformed.
+ */
+struct ArrowPoints {
+    double  *x, *y, *z;     // Coordinates of the first point, or null for a missing z dimension.
+    size_t  stride;         // Number of bytes between two consecutive values of the same dimension.
+    int64_t count;          // Number of points.
+    const uint8_t *validity;    // Bitmap of non-null points, or null if all points are valid.
+    int64_t offset;         // Index of the first point in the validity bitmap.
+};
+
+
+/**
+ * Returns the index of the dimension of the given name in a GeoArrow point,
+ * as 0 for "x", 1 for "y", 2 for "z", 3 for "m", or -1 if unrecognized.
+ *
+ * @param  name  The field name.
+ * @return Index of the dimension of the given name, or -1.
+ */
+int geoarrow_dimension(const char *name) {
+    if (name && name[0] && !name[1]) {
+        switch (name[0]) {
+            case 'x': return 0;
+            case 'y': return 1;
+            case 'z': return 2;
+            case 'm': return 3;
+        }
+    }
+    return -1;
+}
+
+
+/**
+ * Finds the coordinates of the points in a GeoArrow array. This function descends through
+ * the lists of a linestring or polygon array until it finds the array of points. The buffers
+ * of the point array are not copied; the returned pointers reference the buffers of `array`.
+ *
+ * The arrays may be slices of larger arrays. At each level, the elements are the range starting
+ * at `offset` in the buffers of that level. For a list, that range of the offsets buffer gives
+ * the range of elements in the child array, which is itself relative to the child `offset`.
+ * Only the points in the range referenced by the top-level array are located.
+ *
+ * @param  schema  The Arrow schema describing the array.
+ * @param  array   The Arrow array of points or nested lists of points.
+ * @param  points  Where to store the location of the coordinates.
+ * @return null on success, or an error message if the array is not a supported GeoArrow array.
+ */
+const char *find_arrow_points(const ArrowSchema *schema, const ArrowArray *array, ArrowPoints &points) {
+    int64_t start = array->offset;      // Index of the first element in the buffers of the current array.
+    int64_t count = array->length;      // Number of elements in the current array.
+    for (int depth = 0; ; depth++) {
+        if (!array->release || !schema->release) {
+            return "Arrow array or schema has been released.";
+        }
+        if (array->n_children != schema->n_children) {
+            return "Arrow array does not match its schema.";
+        }
+        int listSize = 0;
+        const ArrowLayout layout = arrow_layout(schema, &listSize);
+        switch (layout) {
+            case ARROW_LIST:
+            case ARROW_LARGE_LIST: {
+                if (depth >= 3 || schema->n_children != 1 || array->n_buffers != 2) break;
+                int64_t lower = 0, upper = 0;
+                const void *offsets = array->buffers[1];
+                if (offsets) {
+                    if (layout == ARROW_LIST) {
+                        lower = static_cast<const int32_t*>(offsets)[start];
+                        upper = static_cast<const int32_t*>(offsets)[start + count];
+                    } else {
+                        lower = static_cast<const int64_t*>(offsets)[start];
+                        upper = static_cast<const int64_t*>(offsets)[start + count];
+                    }
+                } else if (count != 0) {
+                    break;
+                }
+                if (lower < 0 || upper < lower) break;
+                schema = schema->children[0];
+                array  = array ->children[0];
+                start  = array->offset + lower;
+                count  = upper - lower;
+                continue;
+            }
+            case ARROW_FIXED_LIST: {
+                // Interleaved layout: the names of dimensions are in the child name ("xy", "xyz", "xym" or "xyzm").
+                if (listSize < 2 || listSize > 4 || schema->n_children != 1) break;
+                const ArrowSchema *child = schema->children[0];
+                const ArrowArray  *data  = array ->children[0];
+                int unused;
+                if (arrow_layout(child, &unused) != ARROW_DOUBLE || data->n_buffers != 2) break;
+                if (!data->buffers[1] && count != 0) break;
+                const char *name = child->name;
+                const bool hasZ = (name && strncmp(name, "xy", 2) == 0) ? (name[2] == 'z') : (listSize >= 3);
+                double *base = static_cast<double*>(const_cast<void*>(data->buffers[1])) + data->offset + start * listSize;
+                points.x      = base;
+                points.y      = base + 1;
+                points.z      = hasZ ? base + 2 : nullptr;
+                points.stride = sizeof(double) * listSize;
+                break;
+            }
+            case ARROW_STRUCT: {
+                // Separated layout: one array of doubles for each of the "x", "y" and optional "z" and "m" fields.
+                if (schema->n_children < 2 || schema->n_children > 4) break;
+                double *ordinates[4] = {nullptr, nullptr, nullptr, nullptr};
+                bool valid = true;
+                for (int64_t i=0; i < schema->n_children; i++) {
+                    int unused;
+                    const ArrowSchema *child = schema->children[i];
+                    const ArrowArray  *data  = array ->children[i];
+                    const int dim = geoarrow_dimension(child->name);
+                    if (dim < 0 || ordinates[dim] || arrow_layout(child, &unused) != ARROW_DOUBLE || data->n_buffers != 2) {
+                        valid = false;
+                        break;
+                    }
+                    ordinates[dim] = static_cast<double*>(const_cast<void*>(data->buffers[1])) + data->offset + start;
+                }
+                if (!valid || (count != 0 && (!ordinates[0] || !ordinates[1]))) break;
+                points.x      = ordinates[0];
+                points.y      = ordinates[1];
+                points.z      = ordinates[2];
+                points.stride = sizeof(double);
+                break;
+            }
+            default: break;
+        }
+        if (!points.stride) {
+            return "Not a GeoArrow array of points, linestrings or polygons with double-precision coordinates.";
+        }
+        points.count    = count;
+        points.offset   = start;
+        points.validity = (array->null_count != 0 && array->n_buffers > 0)
+                        ? static_cast<const uint8_t*>(array->buffers[0]) : nullptr;
+        return nullptr;
+    }
+}
+
+
+/**
+ * Transforms in-place the coordinates of GeoArrow points. Null points are skipped, since their
+ * values are undefined. Consecutive valid points are transformed in a single call to PROJ.
+ *
+ * @param  pj         The PJ to use.
+ * @param  direction  `PJ_FWD` or `PJ_INV`.
+ * @param  points     Location of the coordinates to transform.
+ * @return The first PROJ error code, or 0 if none.
+ */
+int transform_arrow_points(PJ *pj, PJ_DIRECTION direction, const ArrowPoints &points) {
+    int error = 0;
+    int64_t start = 0;
+    while (start < points.count) {
+        int64_t end = points.count;
+        if (points.validity) {
+            const uint8_t *bits = points.validity;
+            const int64_t offset = points.offset;
+            auto valid = [bits, offset](int64_t i) {return (bits[(offset + i) >> 3] >> ((offset + i) & 7)) & 1;};
+            while (start < points.count && !valid(start)) start++;
+            end = start;
+            while (end < points.count && valid(end)) end++;
+            if (start >= end) break;
+        }
+        const size_t n = static_cast<size_t>(end - start);
+        const size_t s = points.stride;
+        char *x = reinterpret_cast<char*>(points.x) + start * s;
+        char *y = reinterpret_cast<char*>(points.y) + start * s;
+        char *z = points.z ? reinterpret_cast<char*>(points.z) + start * s : nullptr;
+        proj_trans_generic(pj, direction,
+                reinterpret_cast<double*>(x), s, n,
+                reinterpret_cast<double*>(y), s, n,
+                reinterpret_cast<double*>(z), s, z ? n : 0,
+                nullptr, 0, 0);
+        const int err = proj_errno(pj);
+        if (err) {
+            proj_errno_reset(pj);
+            if (!error) error = err;
+        }
+        start = end;
+    }
+    return error;
+}
+
+
+/**
+ * Storage of an Arrow array created by PROJ-JNI. This is the private data of the array.
+ * The children are allocated individually because the Arrow specification allows consumers
+ * to move them out of the parent array.
+ */
+struct ArrowArrayData {
+    std::vector<std::vector<uint8_t>> storage;      // Copies of the buffers.
+    std::vector<const void*>          buffers;      // Pointers to the above copies, or null.
+    std::vector<ArrowArray*>          children;     // Children arrays, owned by this data.
+};
+
+
+/**
+ * Storage of an Arrow schema created by PROJ-JNI. This is the private data of the schema.
+ */
+struct ArrowSchemaData {
+    std::string               format, name, metadata;
+    std::vector<ArrowSchema*> children;             // Children schemas, owned by this data.
+};
+
+
+/**
+ * Release callback of Arrow arrays created by PROJ-JNI, as required by the Arrow C Data Interface.
+ *
+ * @param  array  The array to release.
+ */
+void release_arrow_array(ArrowArray *array) {
+    ArrowArrayData *data = static_cast<ArrowArrayData*>(array->private_data);
+    for (ArrowArray *child : data->children) {
+        if (child->release) child->release(child);
+        delete child;
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+
+/**
+ * Release callback of Arrow schemas created by PROJ-JNI, as required by the Arrow C Data Interface.
+ *
+ * @param  schema  The schema to release.
+ */
+void release_arrow_schema(ArrowSchema *schema) {
+    ArrowSchemaData *data = static_cast<ArrowSchemaData*>(schema->private_data);
+    for (ArrowSchema *child : data->children) {
+        if (child->release) child->release(child);
+        delete child;
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+
+/**
+ * Copies the given Arrow array with all its buffers and children. The copy is initialized as a valid
+ * array (with a release callback) before any allocation, so it can be released if this function fails
+ * in the middle of the copy. Only the layouts used by GeoArrow are supported.
+ *
+ * @param  schema  The Arrow schema describing the array to copy.
+ * @param  source  The Arrow array to copy.
+ * @param  target  Where to write the copy. Shall not be initialized.
+ * @return Whether the copy succeeded. If false, `target` shall be released by the caller.
+ */
+bool copy_arrow_array(const ArrowSchema *schema, const ArrowArray *source, ArrowArray *target) {
+    ArrowArrayData *data = new ArrowArrayData();
+    *target              = *source;
+    target->buffers      = nullptr;
+    target->children     = nullptr;
+    target->dictionary   = nullptr;
+    target->release      = release_arrow_array;
+    target->private_data = data;
+    int listSize = 0;
+    size_t valueSize;
+    switch (arrow_layout(schema, &listSize)) {
+        case ARROW_DOUBLE:     valueSize = sizeof(double);  break;
+        case ARROW_LIST:       valueSize = sizeof(int32_t); break;
+        case ARROW_LARGE_LIST: valueSize = sizeof(int64_t); break;
+        case ARROW_STRUCT:
+        case ARROW_FIXED_LIST: valueSize = 0; break;
+        default: return false;
+    }
+    if (source->n_buffers != (valueSize ? 2 : 1) || source->n_children != schema->n_children) {
+        return false;
+    }
+    const size_t length = static_cast<size_t>(source->offset + source->length);
+    data->storage.resize(source->n_buffers);
+    data->buffers.resize(source->n_buffers);
+    for (int64_t i=0; i < source->n_buffers; i++) {
+        const void *buffer = source->buffers[i];
+        if (buffer) {
+            size_t size;
+            if (i == 0) {
+                size = (length + 7) / 8;                    // Validity bitmap.
+            } else if (valueSize == sizeof(double)) {
+                size = length * valueSize;                  // Coordinate values.
+            } else {
+                size = (length + 1) * valueSize;            // List offsets.
+            }
+            std::vector<uint8_t> &copy = data->storage[i];
+            copy.resize(size);
+            std::memcpy(copy.data(), buffer, size);
+            data->buffers[i] = copy.data();
+        }
+    }
+    target->buffers = data->buffers.data();
+    data->children.reserve(source->n_children);
+    for (int64_t i=0; i < source->n_children; i++) {
+        ArrowArray *child = new ArrowArray();
+        child->release = nullptr;
+        data->children.push_back(child);
+        if (!copy_arrow_array(schema->children[i], source->children[i], child)) {
+            return false;
+        }
+    }
+    target->children = data->children.data();
+    return true;
+}
+
+
+/**
+ * Returns the length in bytes of Arrow schema metadata, which are encoded as a number of key-value
+ * pairs followed by the pairs, each key and value being prefixed by its length as a 32 bits integer.
+ *
+ * @param  metadata  The Arrow metadata, or null.
+ * @return Length of the metadata in bytes.
+ */
+size_t arrow_metadata_length(const char *metadata) {
+    if (!metadata) return 0;
+    int32_t count;
+    std::memcpy(&count, metadata, sizeof(count));
+    size_t length = sizeof(int32_t);
+    for (int32_t i=0; i < 2*count; i++) {
+        int32_t n;
+        std::memcpy(&n, metadata + length, sizeof(n));
+        length += sizeof(int32_t) + n;
+    }
+    return length;
+}
+
+
+/**
+ * Copies Arrow schema metadata, replacing the GeoArrow extension metadata by the given value.
+ * The extension metadata contains the CRS of the coordinates, which is changed by the transform.
+ *
+ * @param  metadata   The Arrow metadata to copy, or null.
+ * @param  extension  The new value of the "ARROW:extension:metadata" key, or null for no replacement.
+ * @return The copy of metadata, or an empty string if none.
+ */
+std::string copy_arrow_metadata(const char *metadata, const char *extension) {
+    const size_t length = arrow_metadata_length(metadata);
+    if (!extension || length == 0) {
+        return std::string(metadata ? metadata : "", length);
+    }
+    static const char KEY[] = "ARROW:extension:metadata";
+    int32_t count;
+    std::memcpy(&count, metadata, sizeof(count));
+    std::string copy(metadata, sizeof(int32_t));
+    size_t position = sizeof(int32_t);
+    for (int32_t i=0; i<count; i++) {
+        int32_t keyLength, valueLength;
+        std::memcpy(&keyLength, metadata + position, sizeof(int32_t));
+        const char *key = metadata + position + sizeof(int32_t);
+        const size_t valueStart = position + sizeof(int32_t) + keyLength;
+        std::memcpy(&valueLength, metadata + valueStart, sizeof(int32_t));
+        const size_t next = valueStart + sizeof(int32_t) + valueLength;
+        if (keyLength == sizeof(KEY) - 1 && std::memcmp(key, KEY, keyLength) == 0) {
+            const int32_t n = static_cast<int32_t>(strlen(extension));
+            copy.append(metadata + position, valueStart - position);
+            copy.append(reinterpret_cast<const char*>(&n), sizeof(n));
+            copy.append(extension, n);
+        } else {
+            copy.append(metadata + position, next - position);
+        }
+        position = next;
+    }
+    return copy;
+}
+
+
+/**
+ * Copies the given Arrow schema with all its children. The copy is initialized as a valid schema
+ * (with a release callback) before any other allocation, so it can be released if this function
+ * throws an exception in the middle of the copy.
+ *
+ * @param  source     The Arrow schema to copy.
+ * @param  target     Where to write the copy. Shall not be initialized.
+ * @param  extension  The new value of the GeoArrow extension metadata, or null for no replacement.
+ */
+void copy_arrow_schema(const ArrowSchema *source, ArrowSchema *target, const char *extension) {
+    ArrowSchemaData *data = new ArrowSchemaData();
+    *target              = *source;
+    target->children     = nullptr;
+    target->dictionary   = nullptr;
+    target->release      = release_arrow_schema;
+    target->private_data = data;
+    data->format   = source->format;
+    data->name     = source->name ? source->name : "";
+    data->metadata = copy_arrow_metadata(source->metadata, extension);
+    target->format   = data->format.c_str();
+    target->name     = source->name ? data->name.c_str() : nullptr;
+    target->metadata = source->metadata ? data->metadata.data() : nullptr;
+    data->children.reserve(source->n_children);
+    for (int64_t i=0; i < source->n_children; i++) {
+        ArrowSchema *child = new ArrowSchema();
+        child->release = nullptr;
+        data->children.push_back(child);
+        copy_arrow_schema(source->children[i], child, nullptr);
+    }
+    target->children = data->children.data();
+}
+
+
+/**
+ * Owner of an Arrow schema and array under construction. If they are not moved to their
+ * final destination, they are released when this object goes out of scope.
+ */
+struct ArrowExport {
+    ArrowSchema schema;
+    ArrowArray  array;
+
+    ArrowExport() {
+        schema.release = nullptr;
+        array .release = nullptr;
+    }
+
+    ~ArrowExport() {
+        if (schema.release) schema.release(&schema);
+        if (array .release) array .release(&array);
+    }
+};
+
+
+/**
+ * Transforms the coordinates of a GeoArrow array of points, linestrings or polygons (including the
+ * multi-geometry variants) given by the addresses of its Arrow C Data Interface structures. If the
+ * target addresses are non-zero, the source array is copied in new structures written at the target
+ * addresses and the copy is transformed. Otherwise the source coordinates are transformed in-place.
+ * No Java array is involved. In all cases, the source structures are not released.
+ *
+ * Null points are not transformed. The "m" dimension, if present, is left unchanged.
+ * If PROJ reports an error, the processing continues for the remaining points and an exception
+ * is thrown at the end. In that case, nothing is written at the target addresses.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Java object wrapping the PJ to use.
+ * @param  srcSchema  Address of the ArrowSchema of the source array.
+ * @param  srcArray   Address of the source ArrowArray.
+ * @param  dstSchema  Address where to write the ArrowSchema of the result, or 0 for in-place.
+ * @param  dstArray   Address where to write the result ArrowArray, or 0 for in-place.
+ * @param  extension  New GeoArrow extension metadata to store in the target schema, or null.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformArrow
+    (JNIEnv *env, jobject transform, jlong srcSchema, jlong srcArray, jlong dstSchema, jlong dstArray, jstring extension)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (pj) {
+        try {
+            const ArrowSchema *schema = reinterpret_cast<const ArrowSchema*>(srcSchema);
+            const ArrowArray  *array  = reinterpret_cast<const ArrowArray*> (srcArray);
+            ArrowPoints points = ArrowPoints();
+            const char *message = find_arrow_points(schema, array, points);
+            if (message) {
+                jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                if (c) env->ThrowNew(c, message);
+                return;
+            }
+            ArrowExport result;
+            if (dstArray) {
+                const char *metadata = nullptr;
+                if (extension) {
+                    metadata = env->GetStringUTFChars(extension, nullptr);
+                    if (!metadata) return;                              // OutOfMemoryError already thrown.
+                }
+                try {
+                    copy_arrow_schema(schema, &result.schema, metadata);
+                } catch (...) {
+                    if (metadata) env->ReleaseStringUTFChars(extension, metadata);
+                    throw;
+                }
+                if (metadata) env->ReleaseStringUTFChars(extension, metadata);
+                if (!copy_arrow_array(schema, array, &result.array)) {
+                    jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                    if (c) env->ThrowNew(c, "Unsupported Arrow array layout.");
+                    return;
+                }
+                points = ArrowPoints();
+                find_arrow_points(&result.schema, &result.array, points);
+            }
+            const int error = transform_arrow_points(pj, get_direction(env, transform), points);
+            if (error) {
+                jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+                if (c) env->ThrowNew(c, proj_errno_string(error));
+                return;
+            }
+            if (dstArray) {
+                // Move the structures to the addresses given by the caller, who now owns them.
+                *reinterpret_cast<ArrowSchema*>(dstSchema) = result.schema;
+                *reinterpret_cast<ArrowArray*> (dstArray)  = result.array;
+                result.schema.release = nullptr;
+                result.array .release = nullptr;
+            }
+        } catch (const std::exception &e) {
+            rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+        }
+    }
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                              CLASS Transform (WKB geometries)                              │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="WKB geometries">
+
+
+/**
+ * Maximal number of bytes of WKB geometries copied from the Java array in each step of a WKB batch
+ * transform. A chunk contains at least one geometry, so a single large geometry may exceed this size.
+ */
+const size_t WKB_CHUNK_SIZE = 1 << 20;
+
+
+/**
+ * Flags of the EWKB geometry type (PostGIS extension of WKB) telling
+ * whether the geometry has z and m values and whether a SRID follows the type.
+ */
+const uint32_t EWKB_Z_FLAG    = 0x80000000;
+const uint32_t EWKB_M_FLAG    = 0x40000000;
+const uint32_t EWKB_SRID_FLAG = 0x20000000;
+
+
+/**
+ * Reverses the order of the bytes of the given integer.
+ *
+ * @param  value  The integer to swap.
+ * @return The integer with bytes in reverse order.
+ */
+inline uint32_t swap_bytes(uint32_t value) {
+    return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+}
+
+
+/**
+ * A sequence of vertices found in a WKB geometry, for example the vertices of a linestring or a ring.
+ */
+struct WKBRun {
+    size_t   position;      // Index of the first byte of the first vertex.
+    uint32_t count;         // Number of vertices.
+    int      dimension;     // Number of values per vertex (2, 3 or 4).
+    bool     hasZ;          // Whether the third value is z (otherwise it is m, which is not transformed).
+    bool     swap;          // Whether the bytes order is not the native order.
+};
+
+
+/**
+ * Reader of a WKB or EWKB geometry, which collects the location of all vertices.
+ * Both the ISO (type + 1000, 2000 or 3000) and the EWKB (flags in high bits) conventions
+ * for the z and m dimensions are recognized.
+ */
+struct WKBReader {
+    const uint8_t *data;            // The WKB bytes.
+    size_t         end;             // Index after the last byte of the geometry.
+    size_t         sridPosition;    // Index of the SRID of the top-level geometry, or 0 if none.
+    bool           sridSwap;        // Whether the bytes of the SRID are not in native order.
+    std::vector<WKBRun> runs;       // Sequences of vertices found in the geometry.
+
+    /**
+     * Reads a 32 bits unsigned integer at the given position, which is advanced.
+     *
+     * @param  position  Index of the integer to read. Updated to the index after the integer.
+     * @param  swap      Whether the bytes order is not the native order.
+     * @param  value     Where to store the integer.
+     * @return Whether the integer is inside the geometry.
+     */
+    bool read_uint32(size_t &position, bool swap, uint32_t &value) const {
+        if (end - position < sizeof(value)) return false;
+        std::memcpy(&value, data + position, sizeof(value));
+        if (swap) value = swap_bytes(value);
+        position += sizeof(value);
+        return true;
+    }
+
+    /**
+     * Reads a sequence of vertices and adds it to the list of runs.
+     *
+     * @param  position  Index of the first vertex. Updated to the index after the last vertex.
+     * @param  count     Number of vertices.
+     * @param  run       Template of the run to add, with dimension and byte order already set.
+     * @return Whether the vertices are inside the geometry.
+     */
+    bool read_vertices(size_t &position, uint32_t count, WKBRun run) {
+        const size_t size = static_cast<size_t>(count) * run.dimension * sizeof(double);
+        if (end - position < size) return false;
+        if (count) {
+            run.position = position;
+            run.count    = count;
+            runs.push_back(run);
+        }
+        position += size;
+        return true;
+    }
+
+    /**
+     * Reads a geometry and all its components, recursively.
+     *
+     * @param  position  Index of the byte order of the geometry. Updated to the index after the geometry.
+     * @param  depth     Nesting depth of the geometry, 0 for the top-level geometry.
+     * @return Whether the geometry is well formed.
+     */
+    bool read_geometry(size_t &position, int depth) {
+        if (position >= end || depth > 32) return false;
+        const uint8_t order = data[position++];
+        if (order > 1) return false;
+        WKBRun run;
+        run.swap = (order != (host_is_little_endian() ? 1 : 0));
+        uint32_t type;
+        if (!read_uint32(position, run.swap, type)) return false;
+        bool hasZ = (type & EWKB_Z_FLAG) != 0;
+        bool hasM = (type & EWKB_M_FLAG) != 0;
+        if (type & EWKB_SRID_FLAG) {
+            if (depth == 0) {
+                sridPosition = position;
+                sridSwap     = run.swap;
+            }
+            uint32_t srid;
+            if (!read_uint32(position, run.swap, srid)) return false;
+        }
+        type &= 0x0FFFFFFF;
+        switch (type / 1000) {
+            case 0: break;
+            case 1: hasZ = true; break;
+            case 2: hasM = true; break;
+            case 3: hasZ = hasM = true; break;
+            default: return false;
+        }
+        type %= 1000;
+        run.hasZ      = hasZ;
+        run.dimension = 2 + hasZ + hasM;
+        uint32_t count;
+        switch (type) {
+            case 1: {                                           // Point
+                return read_vertices(position, 1, run);
+            }
+            case 2:                                             // LineString
+            case 8: {                                           // CircularString
+                return read_uint32(position, run.swap, count) && read_vertices(position, count, run);
+            }
+            case 3:                                             // Polygon
+            case 17: {                                          // Triangle
+                if (!read_uint32(position, run.swap, count)) return false;
+                for (uint32_t i=0; i<count; i++) {
+                    uint32_t n;
+                    if (!read_uint32(position, run.swap, n) || !read_vertices(position, n, run)) return false;
+                }
+                return true;
+            }
+            case 4: case 5: case 6: case 7:                     // Multi-geometries and GeometryCollection
+            case 9: case 10: case 11: case 12:                  // Curves and surfaces made of other geometries
+            case 15: case 16: {                                 // PolyhedralSurface and TIN
+                if (!read_uint32(position, run.swap, count)) return false;
+                for (uint32_t i=0; i<count; i++) {
+                    if (!read_geometry(position, depth + 1)) return false;
+                }
+                return true;
+            }
+            default: return false;
+        }
+    }
+
+    /**
+     * Returns whether this machine stores numbers in little-endian order, which is WKB order 1.
+     *
+     * @return Whether the native byte order is little-endian.
+     */
+    static bool host_is_little_endian() {
+        const uint16_t one = 1;
+        uint8_t first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+};
+
+
+/**
+ * Reads a double value at the given address, swapping the bytes if requested.
+ *
+ * @param  address  Address of the value in the WKB bytes.
+ * @param  swap     Whether the bytes order is not the native order.
+ * @return The value read.
+ */
+inline double get_wkb_double(const uint8_t *address, bool swap) {
+    uint8_t bytes[sizeof(double)];
+    std::memcpy(bytes, address, sizeof(double));
+    if (swap) std::reverse(bytes, bytes + sizeof(double));
+    double value;
+    std::memcpy(&value, bytes, sizeof(double));
+    return value;
+}
+
+/**
+ * Writes a double value at the given address, swapping the bytes if requested.
+ *
+ * @param  address  Address of the value in the WKB bytes.
+ * @param  swap     Whether the bytes order is not the native order.
+ * @param  value    The value to write.
+ */
+inline void put_wkb_double(uint8_t *address, bool swap, double value) {
+    uint8_t bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(double));
+    if (swap) std::reverse(bytes, bytes + sizeof(double));
+    std::memcpy(address, bytes, sizeof(double));
+}
+
+
+/**
+ * Transforms in-place all vertices of a WKB geometry and updates its SRID if present.
+ * The vertices are gathered in a buffer of (x,y,z) tuples, transformed in a single call
+ * to PROJ, then written back. Empty points (encoded with NaN coordinates) are left unchanged.
+ *
+ * @param  pj      The PJ to use.
+ * @param  reader  The reader which has parsed the geometry.
+ * @param  bytes   The WKB bytes to modify in-place.
+ * @param  srid    The new SRID, or a negative value for leaving the SRID unchanged.
+ * @param  buffer  Temporary storage, resized as needed.
+ * @return The PROJ error code, or 0 if none.
+ */
+int transform_wkb(PJ *pj, PJ_DIRECTION direction, const WKBReader &reader, uint8_t *bytes, jint srid, std::vector<double> &buffer) {
+    size_t count = 0;
+    for (const WKBRun &run : reader.runs) {
+        count += run.count;
+    }
+    buffer.resize(count * 3);
+    double *tuple = buffer.data();
+    for (const WKBRun &run : reader.runs) {
+        const uint8_t *vertex = bytes + run.position;
+        for (uint32_t i=0; i < run.count; i++) {
+            tuple[0] = get_wkb_double(vertex, run.swap);
+            tuple[1] = get_wkb_double(vertex + sizeof(double), run.swap);
+            tuple[2] = run.hasZ ? get_wkb_double(vertex + 2*sizeof(double), run.swap) : 0;
+            vertex += run.dimension * sizeof(double);
+            tuple  += 3;
+        }
+    }
+    int error = 0;
+    if (count == 1 && std::isnan(buffer[0]) && std::isnan(buffer[1])) {
+        return 0;                                               // POINT EMPTY.
+    }
+    if (count) {
+        const size_t stride = 3 * sizeof(double);
+        proj_trans_generic(pj, direction,
+                buffer.data(),     stride, count,
+                buffer.data() + 1, stride, count,
+                buffer.data() + 2, stride, count,
+                nullptr, 0, 0);
+        error = proj_errno(pj);
+        if (error) {
+            proj_errno_reset(pj);
+        }
+    }
+    tuple = buffer.data();
+    for (const WKBRun &run : reader.runs) {
+        uint8_t *vertex = bytes + run.position;
+        for (uint32_t i=0; i < run.count; i++) {
+            put_wkb_double(vertex, run.swap, tuple[0]);
+            put_wkb_double(vertex + sizeof(double), run.swap, tuple[1]);
+            if (run.hasZ) {
+                put_wkb_double(vertex + 2*sizeof(double), run.swap, tuple[2]);
+            }
+            vertex += run.dimension * sizeof(double);
+            tuple  += 3;
+        }
+    }
+    if (srid >= 0 && reader.sridPosition) {
+        uint32_t value = static_cast<uint32_t>(srid);
+        if (reader.sridSwap) value = swap_bytes(value);
+        std::memcpy(bytes + reader.sridPosition, &value, sizeof(value));
+    }
+    return error;
+}
+
+
+/**
+ * Transforms a batch of WKB or EWKB geometries stored in a Java array of bytes. The geometry `i`
+ * is stored in the bytes from `offsets[i]` inclusive to `offsets[i+1]` exclusive. The transformed
+ * geometries are written in the target array at the same offsets, with the same encoding (byte order,
+ * dimensions and presence of SRID). The target array can be the source array. Bytes that are not in
+ * a geometry range are not copied. The geometries are processed in chunks of about `WKB_CHUNK_SIZE`
+ * bytes.
+ *
+ * If `failures` is non-null, then the elements of that array are set to whether the corresponding
+ * geometry has a vertex that could not be transformed, and no exception is thrown for such failures.
+ * Otherwise, the processing continues for the remaining geometries and an exception is thrown at the end.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Java object wrapping the PJ to use.
+ * @param  source     The Java array of source WKB geometries.
+ * @param  target     The Java array where to write the transformed geometries.
+ * @param  offsets    Index of the first byte of each geometry, followed by the index after the last geometry.
+ * @param  count      Number of geometries.
+ * @param  srid       The SRID to write in EWKB geometries, or a negative value for leaving the SRID unchanged.
+ * @param  failures   Where to store whether each geometry failed, or null for throwing an exception instead.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformWKB
+    (JNIEnv *env, jobject transform, jbyteArray source, jbyteArray target, jintArray offsets, jint count, jint srid, jbooleanArray failures)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (pj) {
+        const PJ_DIRECTION direction = get_direction(env, transform);
+        try {
+            std::vector<jint> bounds(static_cast<size_t>(count) + 1);
+            env->GetIntArrayRegion(offsets, 0, count + 1, bounds.data());
+            if (env->ExceptionCheck()) return;
+            std::vector<uint8_t>  bytes;
+            std::vector<jboolean> failed;
+            std::vector<double>   buffer;
+            WKBReader reader;
+            int error = 0;
+            jint first = 0;
+            for (jint i=0; i<count; i++) {
+                if (bounds[i+1] < bounds[i]) {
+                    jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                    if (c) env->ThrowNew(c, "Offsets of WKB geometries are not in increasing order.");
+                    return;
+                }
+            }
+            while (first < count) {
+                // Take as many geometries as possible in a chunk of about WKB_CHUNK_SIZE bytes, but at least one.
+                jint last = first + 1;
+                while (last < count && static_cast<size_t>(bounds[last + 1] - bounds[first]) <= WKB_CHUNK_SIZE) {
+                    last++;
+                }
+                const jint start = bounds[first];
+                const jint size  = bounds[last] - start;
+                bytes.resize(size);
+                env->GetByteArrayRegion(source, start, size, reinterpret_cast<jbyte*>(bytes.data()));
+                if (env->ExceptionCheck()) return;
+                failed.assign(last - first, JNI_FALSE);
+                for (jint i=first; i<last; i++) {
+                    reader.data         = bytes.data() + (bounds[i] - start);
+                    reader.end          = bounds[i+1] - bounds[i];
+                    reader.sridPosition = 0;
+                    reader.sridSwap     = false;
+                    reader.runs.clear();
+                    size_t position = 0;
+                    if (!reader.read_geometry(position, 0) || position != reader.end) {
+                        const std::string message = "Malformed WKB geometry at index " + std::to_string(i) + '.';
+                        jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                        if (c) env->ThrowNew(c, message.c_str());
+                        return;
+                    }
+                    const int err = transform_wkb(pj, direction, reader, bytes.data() + (bounds[i] - start), srid, buffer);
+                    if (err) {
+                        failed[i - first] = JNI_TRUE;
+                        if (!error) error = err;
+                    }
+                }
+                env->SetByteArrayRegion(target, start, size, reinterpret_cast<jbyte*>(bytes.data()));
+                if (failures) {
+                    env->SetBooleanArrayRegion(failures, first, last - first, failed.data());
+                }
+                if (env->ExceptionCheck()) return;
+                first = last;
+            }
+            if (error && !failures) {
+                jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+                if (c) env->ThrowNew(c, proj_errno_string(error));
+            }
+        } catch (const std::exception &e) {
+            rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+        }
+    }
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                         CLASS Transform (packed coordinate arrays)                         │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Packed coordinate arrays">
+
+
+/**
+ * Copies the (x,y,z) values of all tuples of a packed `float` array into the given buffer.
+ * The Java array may contain more dimensions (for example measures), which are ignored.
+ * A missing or NaN z value is replaced by 0.
+ *
+ * @param  values     The raw array elements.
+ * @param  count      Number of tuples.
+ * @param  dimension  Number of values per tuple in the Java array.
+ * @param  hasZ       Whether the third value of each tuple is the z coordinate.
+ * @param  tuple      Where to write the (x,y,z) tuples.
+ */
+void gather_packed(const jfloat *values, size_t count, int dimension, bool hasZ, double *tuple) {
+    for (size_t i=0; i<count; i++) {
+        tuple[0] = values[0];
+        tuple[1] = values[1];
+        tuple[2] = (hasZ && !std::isnan(values[2])) ? values[2] : 0;
+        values += dimension;
+        tuple  += 3;
+    }
+}
+
+
+/**
+ * Copies the given (x,y,z) tuples in a packed `float` array. Values of other dimensions are left unchanged.
+ * The z values which were NaN are also left unchanged, since they were not given to PROJ.
+ *
+ * @param  tuple      The (x,y,z) tuples to write.
+ * @param  count      Number of tuples.
+ * @param  dimension  Number of values per tuple in the Java array.
+ * @param  hasZ       Whether the third value of each tuple is the z coordinate.
+ * @param  values     The raw array elements to update.
+ */
+void scatter_packed(const double *tuple, size_t count, int dimension, bool hasZ, jfloat *values) {
+    for (size_t i=0; i<count; i++) {
+        values[0] = static_cast<jfloat>(tuple[0]);
+        values[1] = static_cast<jfloat>(tuple[1]);
+        if (hasZ && !std::isnan(values[2])) {
+            values[2] = static_cast<jfloat>(tuple[2]);
+        }
+        values += dimension;
+        tuple  += 3;
+    }
+}
+
+
+/**
+ * Transforms in-place the (x,y,z) values of packed tuples of `double` values. The values are given
+ * directly to PROJ with a stride, without copy. NaN z values are replaced by 0 before the transform
+ * and restored after it; their indices are stored in the `nanZ` vector, which is reused between calls.
+ *
+ * @param  pj         The PJ to use.
+ * @param  direction  `PJ_FWD` or `PJ_INV`.
+ * @param  values     The raw array elements to transform in-place.
+ * @param  count      Number of tuples.
+ * @param  dimension  Number of values per tuple in the Java array.
+ * @param  hasZ       Whether the third value of each tuple is the z coordinate.
+ * @param  nanZ       Temporary storage for the indices of NaN z values.
+ */
+void transform_packed(PJ *pj, PJ_DIRECTION direction, jdouble *values, size_t count, int dimension, bool hasZ,
+                      std::vector<size_t> &nanZ)
+{
+    nanZ.clear();
+    if (hasZ) {
+        for (size_t i=0; i<count; i++) {
+            jdouble &z = values[i*dimension + 2];
+            if (std::isnan(z)) {
+                nanZ.push_back(i);
+                z = 0;
+            }
+        }
+    }
+    const size_t stride = sizeof(jdouble) * dimension;
+    proj_trans_generic(pj, direction,
+            values,     stride, count,
+            values + 1, stride, count,
+            hasZ ? values + 2 : nullptr, stride, hasZ ? count : 0,
+            nullptr, 0, 0);
+    for (const size_t i : nanZ) {
+        values[i*dimension + 2] = std::numeric_limits<jdouble>::quiet_NaN();
+    }
+}
+
+
+/**
+ * Transforms in-place the coordinate tuples stored in many Java arrays of double or float values.
+ * Each array contains tuples of `dimension` values where the two first values are (x,y), optionally
+ * followed by z, then by measures which are left unchanged. The `layouts` array contains three values
+ * per Java array: the type (DOUBLE or FLOAT constant), the number of values per tuple, and 1 if the
+ * third value is z or 0 otherwise.
+ *
+ * Arrays of `double` values are transformed in place inside a critical region, without copy.
+ * Arrays of `float` values can not be given to PROJ directly, so their tuples are copied in a
+ * temporary buffer of (x,y,z) `double` values, transformed, then written back.
+ *
+ * @param  env        The JNI environment.
+ * @param  transform  The Java object wrapping the PJ to use.
+ * @param  arrays     The Java arrays of coordinates to transform in-place.
+ * @param  layouts    Type, dimension and z flag of each array.
+ * @param  count      Number of arrays.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformPacked
+    (JNIEnv *env, jobject transform, jobjectArray arrays, jintArray layouts, jint count)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (pj) {
+        try {
+            std::vector<jint> layout(static_cast<size_t>(count) * 3);
+            env->GetIntArrayRegion(layouts, 0, count * 3, layout.data());
+            if (env->ExceptionCheck()) return;
+            const PJ_DIRECTION direction = get_direction(env, transform);
+            std::vector<double> buffer;
+            std::vector<jfloat> staging;
+            std::vector<size_t> nanZ;
+            int error = 0;
+            for (jint i=0; i<count; i++) {
+                const int  dimension = layout[i*3 + 1];
+                const bool hasZ      = layout[i*3 + 2] != 0;
+                if (dimension < (hasZ ? 3 : 2)) {
+                    jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                    if (c) env->ThrowNew(c, "Illegal number of dimensions.");
+                    return;
+                }
+                jarray array = static_cast<jarray>(env->GetObjectArrayElement(arrays, i));
+                if (!array) return;                 // Should not happen because verified by Java code.
+                const jsize  length = env->GetArrayLength(array);
+                const size_t n      = length / dimension;
+                switch (layout[i*3]) {
+                    case org_osgeo_proj_Transform_DOUBLE: {
+                        if (hasZ) nanZ.reserve(n);  // For avoiding allocation in the critical region.
+                        jdouble *values = static_cast<jdouble*>(env->GetPrimitiveArrayCritical(array, nullptr));
+                        if (!values) return;        // OutOfMemoryError already thrown.
+                        transform_packed(pj, direction, values, n, dimension, hasZ, nanZ);
+                        env->ReleasePrimitiveArrayCritical(array, values, 0);
+                        break;
+                    }
+                    case org_osgeo_proj_Transform_FLOAT: {
+                        staging.resize(length);
+                        buffer.resize(n * 3);
+                        env->GetFloatArrayRegion(static_cast<jfloatArray>(array), 0, length, staging.data());
+                        if (env->ExceptionCheck()) return;
+                        gather_packed(staging.data(), n, dimension, hasZ, buffer.data());
+                        const size_t stride = 3 * sizeof(double);
+                        proj_trans_generic(pj, direction,
+                                buffer.data(),     stride, n,
+                                buffer.data() + 1, stride, n,
+                                buffer.data() + 2, stride, n,
+                                nullptr, 0, 0);
+                        scatter_packed(buffer.data(), n, dimension, hasZ, staging.data());
+                        env->SetFloatArrayRegion(static_cast<jfloatArray>(array), 0, length, staging.data());
+                        break;
+                    }
+                    default: {
+                        jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                        if (c) env->ThrowNew(c, "Unsupported array type.");
+                        return;
+                    }
+                }
+                env->DeleteLocalRef(array);
+                if (env->ExceptionCheck()) return;
+                const int err = proj_errno(pj);
+                if (err) {
+                    proj_errno_reset(pj);
+                    if (!error) error = err;
+                }
+            }
+            if (error) {
+                jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+                if (c) env->ThrowNew(c, proj_errno_string(error));
+            }
+        } catch (const std::exception &e) {
+            rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+        }
+    }
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                             CLASS Transform (text coordinates)                             │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Text coordinates">
+
+
+/**
+ * Switches the current thread to the "C" locale for numbers until this object goes out of scope.
+ * The `strtod` and `snprintf` functions used for text coordinates depend on the LC_NUMERIC category,
+ * which may have been changed by the application (for example to a locale using ',' as the decimal
+ * separator). Only the calling thread is affected, so other threads of the JVM are not disturbed.
+ */
+struct NumericLocale {
+#ifdef _MSC_VER
+    int previousMode;           // Previous value of `_configthreadlocale`.
+    std::string previous;       // Previous LC_NUMERIC locale of the current thread.
+
+    NumericLocale() {
+        previousMode = _configthreadlocale(_ENABLE_PER_THREAD_LOCALE);
+        const char *name = std::setlocale(LC_NUMERIC, nullptr);
+        previous = name ? name : "C";
+        std::setlocale(LC_NUMERIC, "C");
+    }
+
+    ~NumericLocale() {
+        std::setlocale(LC_NUMERIC, previous.c_str());
+        _configthreadlocale(previousMode);
+    }
+#else
+    locale_t previous;          // Previous locale of the current thread, or null if it could not be changed.
+
+    NumericLocale() {
+        static const locale_t C = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+        previous = C ? uselocale(C) : static_cast<locale_t>(0);
+    }
+
+    ~NumericLocale() {
+        if (previous) uselocale(previous);
+    }
+#endif
+};
+
+
+/**
+ * Powers of 10 which are exactly representable as double-precision values.
+ */
+const double EXACT_POWERS_OF_10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/**
+ * Returns whether the given characters are equal to the given lower-case ASCII word, ignoring case.
+ *
+ * @param  start  Pointer to the first character to compare.
+ * @param  end    Pointer after the last character to compare.
+ * @param  word   The null-terminated word in lower case.
+ * @return Whether the characters are equal to the word, ignoring case.
+ */
+bool equals_ignore_case(const char *start, const char *end, const char *word) {
+    for (; start < end; start++, word++) {
+        if (!*word || (*start | 0x20) != *word) return false;
+    }
+    return !*word;
+}
+
+
+/**
+ * Parses the decimal number in the given characters. The fast path handles numbers with at most
+ * 19 significant digits whose value can be computed by a single multiplication or division of two
+ * exactly representable values, which gives a correctly rounded result. This covers nearly all
+ * coordinates found in text files. Other numbers (including "NaN" and "Infinity") are given to
+ * `strtod`, which is slower but also correctly rounded. The caller shall have switched the current
+ * thread to the "C" locale with `NumericLocale`, otherwise `strtod` may expect another separator.
+ *
+ * The accepted grammar is an optional sign followed by either decimal digits with an optional
+ * fraction and exponent, or "NaN", "Inf" or "Infinity" in any case. Other forms accepted by
+ * `strtod`, such as hexadecimal numbers or "NaN(…)", are rejected before calling `strtod`.
+ *
+ * @param  start  Pointer to the first character of the number.
+ * @param  end    Pointer after the last character of the number.
+ * @param  value  Where to store the parsed value.
+ * @return Whether all characters have been parsed as a number.
+ */
+bool parse_text_double(const char *start, const char *end, double &value) {
+    const char *p = start;
+    const bool negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    const char *const body = p;
+    uint64_t mantissa = 0;
+    int  digits   = 0;
+    int  exponent = 0;
+    bool any      = false;
+    bool fast     = true;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) digits++;
+        } else {
+            fast = false;
+        }
+        any = true;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) digits++;
+                exponent--;
+            } else {
+                fast = false;
+            }
+            any = true;
+            p++;
+        }
+    }
+    if (any && p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        const bool negexp = (p < end && *p == '-');
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        int e = 0;
+        bool hasExp = false;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (e < 10000) e = e * 10 + (*p - '0');
+            hasExp = true;
+            p++;
+        }
+        if (!hasExp) any = false;
+        exponent += negexp ? -e : e;
+    }
+    if (any && p == end && fast && mantissa <= (UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22) {
+        value = static_cast<double>(mantissa);
+        if (exponent < 0) value /= EXACT_POWERS_OF_10[-exponent];
+        else              value *= EXACT_POWERS_OF_10[ exponent];
+        if (negative) value = -value;
+        return true;
+    }
+    if (!(any && p == end) && !equals_ignore_case(body, end, "nan")
+            && !equals_ignore_case(body, end, "inf") && !equals_ignore_case(body, end, "infinity"))
+    {
+        return false;
+    }
+    // Slow path: copy in a null-terminated buffer for `strtod`.
+    char buffer[64];
+    const size_t length = end - start;
+    if (length == 0 || length >= sizeof(buffer)) return false;
+    std::memcpy(buffer, start, length);
+    buffer[length] = 0;
+    char *stop;
+    value = std::strtod(buffer, &stop);
+    return stop == buffer + length;
+}
+
+
+/**
+ * Adds one unit in the last place of the given decimal digits. Returns false if all digits were 9,
+ * in which case the result would need one more digit and the digits are left unchanged.
+ *
+ * @param  digits  The decimal digits as ASCII characters.
+ * @param  count   Number of digits.
+ * @return Whether the digits have been incremented.
+ */
+bool increment_digits(char *digits, int count) {
+    for (int i = count; --i >= 0;) {
+        if (digits[i] != '9') {
+            digits[i]++;
+            for (int j = i+1; j < count; j++) digits[j] = '0';
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Returns whether the decimal number d₀.d₁d₂… × 10^exponent is parsed back to the given value.
+ *
+ * @param  digits    The decimal digits as ASCII characters.
+ * @param  count     Number of digits.
+ * @param  exponent  Power of 10 of the first digit.
+ * @param  value     The expected value, positive.
+ * @return Whether the decimal number is parsed to `value`.
+ */
+bool round_trips(const char *digits, int count, int exponent, double value) {
+    char text[32];
+    std::memcpy(text, digits, count);
+    const int n = count + std::snprintf(text + count, sizeof(text) - count, "e%d", exponent - (count - 1));
+    double parsed;
+    return parse_text_double(text, text + n, parsed) && parsed == value;
+}
+
+
+/**
+ * Formats the given value with the smallest number of significant digits which is parsed back to the same
+ * double-precision value. For each number of digits from 15 to 17, the decimal number given by `snprintf`
+ * is the closest one to the value. Any decimal number of 15 digits or less is parsed back to the same
+ * decimal number after a round trip through a double, so if such a representation exists, `snprintf`
+ * finds it with 15 digits and trailing zeros are removed. With 16 digits, the closest decimal number may
+ * be just outside the rounding interval of a power of 2, which is narrower below the value than above.
+ * In that case the next decimal number above is also tried. Subnormal numbers have less precision, so all
+ * numbers of digits are tried for them. The digits are then written in fixed-point
+ * notation, or in scientific notation for very small or large magnitudes, always with '.' as the separator.
+ *
+ * @param  value     The value to format. Shall be finite.
+ * @param  buffer    Where to write the characters.
+ * @param  capacity  Size of the buffer.
+ * @return Number of characters written, or 0 if the buffer is too small.
+ */
+int format_shortest(double value, char *buffer, size_t capacity) {
+    const double magnitude = std::fabs(value);
+    char digits[24];
+    int  count = 0, exponent = 0;
+    const int first = (magnitude < std::numeric_limits<double>::min()) ? 1 : 15;   // Subnormal numbers have less digits.
+    for (int precision = first; ; precision++) {
+        char text[40];
+        const int n = std::snprintf(text, sizeof(text), "%.*e", precision - 1, magnitude);
+        const char *e = std::strchr(text, 'e');
+        if (n <= 0 || !e) return 0;
+        count = 0;
+        for (const char *p = text; p < e; p++) {
+            if (*p >= '0' && *p <= '9') digits[count++] = *p;     // Skip the decimal separator.
+        }
+        exponent = std::atoi(e + 1);
+        if (precision == 17 || round_trips(digits, count, exponent, magnitude)) break;
+        if (increment_digits(digits, count) && round_trips(digits, count, exponent, magnitude)) break;
+    }
+    while (count > 1 && digits[count - 1] == '0') count--;
+    std::string text;
+    if (std::signbit(value)) text += '-';
+    if (exponent < -4 || exponent >= 17) {
+        text += digits[0];
+        if (count > 1) {
+            text += '.';
+            text.append(digits + 1, count - 1);
+        }
+        text += 'e';
+        text += std::to_string(exponent);
+    } else if (exponent < 0) {
+        text += "0.";
+        text.append(-exponent - 1, '0');
+        text.append(digits, count);
+    } else {
+        const int integers = exponent + 1;
+        text.append(digits, std::min(count, integers));
+        if (count > integers) {
+            text += '.';
+            text.append(digits + integers, count - integers);
+        } else {
+            text.append(integers - count, '0');
+        }
+    }
+    if (text.size() >= capacity) return 0;
+    std::memcpy(buffer, text.data(), text.size());
+    return static_cast<int>(text.size());
+}
+
+
+/**
+ * Formats the given value in the given buffer. If `fractionDigits` is negative, the value is formatted
+ * with the smallest number of significant digits which is parsed back to the same double-precision value.
+ * Otherwise the value is formatted with the given number of fraction digits. Non-finite values, which are
+ * PROJ failures, are formatted as "NaN". The caller shall have switched the current thread to the "C"
+ * locale with `NumericLocale`, otherwise `snprintf` and `strtod` may use another decimal separator.
+ *
+ * @param  value           The value to format.
+ * @param  fractionDigits  Number of fraction digits, or a negative value for shortest round-trip.
+ * @param  buffer          Where to write the characters.
+ * @param  capacity        Size of the buffer.
+ * @return Number of characters written.
+ */
+int format_text_double(double value, int fractionDigits, char *buffer, size_t capacity) {
+    if (!std::isfinite(value)) {
+        std::memcpy(buffer, "NaN", 3);
+        return 3;
+    }
+    if (fractionDigits < 0) {
+        return format_shortest(value, buffer, capacity);
+    }
+    const int length = std::snprintf(buffer, capacity, "%.*f", fractionDigits, value);
+    return (length > 0 && static_cast<size_t>(length) < capacity) ? length : 0;
+}
+
+
+/**
+ * Range of characters of a line of text, with the ranges of the coordinate values in that line.
+ * All positions are relative to the beginning of the chunk of text being processed.
+ */
+struct TextLine {
+    size_t start;               // Index of the first character of the line.
+    size_t end;                 // Index after the line separator, or after the last character if none.
+    size_t fieldStart[3];       // Index of the first character of each coordinate value.
+    size_t fieldEnd  [3];       // Index after the last character of each coordinate value.
+    bool   hasTuple;            // Whether this line contains a coordinate tuple (false for comments).
+};
+
+
+/**
+ * A transform of coordinates stored as text, one tuple per line, with values separated by a delimiter.
+ * The text is processed by chunks of complete lines: all lines of a chunk are parsed, then the tuples
+ * of the chunk are transformed by a single call to PROJ, then the lines are written with the new values.
+ * Characters other than the coordinate values are copied unchanged, including line separators.
+ * Empty lines and lines starting with '#' are copied unchanged.
+ */
+struct TextTransform {
+    PJ   *pj;                   // The PJ to use.
+    PJ_DIRECTION direction;     // PJ_FWD or PJ_INV.
+    int   columns[3];           // Index of the column of each coordinate value.
+    int   dimension;            // Number of coordinate values per line (2 or 3).
+    char  delimiter;            // Column delimiter, or 0 for sequences of spaces and tabulations.
+    int   fractionDigits;       // Number of fraction digits, or negative for shortest round-trip.
+    jlong headerLines;          // Number of lines to copy unchanged at the beginning of the text.
+    jlong lineNumber;           // Number of lines parsed so far, for header detection and error messages.
+    jlong points;               // Number of coordinate tuples transformed so far.
+    int   error;                // The PROJ error of the last call to `transform()`, or 0 if none.
+    std::vector<TextLine> lines;
+    std::vector<double>   tuples;
+
+    /*
+     * Finds the range of the given column in the given line, without leading or trailing spaces.
+     * Returns false if the line does not have enough columns.
+     */
+    bool find_field(const char *data, size_t start, size_t end, int column, size_t &fs, size_t &fe) const {
+        size_t p = start;
+        if (delimiter) {
+            for (int i=0; i<column; i++) {
+                const void *d = std::memchr(data + p, delimiter, end - p);
+                if (!d) return false;
+                p = static_cast<const char*>(d) - data + 1;
+            }
+            const void *d = std::memchr(data + p, delimiter, end - p);
+            fe = d ? static_cast<size_t>(static_cast<const char*>(d) - data) : end;
+            while (p < fe && (data[p] == ' ' || data[p] == '\t')) p++;
+            while (fe > p && (data[fe-1] == ' ' || data[fe-1] == '\t')) fe--;
+        } else {
+            for (int i=0; ; i++) {
+                while (p < end && (data[p] == ' ' || data[p] == '\t')) p++;
+                if (p >= end) return false;
+                size_t q = p;
+                while (q < end && data[q] != ' ' && data[q] != '\t') q++;
+                if (i == column) {
+                    fe = q;
+                    break;
+                }
+                p = q;
+            }
+        }
+        fs = p;
+        return true;
+    }
+
+    /*
+     * Parses all complete lines in the given text. If `endOfInput` is false, the characters after the
+     * last line separator are ignored. Returns the number of characters parsed, or -1 if a line
+     * can not be parsed. In the latter case, a Java exception is thrown.
+     */
+    ptrdiff_t parse(JNIEnv *env, const char *data, size_t length, bool endOfInput) {
+        lines.clear();
+        tuples.clear();
+        size_t start = 0;
+        while (start < length) {
+            const void *nl = std::memchr(data + start, '\n', length - start);
+            size_t end = nl ? static_cast<const char*>(nl) - data + 1 : length;
+            if (!nl && !endOfInput) break;
+            size_t content = end;
+            while (content > start && (data[content-1] == '\n' || data[content-1] == '\r')) content--;
+            TextLine line;
+            line.start    = start;
+            line.end      = end;
+            line.hasTuple = false;
+            if (lineNumber >= headerLines) {
+                size_t p = start;
+                while (p < content && (data[p] == ' ' || data[p] == '\t')) p++;
+                if (p < content && data[p] != '#') {
+                    double values[3] = {0, 0, 0};
+                    for (int i=0; i<dimension; i++) {
+                        if (!find_field(data, start, content, columns[i], line.fieldStart[i], line.fieldEnd[i]) ||
+                            !parse_text_double(data + line.fieldStart[i], data + line.fieldEnd[i], values[i]))
+                        {
+                            const std::string message = "Can not parse coordinate in column " + std::to_string(columns[i])
+                                    + " of line " + std::to_string(lineNumber + 1) + '.';
+                            jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+                            if (c) env->ThrowNew(c, message.c_str());
+                            return -1;
+                        }
+                    }
+                    tuples.insert(tuples.end(), values, values + 3);
+                    line.hasTuple = true;
+                }
+            }
+            lines.push_back(line);
+            lineNumber++;
+            start = end;
+        }
+        return static_cast<ptrdiff_t>(start);
+    }
+
+    /*
+     * Transforms all tuples parsed by the last call to `parse`. Failed tuples are set to HUGE_VAL
+     * by PROJ. The error code is kept in `error`, but whether to report it depends on whether a
+     * failed tuple is in a line which is written.
+     */
+    void transform() {
+        error = 0;
+        const size_t count = tuples.size() / 3;
+        if (count) {
+            const size_t stride = 3 * sizeof(double);
+            proj_trans_generic(pj, direction,
+                    tuples.data(),     stride, count,
+                    tuples.data() + 1, stride, count,
+                    tuples.data() + 2, stride, count,
+                    nullptr, 0, 0);
+            error = proj_errno(pj);
+            if (error) proj_errno_reset(pj);
+            points += count;
+        }
+    }
+
+    /*
+     * Writes the lines parsed by the last call to `parse`, with the transformed coordinate values.
+     * Stops before the first line which would cause `out` to exceed the given capacity, and stores
+     * the length of that line in `overflow` (0 if all lines have been written). Returns the number
+     * of source characters consumed (the end of the last line written).
+     */
+    size_t emit(const char *data, std::vector<char> &out, size_t capacity, size_t &overflow) const {
+        const double *tuple = tuples.data();
+        overflow = 0;
+        char number[400];
+        size_t consumed = 0;
+        for (const TextLine &line : lines) {
+            const size_t mark = out.size();
+            if (line.hasTuple) {
+                int order[3] = {0, 1, 2};
+                std::sort(order, order + dimension, [&line](int a, int b) {
+                    return line.fieldStart[a] < line.fieldStart[b];
+                });
+                size_t p = line.start;
+                for (int k=0; k<dimension; k++) {
+                    const int i = order[k];
+                    out.insert(out.end(), data + p, data + line.fieldStart[i]);
+                    const int n = format_text_double(tuple[i], fractionDigits, number, sizeof(number));
+                    out.insert(out.end(), number, number + n);
+                    p = line.fieldEnd[i];
+                }
+                out.insert(out.end(), data + p, data + line.end);
+                tuple += 3;
+            } else {
+                out.insert(out.end(), data + line.start, data + line.end);
+            }
+            if (out.size() > capacity) {
+                overflow = out.size() - mark;
+                out.resize(mark);
+                break;
+            }
+            consumed = line.end;
+        }
+        return consumed;
+    }
+};
+
+
+/**
+ * Initializes a text transform from the arguments given by Java code.
+ *
+ * @param  env             The JNI environment.
+ * @param  tr              The text transform to initialize.
+ * @param  pj              The PJ to use.
+ * @param  direction       `PJ_FWD` or `PJ_INV`.
+ * @param  columns         Java array of 2 or 3 column indices.
+ * @param  delimiter       The column delimiter, or 0 for sequences of spaces and tabulations.
+ * @param  fractionDigits  Number of fraction digits, or a negative value for shortest round-trip.
+ * @return Whether the initialization succeeded. If false, a Java exception is pending.
+ */
+bool init_text_transform(JNIEnv *env, TextTransform &tr, PJ *pj, PJ_DIRECTION direction, jintArray columns, jint delimiter, jint fractionDigits) {
+    tr.pj             = pj;
+    tr.direction      = direction;
+    tr.dimension      = env->GetArrayLength(columns);
+    tr.delimiter      = static_cast<char>(delimiter);
+    tr.fractionDigits = std::min(fractionDigits, 17);
+    tr.headerLines    = 0;
+    tr.lineNumber     = 0;
+    tr.points         = 0;
+    tr.error          = 0;
+    if (tr.dimension < 2 || tr.dimension > 3 || delimiter == '\n' || delimiter == '\r' || delimiter < 0 || delimiter > 127) {
+        jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+        if (c) env->ThrowNew(c, "Illegal text format.");
+        return false;
+    }
+    env->GetIntArrayRegion(columns, 0, tr.dimension, tr.columns);
+    if (env->ExceptionCheck()) return false;
+    for (int i=0; i<tr.dimension; i++) {
+        bool valid = tr.columns[i] >= 0;
+        for (int j=0; j<i; j++) {
+            valid &= (tr.columns[i] != tr.columns[j]);
+        }
+        if (!valid) {
+            jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+            if (c) env->ThrowNew(c, "Illegal column indices.");
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Transforms the coordinates of a text in a direct buffer and writes the result in another direct buffer.
+ * Only complete lines are processed, unless `endOfInput` is true in which case the characters after the last
+ * line separator are processed as a last line. The lines are written in the target buffer until it is full.
+ * Failed points are written as "NaN" and cause a TransformException to be thrown after the lines have been
+ * written. Failures in the lines which do not fit in the target buffer are left to the call writing them.
+ * Files are transformed by Java code, which invokes this function for each chunk of the file.
+ *
+ * On return, the `positions` array contains the position after the last source line consumed, the position
+ * after the last character written, the number of lines consumed, and the length of the first line which
+ * did not fit in the target buffer (0 if none). The latter allows the caller to provide a larger buffer.
+ *
+ * @param  env             The JNI environment.
+ * @param  transform       The Java object wrapping the PJ to use.
+ * @param  source          The direct buffer containing the text to transform.
+ * @param  srcPos          Position of the first character to transform in the source buffer.
+ * @param  srcLimit        Position after the last character to transform in the source buffer.
+ * @param  target          The direct buffer where to write the result.
+ * @param  dstPos          Position where to write the first character in the target buffer.
+ * @param  dstLimit        Position after the last character that can be written in the target buffer.
+ * @param  columns         Index of the column of each coordinate value.
+ * @param  delimiter       The column delimiter, or 0 for sequences of spaces and tabulations.
+ * @param  lineNumber      Number of lines before the source position, for header lines and error messages.
+ * @param  headerLines     Number of lines to copy unchanged at the beginning of the text.
+ * @param  fractionDigits  Number of fraction digits, or a negative value for shortest round-trip.
+ * @param  endOfInput      Whether the source buffer contains the end of the text.
+ * @param  positions       Where to store the new positions, the number of lines and the overflow.
+ * @return Number of coordinate tuples transformed and written.
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Transform_transformTextBuffer
+    (JNIEnv *env, jobject transform, jobject source, jint srcPos, jint srcLimit, jobject target, jint dstPos, jint dstLimit,
+     jintArray columns, jint delimiter, jlong lineNumber, jlong headerLines, jint fractionDigits, jboolean endOfInput,
+     jintArray positions)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (!pj) return 0;
+    TextTransform tr;
+    if (!init_text_transform(env, tr, pj, get_direction(env, transform), columns, delimiter, fractionDigits)) return 0;
+    tr.lineNumber  = lineNumber;
+    tr.headerLines = headerLines;
+    const char *src = static_cast<const char*>(env->GetDirectBufferAddress(source));
+    char       *dst = static_cast<char*>      (env->GetDirectBufferAddress(target));
+    if (!src || !dst) {
+        jclass c = env->FindClass(JPJ_ILLEGAL_ARGUMENT_EXCEPTION);
+        if (c) env->ThrowNew(c, "Not a direct buffer.");
+        return 0;
+    }
+    jlong written = 0;
+    int   error   = 0;
+    try {
+        NumericLocale locale;
+        src += srcPos;
+        const ptrdiff_t parsed = tr.parse(env, src, srcLimit - srcPos, endOfInput);
+        if (parsed < 0) return 0;
+        tr.transform();
+        std::vector<char> output;
+        size_t overflow;
+        const size_t consumed = tr.emit(src, output, dstLimit - dstPos, overflow);
+        std::memcpy(dst + dstPos, output.data(), output.size());
+        /*
+         * Count the lines written and check their tuples for failures. The lines which did not fit
+         * in the target buffer will be parsed and transformed again by the next call, so an error
+         * in those lines is not reported now.
+         */
+        jint lines = 0;
+        const double *tuple = tr.tuples.data();
+        for (const TextLine &line : tr.lines) {
+            if (line.end > consumed) break;
+            if (line.hasTuple) {
+                if (tuple[0] == HUGE_VAL) error = tr.error;
+                tuple += 3;
+                written++;
+            }
+            lines++;
+        }
+        const jint updated[] = {srcPos + static_cast<jint>(consumed), dstPos + static_cast<jint>(output.size()),
+                                lines, static_cast<jint>(std::min(overflow, static_cast<size_t>(INT32_MAX)))};
+        env->SetIntArrayRegion(positions, 0, 4, updated);
+    } catch (const std::exception &e) {
+        rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+    }
+    if (error && !env->ExceptionCheck()) {
+        jclass c = env->FindClass(JPJ_TRANSFORM_EXCEPTION);
+        if (c) env->ThrowNew(c, proj_errno_string(error));
+    }
+    return written;
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                             CLASS Transform (round-trip audit)                             │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Round-trip audit">
+
+
+/**
+ * Number of points in each chunk of the round-trip audit. The original coordinates of a chunk and
+ * the coordinates transformed forward then backward are kept in two scratch buffers of this size.
+ */
+#define AUDIT_CHUNK_SIZE 4096
+
+/**
+ * Indices in the statistics array computed by `Java_org_osgeo_proj_Transform_audit(…)`.
+ * Must be consistent with the `BatchTransform.Audit` constructor.
+ */
+#define AUDIT_FORWARD_FAILURES 0
+#define AUDIT_INVERSE_FAILURES 1
+#define AUDIT_COUNT            2
+#define AUDIT_MAXIMUM          3
+#define AUDIT_MEAN             4
+#define AUDIT_MEDIAN           5
+#define AUDIT_P95              6
+#define AUDIT_P99              7
+#define AUDIT_STATISTICS_SIZE  8
+
+
+/**
+ * Applies the given PJ in the given direction on coordinate tuples of the given dimension.
+ *
+ * @param  pj         The PJ to apply.
+ * @param  direction  PJ_FWD or PJ_INV.
+ * @param  data       The coordinates to transform in-place.
+ * @param  dimension  Number of values in each coordinate tuple.
+ * @param  n          Number of points to transform.
+ */
+void audit_trans(PJ *pj, PJ_DIRECTION direction, double *data, const jint dimension, const size_t n) {
+    const size_t stride = sizeof(double) * dimension;
+    proj_trans_generic(pj, direction,
+            data, stride, n,
+            (dimension >= 2) ? data+1 : nullptr, stride, n,
+            (dimension >= 3) ? data+2 : nullptr, stride, n,
+            (dimension >= 4) ? data+3 : nullptr, stride, n);
+    proj_errno_reset(pj);
+}
+
+
+/**
+ * Returns the value at the given percentile of the given errors, using the nearest-rank method.
+ * This function partially reorders the vector.
+ *
+ * @param  errors      The errors. Shall not be empty.
+ * @param  percentile  The percentile as a fraction between 0 and 1.
+ * @return The error at the given percentile.
+ */
+double audit_percentile(std::vector<double> &errors, const double percentile) {
+    size_t rank = static_cast<size_t>(std::ceil(percentile * errors.size()));
+    if (rank != 0) rank--;
+    std::nth_element(errors.begin(), errors.begin() + rank, errors.end());
+    return errors[rank];
+}
+
+
+/**
+ * Transforms the given points forward then backward with the same PJ, and computes statistics about
+ * the differences between the original and the round-trip coordinates. The differences are Euclidean
+ * distances in units of the source CRS, computed on all dimensions. The source array is not modified:
+ * the points are copied by chunks in scratch buffers. Failures are counted instead of being thrown.
+ *
+ * The statistics array receives the numbers of forward failures and inverse failures, the number of
+ * points that completed the round trip, then the maximal, mean, median, 95th and 99th percentile errors.
+ * The `worst` and `worstErrors` arrays receive the indices (relative to the first point) and errors of
+ * the points having the largest errors, in decreasing order of errors. Unused elements are set to -1
+ * and NaN respectively.
+ *
+ * @param  env          The JNI environment.
+ * @param  transform    The Java object wrapping the PJ to use.
+ * @param  dimension    The dimension of each coordinate tuple.
+ * @param  coordinates  The coordinates to audit, as a sequence of (x,y,z,…) tuples.
+ * @param  offset       Offset of the first coordinate in the given array.
+ * @param  numPts       Number of points to audit.
+ * @param  statistics   Where to store the counts and error statistics.
+ * @param  worst        Where to store the indices of the points having the largest errors.
+ * @param  worstErrors  Where to store the errors of the points in the `worst` array.
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_audit
+    (JNIEnv *env, jobject transform, jint dimension, jdoubleArray coordinates, jint offset, jint numPts,
+     jdoubleArray statistics, jintArray worst, jdoubleArray worstErrors)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (!pj) return;
+    if (!proj_pj_info(pj).has_inverse) {
+        jclass c = env->FindClass(JPJ_NON_INVERTIBLE_EXCEPTION);
+        if (c) env->ThrowNew(c, "The coordinate operation has no inverse.");
+        return;
+    }
+    const PJ_DIRECTION forward = get_direction(env, transform);
+    const PJ_DIRECTION inverse = (forward == PJ_FWD) ? PJ_INV : PJ_FWD;
+    const size_t worstCount = static_cast<size_t>(env->GetArrayLength(worst));
+    jdouble stats[AUDIT_STATISTICS_SIZE] = {0};
+    std::vector<jint>   worstIndices;
+    std::vector<double> worstValues;
+    try {
+        const size_t chunkLength = static_cast<size_t>(AUDIT_CHUNK_SIZE) * dimension;
+        std::vector<double> original(chunkLength);
+        std::vector<double> buffer(chunkLength);
+        std::vector<bool>   failed(AUDIT_CHUNK_SIZE);
+        std::vector<double> errors;
+        errors.reserve(numPts);
+        /*
+         * The points having the largest errors are kept in a min-heap of (error, index) pairs,
+         * so that the smallest of the retained errors can be replaced in logarithmic time.
+         */
+        typedef std::pair<double, jint> Entry;
+        std::vector<Entry> heap;
+        heap.reserve(worstCount);
+        double sum = 0;
+        for (jint start = 0; start < numPts; start += AUDIT_CHUNK_SIZE) {
+            const jint n = std::min(numPts - start, static_cast<jint>(AUDIT_CHUNK_SIZE));
+            const jint length = n * dimension;
+            env->GetDoubleArrayRegion(coordinates, offset + start * dimension, length, original.data());
+            if (env->ExceptionCheck()) return;
+            std::copy(original.begin(), original.begin() + length, buffer.begin());
+            audit_trans(pj, forward, buffer.data(), dimension, n);
+            for (jint i=0; i<n; i++) {
+                bool f = false;
+                for (jint d=0; d<dimension; d++) {
+                    f |= !std::isfinite(buffer[i*dimension + d]);
+                }
+                failed[i] = f;
+            }
+            audit_trans(pj, inverse, buffer.data(), dimension, n);
+            for (jint i=0; i<n; i++) {
+                if (failed[i]) {
+                    stats[AUDIT_FORWARD_FAILURES]++;
+                    continue;
+                }
+                double error = 0;
+                for (jint d=0; d<dimension; d++) {
+                    const double delta = buffer[i*dimension + d] - original[i*dimension + d];
+                    error += delta * delta;
+                }
+                error = std::sqrt(error);
+                if (!std::isfinite(error)) {
+                    stats[AUDIT_INVERSE_FAILURES]++;
+                    continue;
+                }
+                errors.push_back(error);
+                sum += error;
+                if (error > stats[AUDIT_MAXIMUM]) {
+                    stats[AUDIT_MAXIMUM] = error;
+                }
+                if (heap.size() < worstCount) {
+                    heap.push_back(Entry(-error, start + i));
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (worstCount != 0 && error > -heap.front().first) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = Entry(-error, start + i);
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        }
+        /*
+         * Errors are stored as negative values in the heap for making it a min-heap.
+         * Sorting the heap in increasing order gives the largest errors first.
+         */
+        std::sort(heap.begin(), heap.end());
+        for (const Entry &e : heap) {
+            worstIndices.push_back(e.second);
+            worstValues.push_back(-e.first);
+        }
+        worstIndices.resize(worstCount, -1);
+        worstValues .resize(worstCount, std::numeric_limits<double>::quiet_NaN());
+        const size_t count = errors.size();
+        stats[AUDIT_COUNT] = static_cast<double>(count);
+        if (count != 0) {
+            stats[AUDIT_MEAN]   = sum / count;
+            stats[AUDIT_MEDIAN] = audit_percentile(errors, 0.50);
+            stats[AUDIT_P95]    = audit_percentile(errors, 0.95);
+            stats[AUDIT_P99]    = audit_percentile(errors, 0.99);
+        } else {
+            stats[AUDIT_MAXIMUM] = stats[AUDIT_MEAN] = stats[AUDIT_MEDIAN] =
+            stats[AUDIT_P95] = stats[AUDIT_P99] = std::numeric_limits<double>::quiet_NaN();
+        }
+    } catch (const std::exception &e) {
+        rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+        return;
+    }
+    env->SetDoubleArrayRegion(statistics, 0, AUDIT_STATISTICS_SIZE, stats);
+    if (worstCount != 0) {
+        env->SetIntArrayRegion   (worst,       0, static_cast<jsize>(worstCount), worstIndices.data());
+        env->SetDoubleArrayRegion(worstErrors, 0, static_cast<jsize>(worstCount), worstValues.data());
+    }
+}
+
+
+
+
+// </editor-fold>
+// ┌────────────────────────────────────────────────────────────────────────────────────────────┐
+// │                            CLASS Transform (distortion factors)                            │
+// └────────────────────────────────────────────────────────────────────────────────────────────┘
+// <editor-fold desc="Distortion factors">
+
+
+/**
+ * Number of points in each chunk of the distortion factors computation. The geographic coordinates
+ * and the factors of a chunk are copied between the Java arrays and scratch buffers of this size.
+ */
+#define FACTORS_CHUNK_SIZE 1024
+
+/**
+ * Number of values computed for each point by `Java_org_osgeo_proj_Transform_factors(…)`.
+ * Must be consistent with the `BatchTransform.NUM_FACTORS` constant.
+ */
+#define FACTORS_PER_POINT 12
+
+
+/**
+ * Creates a PJ object converting geographic coordinates in radians, with longitude first, to the given
+ * projected CRS. This is the form expected by `proj_factors(…)`. Creating this PJ once and caching it
+ * avoids the creation of the same operation by `proj_factors(…)` for each point when its argument is
+ * a projected CRS. The datum is the datum of the projected CRS, so no datum shift is involved.
+ * The projected CRS is normalized to (easting, northing) axis order in metres, as `proj_factors(…)`
+ * does itself, because the factors are derived from the partial derivatives of the projection.
+ * Otherwise northing-first CRS (e.g. EPSG:2193) or CRS in feet (e.g. EPSG:2227) would give wrong factors.
+ *
+ * @param  env         The JNI environment.
+ * @param  context     The thread context in which the operation is applied.
+ * @param  definition  The definition (typically WKT) of the projected CRS.
+ * @return pointer to the PJ object, or null if the creation failed.
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createFactorsPJ(JNIEnv *env, jobject context, jstring definition) {
+    PJ_CONTEXT *ctx = get_context(env, context);
+    const char *definition_utf = env->GetStringUTFChars(definition, nullptr);
+    if (definition_utf) {
+        PJ *crs = proj_create(ctx, definition_utf);
+        env->ReleaseStringUTFChars(definition, definition_utf);
+        PJ *pj = nullptr;
+        if (crs) {
+            if (proj_get_type(crs) == PJ_TYPE_PROJECTED_CRS) {
+                PJ *geodetic = proj_crs_get_geodetic_crs(ctx, crs);
+                if (geodetic) {
+                    PJ *datum = proj_crs_get_datum(ctx, geodetic);
+                    if (!datum) datum = proj_crs_get_datum_ensemble(ctx, geodetic);
+                    if (datum) {
+                        PJ *cs = proj_create_ellipsoidal_2D_cs(ctx, PJ_ELLPS2D_LONGITUDE_LATITUDE, "Radian", 1.0);
+                        if (cs) {
+                            PJ *normalized = proj_create_geographic_crs_from_datum(ctx, "unnamed", datum, cs);
+                            if (normalized) {
+                                PJ *metric = proj_crs_alter_cs_linear_unit(ctx, crs, "metre", 1.0, "EPSG", "9001");
+                                if (metric) {
+                                    PJ *target = proj_normalize_for_visualization(ctx, metric);
+                                    if (target) {
+                                        pj = proj_create_crs_to_crs_from_pj(ctx, normalized, target, nullptr, nullptr);
+                                        proj_destroy(target);
+                                    }
+                                    proj_destroy(metric);
+                                }
+                                proj_destroy(normalized);
+                            }
+                            proj_destroy(cs);
+                        }
+                        proj_destroy(datum);
+                    }
+                    proj_destroy(geodetic);
+                }
+            }
+            proj_destroy(crs);
+        }
+        if (pj) {
+            count_resource(org_osgeo_proj_NativeResource_TRANSFORMS, +1);
+            return reinterpret_cast<jlong>(pj);
+        }
+        jclass c = env->FindClass(JPJ_FACTORY_EXCEPTION);
+        if (c) env->ThrowNew(c, "Can not compute distortion factors for a CRS which is not a projected CRS.");
+    }
+    return 0;
+}
+
+
+/**
+ * Computes the map projection distortion factors at the given geographic coordinates with `proj_factors(…)`.
+ * The PJ shall have been created by `Java_org_osgeo_proj_Context_createFactorsPJ(…)`. The coordinates are
+ * (longitude, latitude) tuples in degrees. For each point, the following values are stored in the order
+ * of the `PJ_FACTORS` structure: meridional scale, parallel scale, areal scale, angular distortion,
+ * meridian/parallel angle, meridian convergence, Tissot semi-major and semi-minor axes, then the four
+ * partial derivatives ∂x/∂λ, ∂x/∂φ, ∂y/∂λ and ∂y/∂φ. Angles are converted from radians to degrees.
+ * All values of a point are set to NaN if the factors can not be computed at that point.
+ *
+ * @param  env          The JNI environment.
+ * @param  transform    The Java object wrapping the PJ to use.
+ * @param  coordinates  The geographic coordinates as a sequence of (λ,φ) tuples in degrees.
+ * @param  srcOff       Offset of the first coordinate in the `coordinates` array.
+ * @param  factors      Where to store the factors, `FACTORS_PER_POINT` values per point.
+ * @param  dstOff       Offset of the first value to write in the `factors` array.
+ * @param  numPts       Number of points for which to compute the factors.
+ * @return number of points for which the factors could not be computed.
+ */
+JNIEXPORT jint JNICALL Java_org_osgeo_proj_Transform_factors
+    (JNIEnv *env, jobject transform, jdoubleArray coordinates, jint srcOff, jdoubleArray factors, jint dstOff, jint numPts)
+{
+    PJ *pj = get_PJ(env, transform);
+    if (!pj) return 0;
+    jint failures = 0;
+    try {
+        std::vector<double> source(static_cast<size_t>(FACTORS_CHUNK_SIZE) * 2);
+        std::vector<double> target(static_cast<size_t>(FACTORS_CHUNK_SIZE) * FACTORS_PER_POINT);
+        for (jint start = 0; start < numPts; start += FACTORS_CHUNK_SIZE) {
+            const jint n = std::min(numPts - start, static_cast<jint>(FACTORS_CHUNK_SIZE));
+            env->GetDoubleArrayRegion(coordinates, srcOff + start * 2, n * 2, source.data());
+            if (env->ExceptionCheck()) return failures;
+            for (jint i=0; i<n; i++) {
+                double *f = target.data() + i * FACTORS_PER_POINT;
+                const PJ_COORD lp = proj_coord(proj_torad(source[i*2]), proj_torad(source[i*2 + 1]), 0, 0);
+                proj_errno_reset(pj);
+                const PJ_FACTORS r = proj_factors(pj, lp);
+                if (proj_errno(pj) != 0 || !std::isfinite(r.meridional_scale)) {
+                    std::fill(f, f + FACTORS_PER_POINT, std::numeric_limits<double>::quiet_NaN());
+                    failures++;
+                    continue;
+                }
+                f[ 0] = r.meridional_scale;
+                f[ 1] = r.parallel_scale;
+                f[ 2] = r.areal_scale;
+                f[ 3] = proj_todeg(r.angular_distortion);
+                f[ 4] = proj_todeg(r.meridian_parallel_angle);
+                f[ 5] = proj_todeg(r.meridian_convergence);
+                f[ 6] = r.tissot_semimajor;
+                f[ 7] = r.tissot_semiminor;
+                f[ 8] = r.dx_dlam;
+                f[ 9] = r.dx_dphi;
+                f[10] = r.dy_dlam;
+                f[11] = r.dy_dphi;
+            }
+            proj_errno_reset(pj);
+            env->SetDoubleArrayRegion(factors, dstOff + start * FACTORS_PER_POINT, n * FACTORS_PER_POINT, target.data());
+            if (env->ExceptionCheck()) return failures;
+        }
+    } catch (const std::exception &e) {
+        rethrow_as_java_exception(env, JPJ_TRANSFORM_EXCEPTION, e);
+    }
+    return failures;
 }
 // </editor-fold>
@@ -34,10 +34,10 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createGeodeticObj
 /*
  * Class:     org_osgeo_proj_AuthorityFactory
  * Method:    createOperation
- * Signature: (Lorg/osgeo/proj/NativeResource;Lorg/osgeo/proj/NativeResource;DDDDDIIIIZ)Lorg/osgeo/proj/Operation;
+ * Signature: (Lorg/osgeo/proj/NativeResource;Lorg/osgeo/proj/NativeResource;DDDDDIIIIZLorg/osgeo/proj/Context;)Lorg/osgeo/proj/Operation;
  */
 JNIEXPORT jobject JNICALL Java_org_osgeo_proj_AuthorityFactory_createOperation
-  (JNIEnv *, jobject, jobject, jobject, jdouble, jdouble, jdouble, jdouble, jdouble, jint, jint, jint, jint, jboolean);
+  (JNIEnv *, jobject, jobject, jobject, jdouble, jdouble, jdouble, jdouble, jdouble, jint, jint, jint, jint, jboolean, jobject);
 
 /*
  * Class:     org_osgeo_proj_AuthorityFactory
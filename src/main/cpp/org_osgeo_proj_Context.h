@@ -33,6 +33,30 @@ JNIEXPORT jobject JNICALL Java_org_osgeo_proj_Context_createFromUserInput
 JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createPJ
   (JNIEnv *, jobject, jobject);
 
+/*
+ * Class:     org_osgeo_proj_Context
+ * Method:    createPipeline
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createPipeline
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     org_osgeo_proj_Context
+ * Method:    createDomainPJ
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createDomainPJ
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     org_osgeo_proj_Context
+ * Method:    createFactorsPJ
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Context_createFactorsPJ
+  (JNIEnv *, jobject, jstring);
+
 /*
  * Class:     org_osgeo_proj_Context
  * Method:    destroyPJ
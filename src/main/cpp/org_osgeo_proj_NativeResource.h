@@ -7,6 +7,16 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+#undef org_osgeo_proj_NativeResource_SHARED_POINTERS
+#define org_osgeo_proj_NativeResource_SHARED_POINTERS 0L
+#undef org_osgeo_proj_NativeResource_CONTEXTS
+#define org_osgeo_proj_NativeResource_CONTEXTS 1L
+#undef org_osgeo_proj_NativeResource_TRANSFORMS
+#define org_osgeo_proj_NativeResource_TRANSFORMS 2L
+#undef org_osgeo_proj_NativeResource_MALLOC_IN_USE
+#define org_osgeo_proj_NativeResource_MALLOC_IN_USE 3L
+#undef org_osgeo_proj_NativeResource_NUM_COUNTERS
+#define org_osgeo_proj_NativeResource_NUM_COUNTERS 4L
 /*
  * Class:     org_osgeo_proj_NativeResource
  * Method:    version
@@ -15,6 +25,14 @@ extern "C" {
 JNIEXPORT jstring JNICALL Java_org_osgeo_proj_NativeResource_version
   (JNIEnv *, jclass);
 
+/*
+ * Class:     org_osgeo_proj_NativeResource
+ * Method:    resourceCounts
+ * Signature: ([J)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_NativeResource_resourceCounts
+  (JNIEnv *, jclass, jlongArray);
+
 /*
  * Class:     org_osgeo_proj_NativeResource
  * Method:    initialize
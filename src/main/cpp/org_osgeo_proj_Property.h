@@ -117,6 +117,8 @@ extern "C" {
 #define org_osgeo_proj_Property_IVF_DEFINITIVE 602L
 #undef org_osgeo_proj_Property_PARAMETER_BOOL
 #define org_osgeo_proj_Property_PARAMETER_BOOL 603L
+#undef org_osgeo_proj_Property_IS_DEPRECATED
+#define org_osgeo_proj_Property_IS_DEPRECATED 604L
 #ifdef __cplusplus
 }
 #endif
@@ -55,6 +55,38 @@ JNIEXPORT jint JNICALL Java_org_osgeo_proj_SharedPointer_getIntegerProperty
 JNIEXPORT jboolean JNICALL Java_org_osgeo_proj_SharedPointer_getBooleanProperty
   (JNIEnv *, jobject, jshort);
 
+/*
+ * Class:     org_osgeo_proj_SharedPointer
+ * Method:    getStringColumn
+ * Signature: ([Lorg/osgeo/proj/SharedPointer;S)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_osgeo_proj_SharedPointer_getStringColumn
+  (JNIEnv *, jclass, jobjectArray, jshort);
+
+/*
+ * Class:     org_osgeo_proj_SharedPointer
+ * Method:    getNumericColumn
+ * Signature: ([Lorg/osgeo/proj/SharedPointer;S)[D
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_osgeo_proj_SharedPointer_getNumericColumn
+  (JNIEnv *, jclass, jobjectArray, jshort);
+
+/*
+ * Class:     org_osgeo_proj_SharedPointer
+ * Method:    getArrayColumn
+ * Signature: ([Lorg/osgeo/proj/SharedPointer;SI)[D
+ */
+JNIEXPORT jdoubleArray JNICALL Java_org_osgeo_proj_SharedPointer_getArrayColumn
+  (JNIEnv *, jclass, jobjectArray, jshort, jint);
+
+/*
+ * Class:     org_osgeo_proj_SharedPointer
+ * Method:    getBooleanColumn
+ * Signature: ([Lorg/osgeo/proj/SharedPointer;S)[Z
+ */
+JNIEXPORT jbooleanArray JNICALL Java_org_osgeo_proj_SharedPointer_getBooleanColumn
+  (JNIEnv *, jclass, jobjectArray, jshort);
+
 /*
  * Class:     org_osgeo_proj_SharedPointer
  * Method:    getVectorSize
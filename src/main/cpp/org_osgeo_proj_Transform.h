@@ -7,6 +7,20 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+#undef org_osgeo_proj_Transform_DOUBLE
+#define org_osgeo_proj_Transform_DOUBLE 0L
+#undef org_osgeo_proj_Transform_FLOAT
+#define org_osgeo_proj_Transform_FLOAT 1L
+#undef org_osgeo_proj_Transform_INT
+#define org_osgeo_proj_Transform_INT 2L
+#undef org_osgeo_proj_Transform_SHORT
+#define org_osgeo_proj_Transform_SHORT 3L
+#undef org_osgeo_proj_Transform_REORDER
+#define org_osgeo_proj_Transform_REORDER 1L
+#undef org_osgeo_proj_Transform_DEDUPLICATE
+#define org_osgeo_proj_Transform_DEDUPLICATE 2L
+#undef org_osgeo_proj_Transform_COMPACT
+#define org_osgeo_proj_Transform_COMPACT 4L
 /*
  * Class:     org_osgeo_proj_Transform
  * Method:    assign
@@ -15,6 +29,14 @@ extern "C" {
 JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_assign
   (JNIEnv *, jobject, jobject);
 
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    hasInverse
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_osgeo_proj_Transform_hasInverse
+  (JNIEnv *, jobject);
+
 /*
  * Class:     org_osgeo_proj_Transform
  * Method:    transform
@@ -23,6 +45,62 @@ JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_assign
 JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transform
   (JNIEnv *, jobject, jint, jdoubleArray, jint, jint);
 
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    transformBatch
+ * Signature: (ILjava/lang/Object;II[DILjava/lang/Object;II[DII[D[ZI[DLorg/osgeo/proj/Transform;[DLorg/osgeo/proj/Transform;)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformBatch
+  (JNIEnv *, jobject, jint, jobject, jint, jint, jdoubleArray, jint, jobject, jint, jint, jdoubleArray, jint, jint, jdoubleArray, jbooleanArray, jint, jdoubleArray, jobject, jdoubleArray, jobject);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    transformArrow
+ * Signature: (JJJJLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformArrow
+  (JNIEnv *, jobject, jlong, jlong, jlong, jlong, jstring);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    transformWKB
+ * Signature: ([B[B[III[Z)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformWKB
+  (JNIEnv *, jobject, jbyteArray, jbyteArray, jintArray, jint, jint, jbooleanArray);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    transformPacked
+ * Signature: ([Ljava/lang/Object;[II)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_transformPacked
+  (JNIEnv *, jobject, jobjectArray, jintArray, jint);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    transformTextBuffer
+ * Signature: (Ljava/nio/ByteBuffer;IILjava/nio/ByteBuffer;II[IIJJIZ[I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_osgeo_proj_Transform_transformTextBuffer
+  (JNIEnv *, jobject, jobject, jint, jint, jobject, jint, jint, jintArray, jint, jlong, jlong, jint, jboolean, jintArray);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    audit
+ * Signature: (I[DII[D[I[D)V
+ */
+JNIEXPORT void JNICALL Java_org_osgeo_proj_Transform_audit
+  (JNIEnv *, jobject, jint, jdoubleArray, jint, jint, jdoubleArray, jintArray, jdoubleArray);
+
+/*
+ * Class:     org_osgeo_proj_Transform
+ * Method:    factors
+ * Signature: ([DI[DII)I
+ */
+JNIEXPORT jint JNICALL Java_org_osgeo_proj_Transform_factors
+  (JNIEnv *, jobject, jdoubleArray, jint, jdoubleArray, jint, jint);
+
 /*
  * Class:     org_osgeo_proj_Transform
  * Method:    destroy
@@ -58,8 +58,10 @@
 module org.osgeo.proj {
     requires java.logging;
     requires transitive org.opengis.geoapi;
+    requires static org.locationtech.jts;
 
     exports org.osgeo.proj;
+    exports org.osgeo.proj.jts;
 
     uses javax.measure.spi.ServiceProvider;
 
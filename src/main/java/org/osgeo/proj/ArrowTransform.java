@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Objects;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * Transforms GeoArrow arrays given by the addresses of their structures in the
+ * <a href="https://arrow.apache.org/docs/format/CDataInterface.html">Arrow C Data Interface</a>.
+ * Supported arrays are GeoArrow points, linestrings, polygons and their multi-geometry variants,
+ * with coordinates stored as double-precision values in the interleaved or separated layout.
+ * The arrays are transformed without copy in the Java heap and without dependency to the Arrow Java library.
+ *
+ * <p>Null points are not transformed. The <var>m</var> dimension, if present, is copied unchanged.
+ * Coordinates are given to PROJ in the (<var>x</var>, <var>y</var>, <var>z</var>) order of the
+ * GeoArrow array.</p>
+ *
+ * <p>Instances of this class are thread-safe if the {@link BatchTransform} is not modified concurrently.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class ArrowTransform {
+    /**
+     * The batch transform which provides the {@code PJ} and the execution lane.
+     */
+    private final BatchTransform batch;
+
+    /**
+     * Creates a new adapter for transforming GeoArrow arrays with the given batch transform.
+     * Only the {@linkplain BatchTransform#getPriority() priority} of the batch transform is used;
+     * quantization, spatial ordering, deduplication, reductions and domain guard are not applied.
+     *
+     * @param  batch  the batch transform to use.
+     */
+    public ArrowTransform(final BatchTransform batch) {
+        this.batch = Objects.requireNonNull(batch);
+    }
+
+    /**
+     * Transforms a GeoArrow array into a new Arrow array. The target structures shall be allocated by the caller.
+     * On success, this method writes in them a copy of the source array with transformed coordinates, together
+     * with a release callback as required by the Arrow specification. The caller becomes responsible for
+     * releasing the result. The source structures are not modified and not released. The GeoArrow extension
+     * metadata of the target schema is replaced by the target CRS in PROJJSON format if known, or by an empty
+     * metadata otherwise. If a point can not be transformed, the target structures are not written.
+     *
+     * @param  srcSchema  address of the {@code ArrowSchema} describing the source array.
+     * @param  srcArray   address of the {@code ArrowArray} to transform.
+     * @param  dstSchema  address of an {@code ArrowSchema} where to write the schema of the result.
+     * @param  dstArray   address of an {@code ArrowArray} where to write the result.
+     * @throws IllegalArgumentException if an address is zero or if the source is not a supported GeoArrow array.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final long srcSchema, final long srcArray,
+                          final long dstSchema, final long dstArray) throws TransformException
+    {
+        if (dstSchema == 0 || dstArray == 0) {
+            throw new IllegalArgumentException("Null target address.");
+        }
+        run(srcSchema, srcArray, dstSchema, dstArray);
+    }
+
+    /**
+     * Transforms in-place the coordinates of a GeoArrow array. This method is like
+     * {@link #transform(long, long, long, long) transform(…)} except that the coordinate buffers
+     * of the source array are overwritten. This is possible only if the caller has exclusive ownership of
+     * those buffers, since other arrays may share them. The schema (including the CRS in its metadata)
+     * is not modified. If a point can not be transformed, the other points are nevertheless transformed.
+     *
+     * @param  schema  address of the {@code ArrowSchema} describing the array.
+     * @param  array   address of the {@code ArrowArray} to transform in-place.
+     * @throws IllegalArgumentException if an address is zero or if the array is not a supported GeoArrow array.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transformInPlace(final long schema, final long array) throws TransformException {
+        run(schema, array, 0, 0);
+    }
+
+    /**
+     * Returns the GeoArrow extension metadata for the target CRS of the transform.
+     * If the target CRS is unknown, returns an empty JSON object.
+     *
+     * @return the GeoArrow extension metadata to store in the schema of transformed arrays.
+     */
+    private String geoArrowMetadata() {
+        final MathTransform transform = batch.getTransform();
+        if (transform instanceof Operation) {
+            final Object crs = ((Operation) transform).getTargetCRS();
+            if (crs instanceof IdentifiableObject) {
+                try {
+                    final String json = ((IdentifiableObject) crs).impl.format(null,
+                            ReferencingFormat.Convention.JSON.ordinal(), -1, false, true);
+                    if (json != null) {
+                        return "{\"crs\":" + json + '}';
+                    }
+                } catch (UnformattableObjectException e) {
+                    // Ignore: the CRS will be declared unknown.
+                }
+            }
+        }
+        return "{}";
+    }
+
+    /**
+     * Verifies the addresses of Arrow structures, then delegates the work to native code.
+     *
+     * @param  srcSchema  address of the source {@code ArrowSchema}.
+     * @param  srcArray   address of the source {@code ArrowArray}.
+     * @param  dstSchema  address of the target {@code ArrowSchema}, or 0 for in-place.
+     * @param  dstArray   address of the target {@code ArrowArray}, or 0 for in-place.
+     * @throws TransformException if a point can not be transformed.
+     */
+    private void run(final long srcSchema, final long srcArray, final long dstSchema, final long dstArray)
+            throws TransformException
+    {
+        if (srcSchema == 0 || srcArray == 0) {
+            throw new IllegalArgumentException("Null source address.");
+        }
+        final String extension = (dstArray != 0) ? geoArrowMetadata() : null;
+        batch.execute((tr) -> {
+            tr.transformArrow(srcSchema, srcArray, dstSchema, dstArray, extension);
+            return null;
+        });
+    }
+}
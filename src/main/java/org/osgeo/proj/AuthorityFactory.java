@@ -22,10 +22,15 @@
  */
 package org.osgeo.proj;
 
+import java.util.Map;
 import java.util.Set;
+import java.util.HashMap;
+import java.util.Iterator;
 import java.util.Objects;
+import java.util.Optional;
 import java.util.Collection;
 import java.util.Collections;
+import java.util.concurrent.ConcurrentHashMap;
 import javax.measure.Unit;
 import org.opengis.util.FactoryException;
 import org.opengis.util.InternationalString;
@@ -48,7 +53,7 @@ import org.opengis.referencing.operation.*;
  * same thread.</p>
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 final class AuthorityFactory extends NativeResource {
@@ -121,6 +126,8 @@ final class AuthorityFactory extends NativeResource {
      * @param  gridAvailabilityUse          how grid availability is used.
      * @param  allowUseIntermediateCRS      whether an intermediate pivot CRS can be used for researching coordinate operations.
      * @param  discardSuperseded            whether transformations that are superseded (but not deprecated) should be discarded.
+     * @param  fastestIn                    context in which to measure the speed of candidate operations for selecting the
+     *                                      fastest one meeting the desired accuracy, or {@code null} for PROJ preference order.
      * @return the coordinate operations.
      * @throws FactoryException if an error occurred while searching the coordinate operations.
      *
@@ -131,7 +138,7 @@ final class AuthorityFactory extends NativeResource {
             double southBoundLatitude, double northBoundLatitude,
             double desiredAccuracy,
             int sourceAndTargetCRSExtentUse, int spatialCriterion, int gridAvailabilityUse, int allowUseIntermediateCRS,
-            boolean discardSuperseded)
+            boolean discardSuperseded, Context fastestIn)
             throws FactoryException;
 
     /**
@@ -154,10 +161,64 @@ final class AuthorityFactory extends NativeResource {
      * This class uses a pool of {@link AuthorityFactory} instances for making sure that each instance
      * is used by only one thread at a time. There is no guarantee that two consecutive invocations of
      * {@code createFoo(…)} methods in the same thread will use the same {@link AuthorityFactory} instance.</p>
+     *
+     * <p>Codes for which no object exists are remembered in a bounded cache shared by all instances,
+     * so that repeated requests for the same invalid codes are answered without database query and
+     * without going through the native exception path. That cache is cleared by {@link Proj#invalidateFailures()}
+     * and when a context is created with a different search path.</p>
      */
     static final class API implements CRSAuthorityFactory, CSAuthorityFactory, DatumAuthorityFactory,
             CoordinateOperationAuthorityFactory
     {
+        /**
+         * Maximal number of codes retained in the cache of codes for which no object exists.
+         * This is the value of the {@code "org.osgeo.proj.maxMissingCodes"} system property at startup time.
+         */
+        private static final int MAX_MISSING_CODES;
+        static {
+            final Integer n = Integer.getInteger("org.osgeo.proj.maxMissingCodes");
+            MAX_MISSING_CODES = (n != null) ? Math.max(0, n) : 10000;
+        }
+
+        /**
+         * Messages of the exceptions thrown for codes for which no object exists, keyed by authority, type and code.
+         * The size is checked only when a new code is added, in which case arbitrary entries are evicted for keeping
+         * the map approximately under {@link #MAX_MISSING_CODES} entries. Lookups are lock-free.
+         */
+        private static final ConcurrentHashMap<String,String> MISSING_CODES = new ConcurrentHashMap<>();
+
+        /**
+         * The {@link Type} code for each GeoAPI interface accepted by {@link #typeOf(Class)}.
+         */
+        private static final Map<Class<?>, Short> TYPES = new HashMap<>(40);
+        static {
+            TYPES.put(IdentifiedObject.class,          Type.ANY);
+            TYPES.put(CoordinateSystem.class,          Type.COORDINATE_SYSTEM);
+            TYPES.put(CartesianCS.class,               Type.CARTESIAN_CS);
+            TYPES.put(SphericalCS.class,               Type.SPHERICAL_CS);
+            TYPES.put(EllipsoidalCS.class,             Type.ELLIPSOIDAL_CS);
+            TYPES.put(VerticalCS.class,                Type.VERTICAL_CS);
+            TYPES.put(TimeCS.class,                    Type.TEMPORAL_CS);
+            TYPES.put(PrimeMeridian.class,             Type.PRIME_MERIDIAN);
+            TYPES.put(Ellipsoid.class,                 Type.ELLIPSOID);
+            TYPES.put(org.opengis.referencing.datum.Datum.class, Type.DATUM);
+            TYPES.put(GeodeticDatum.class,             Type.GEODETIC_REFERENCE_FRAME);
+            TYPES.put(VerticalDatum.class,             Type.VERTICAL_REFERENCE_FRAME);
+            TYPES.put(TemporalDatum.class,             Type.TEMPORAL_DATUM);
+            TYPES.put(EngineeringDatum.class,          Type.ENGINEERING_DATUM);
+            TYPES.put(CoordinateReferenceSystem.class, Type.COORDINATE_REFERENCE_SYSTEM);
+            TYPES.put(GeodeticCRS.class,               Type.GEODETIC_CRS);
+            TYPES.put(GeographicCRS.class,             Type.GEOGRAPHIC_CRS);
+            TYPES.put(GeocentricCRS.class,             Type.GEOCENTRIC_CRS);
+            TYPES.put(ProjectedCRS.class,              Type.PROJECTED_CRS);
+            TYPES.put(VerticalCRS.class,               Type.VERTICAL_CRS);
+            TYPES.put(TemporalCRS.class,               Type.TEMPORAL_CRS);
+            TYPES.put(EngineeringCRS.class,            Type.ENGINEERING_CRS);
+            TYPES.put(CompoundCRS.class,               Type.COMPOUND_CRS);
+            TYPES.put(CoordinateOperation.class,       Type.COORDINATE_OPERATION);
+            TYPES.put(Conversion.class,                Type.CONVERSION);
+        }
+
         /**
          * The authority name of this factory.
          */
@@ -184,14 +245,21 @@ final class AuthorityFactory extends NativeResource {
          * @throws FactoryException if no object can be created for the given code.
          */
         private <T> T createGeodeticObject(final Class<T> classe, final short type, final String code) throws FactoryException {
-            Objects.requireNonNull(code);
+            final String key = missingCodeKey(type, code);
+            final String missing = MISSING_CODES.get(key);
+            if (missing != null) {
+                throw new NoSuchAuthorityCodeException(missing, authority, code);
+            }
             final T result;
             try (Context c = Context.acquire()) {
                 result = classe.cast(c.factory(authority).createGeodeticObject(type, code));
             } catch (ClassCastException e) {
-                throw (NoSuchAuthorityCodeException) new NoSuchAuthorityCodeException(
-                        authority + ':' + code + " identifies an object of a different kind.",
-                        authority, code).initCause(e);
+                final String message = authority + ':' + code + " identifies an object of a different kind.";
+                addMissingCode(key, message);
+                throw (NoSuchAuthorityCodeException) new NoSuchAuthorityCodeException(message, authority, code).initCause(e);
+            } catch (NoSuchAuthorityCodeException e) {
+                addMissingCode(key, e.getMessage());
+                throw e;
             }
             if (result != null) {
                 return result;
@@ -204,6 +272,83 @@ final class AuthorityFactory extends NativeResource {
             throw new FactoryException("Can not get PROJ object.");
         }
 
+        /**
+         * Creates an object for the given authority code, or returns an empty value if there is no object
+         * of the given type for that code. This method does not throw {@link NoSuchAuthorityCodeException},
+         * which makes it cheaper for validating many codes when a large fraction of them are invalid.
+         *
+         * @param  <T>     compile-time value of {@code classe} argument.
+         * @param  classe  the expected Java class of the object to create.
+         * @param  type    one of {@link Type#ELLIPSOID}, {@link Type#PRIME_MERIDIAN}, <i>etc.</i> constants.
+         * @param  code    object code allocated by authority.
+         * @return wrapper for the PROJ object, or empty if there is no object for the given code.
+         * @throws FactoryException if the object creation failed for another reason than a missing code.
+         */
+        <T> Optional<T> tryCreate(final Class<T> classe, final short type, final String code) throws FactoryException {
+            final String key = missingCodeKey(type, code);
+            if (MISSING_CODES.containsKey(key)) {
+                return Optional.empty();
+            }
+            try {
+                return Optional.of(createGeodeticObject(classe, type, code));
+            } catch (NoSuchAuthorityCodeException e) {
+                return Optional.empty();
+            }
+        }
+
+        /**
+         * Returns the {@link Type} code for the given GeoAPI interface.
+         *
+         * @param  classe  a GeoAPI interface such as {@code GeographicCRS.class}.
+         * @return the {@link Type} code for the given interface.
+         * @throws IllegalArgumentException if the given class is not a supported GeoAPI interface.
+         */
+        static short typeOf(final Class<?> classe) {
+            final Short type = TYPES.get(classe);
+            if (type == null) {
+                throw new IllegalArgumentException("Unsupported type: " + classe);
+            }
+            return type;
+        }
+
+        /**
+         * Returns the key of the given code in the cache of codes for which no object exists.
+         *
+         * @param  type  one of {@link Type#ELLIPSOID}, {@link Type#PRIME_MERIDIAN}, <i>etc.</i> constants.
+         * @param  code  object code allocated by authority.
+         * @return key in the {@link #MISSING_CODES} map.
+         */
+        private String missingCodeKey(final short type, final String code) {
+            return authority + ':' + type + ':' + Objects.requireNonNull(code);
+        }
+
+        /**
+         * Remembers that no object exists for the code identified by the given key.
+         *
+         * @param  key      value returned by {@link #missingCodeKey(short, String)}.
+         * @param  message  the exception message to repeat when the code is requested again.
+         */
+        private static void addMissingCode(final String key, final String message) {
+            if (MAX_MISSING_CODES != 0) {
+                if (MISSING_CODES.size() >= MAX_MISSING_CODES) {
+                    final Iterator<String> it = MISSING_CODES.keySet().iterator();
+                    while (it.hasNext() && MISSING_CODES.size() >= MAX_MISSING_CODES) {
+                        it.next();
+                        it.remove();
+                    }
+                }
+                MISSING_CODES.put(key, (message != null) ? message : "No object for code " + key + '.');
+            }
+        }
+
+        /**
+         * Forgets all codes for which no object has been found. This method should be invoked
+         * when the database may have changed, for example after a change of the search path.
+         */
+        static void clearMissingCodes() {
+            MISSING_CODES.clear();
+        }
+
         /**
          * Returns the project responsible for creating this factory implementation, which is "PROJ".
          * {@link Citation#getEdition()} contains the PROJ version string.
@@ -0,0 +1,1157 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Arrays;
+import java.util.Objects;
+import java.lang.reflect.Array;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.NoninvertibleTransformException;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * Transforms large arrays of coordinate tuples with options not available in the {@link MathTransform} API.
+ * A {@code BatchTransform} wraps a {@link MathTransform} created by PROJ-JNI and adds the following features:
+ *
+ * <ul>
+ *   <li><b>Quantization:</b> source coordinates can be read from arrays of integers and converted to real
+ *       numbers by an affine transform before the coordinate operation. Conversely, target coordinates can
+ *       be converted by an affine transform and rounded to integers after the coordinate operation.
+ *       For example a vector tile generator can transform geographic coordinates directly into integer
+ *       tile coordinates in a single pass, without intermediate {@code double[]} array.</li>
+ *   <li><b>Spatial ordering:</b> points can be transformed in an order that preserves spatial locality
+ *       (a Morton curve), then stored back in their original order. This can make a large difference
+ *       for operations using datum shift grids when the input points are in random order.</li>
+ *   <li><b>Deduplication:</b> coordinate tuples repeated in the same batch (e.g. shared vertices
+ *       in polygon meshes) can be transformed only once, with the result copied to all occurrences.</li>
+ *   <li><b>Reductions:</b> the envelope of transformed points, the number of failures and the points outside
+ *       a target extent can be computed in the same pass than the transform, while the data are in cache.
+ *       Points that failed or are outside the extent can be removed from the output.</li>
+ *   <li><b>Round-trip audit:</b> the accuracy of the inverse operation can be verified by transforming points
+ *       forward then backward in native code, with statistics about the differences computed in the same pass.</li>
+ *   <li><b>Distortion factors:</b> the scale factors, meridian convergence and other distortions of the
+ *       map projection to a projected CRS can be computed at many geographic locations in one native call.</li>
+ *   <li><b>Domain guard:</b> points outside the domain of validity of the coordinate operation can be
+ *       detected in native code before the transform, then set to NaN or given to a fallback transform
+ *       instead of being transformed by an operation which is not designed for them.</li>
+ *   <li><b>Priority:</b> long jobs can be executed in a {@linkplain Priority#BULK bulk} lane
+ *       which does not compete with interactive requests for PROJ resources.</li>
+ * </ul>
+ *
+ * All conversions are done in native code together with the coordinate operation,
+ * one chunk of coordinates at a time.
+ *
+ * <p>Coordinates in other formats are transformed by adapters created from a {@code BatchTransform}:
+ * {@link WKBTransform} for <cite>Well-Known Binary</cite> geometries, {@link ArrowTransform} for GeoArrow arrays,
+ * {@link TextTransform} for delimited text and {@link PackedTransform} for packed arrays of many geometries.
+ * Those adapters use the {@linkplain #getPriority() priority} of the batch transform but not its other options.</p>
+ *
+ * <h2>Limitations</h2>
+ * <p>{@code BatchTransform} is <em>not</em> thread-safe during configuration. After configuration,
+ * the {@code transform(…)} methods can be invoked concurrently if the configuration is not modified.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class BatchTransform {
+    /**
+     * Index of a value in each group of {@value #NUM_FACTORS} values computed by
+     * {@link #factors(double[], int, double[], int, int) factors(…)} for each point.
+     * Those values are, in order: the scale factors along the meridian and along the parallel,
+     * the areal scale factor, the maximal angular distortion, the angle between meridian and parallel,
+     * the meridian convergence, the semi-major and semi-minor axes of the Tissot indicatrix,
+     * and the partial derivatives ∂x/∂λ, ∂x/∂φ, ∂y/∂λ and ∂y/∂φ. Angles are in degrees.
+     *
+     * @see #factors(double[], int, double[], int, int)
+     */
+    public static final int MERIDIONAL_SCALE = 0, PARALLEL_SCALE = 1, AREAL_SCALE = 2,
+            ANGULAR_DISTORTION = 3, MERIDIAN_PARALLEL_ANGLE = 4, MERIDIAN_CONVERGENCE = 5,
+            TISSOT_SEMIMAJOR = 6, TISSOT_SEMIMINOR = 7, DX_DLAM = 8, DX_DPHI = 9, DY_DLAM = 10, DY_DPHI = 11;
+
+    /**
+     * Number of values computed by {@link #factors(double[], int, double[], int, int) factors(…)} for each point.
+     */
+    public static final int NUM_FACTORS = 12;
+
+    /**
+     * Number of points to transform in each chunk in the {@linkplain Priority#BULK bulk} lane.
+     * This is the value of the {@code "org.osgeo.proj.bulkChunkSize"} system property at startup time.
+     */
+    private static final int BULK_CHUNK_SIZE;
+    static {
+        final Integer n = Integer.getInteger("org.osgeo.proj.bulkChunkSize");
+        BULK_CHUNK_SIZE = (n != null) ? Math.max(1024, n) : 65536;
+    }
+
+    /**
+     * The transform to apply on coordinate tuples.
+     * This is either an {@link Operation} or a {@link Pipeline}.
+     */
+    private final MathTransform transform;
+
+    /**
+     * The cache of {@code PJ} objects of the {@linkplain #transform}.
+     */
+    private final TransformPool transforms;
+
+    /**
+     * Whether the {@code PJ} objects of the {@linkplain #transforms pool} are executed in the inverse direction.
+     * This is {@code true} for the inverse of a {@link Pipeline}.
+     */
+    private final boolean inverted;
+
+    /**
+     * Number of dimensions of source and target coordinate tuples.
+     */
+    private final int srcDim, dstDim;
+
+    /**
+     * Scale factors followed by offsets to apply on source values before the coordinate operation,
+     * or {@code null} if none.
+     */
+    private double[] dequantize;
+
+    /**
+     * Scale factors followed by offsets to apply on target values after the coordinate operation,
+     * or {@code null} if none.
+     */
+    private double[] quantize;
+
+    /**
+     * Bitmask of options such as {@link Transform#REORDER}.
+     */
+    private int flags;
+
+    /**
+     * The lane in which to execute the transforms.
+     */
+    private Priority priority;
+
+    /**
+     * Minimal values followed by maximal values of the target points to retain, or {@code null} if none.
+     */
+    private double[] extent;
+
+    /**
+     * The {@code PJ} converting source coordinates to geographic coordinates for checking the domain of validity,
+     * or {@code null} if the domain guard has never been enabled. Created when first needed and kept after.
+     */
+    private TransformPool domain;
+
+    /**
+     * West, east, south and north bounds of the domain of validity of the operation,
+     * or {@code null} if the domain guard is disabled.
+     */
+    private double[] domainBounds;
+
+    /**
+     * The {@code PJ} of the transform to apply on points outside the domain of validity,
+     * or {@code null} for setting those points to NaN.
+     */
+    private TransformPool fallback;
+
+    /**
+     * Whether the {@code PJ} objects of the {@linkplain #fallback} are executed in the inverse direction.
+     */
+    private boolean fallbackInverted;
+
+    /**
+     * The {@code PJ} for computing the distortion factors of the projected target CRS,
+     * or {@code null} if not yet created. Created when first needed and kept after.
+     *
+     * @see #factors(double[], int, double[], int, int)
+     */
+    private volatile TransformPool factors;
+
+    /**
+     * Creates a new batch transform for the given transform.
+     *
+     * @param  transform  the transform to apply on coordinate tuples.
+     * @throws UnsupportedImplementationException if the given transform is not a PROJ-JNI implementation.
+     * @throws IllegalArgumentException if the number of dimensions of the given transform is unknown.
+     */
+    public BatchTransform(final MathTransform transform) {
+        if (transform instanceof Operation) {
+            transforms = ((Operation) transform).transforms;
+            inverted   = false;
+        } else if (transform instanceof Pipeline) {
+            transforms = ((Pipeline) transform).transforms;
+            inverted   = ((Pipeline) transform).inverted;
+        } else {
+            throw new UnsupportedImplementationException("transform", transform);
+        }
+        this.transform = transform;
+        priority = Priority.INTERACTIVE;
+        srcDim = transform.getSourceDimensions();
+        dstDim = transform.getTargetDimensions();
+        if (srcDim <= 0 || dstDim <= 0) {
+            throw new IllegalArgumentException("Unknown number of dimensions.");
+        }
+    }
+
+    /**
+     * Returns the transform applied by this batch transform.
+     *
+     * @return the transform to apply on coordinate tuples.
+     */
+    public MathTransform getTransform() {
+        return transform;
+    }
+
+    /**
+     * Returns the scale factors followed by the offsets in a single array.
+     *
+     * @param  scale      the scale factors, or {@code null} if none.
+     * @param  offset     the offsets, or {@code null} if none.
+     * @param  dimension  expected number of dimensions.
+     * @return the coefficients, or {@code null} if both arguments are null.
+     */
+    private static double[] coefficients(final double[] scale, final double[] offset, final int dimension) {
+        if (scale == null && offset == null) {
+            return null;
+        }
+        final double[] coefficients = new double[dimension * 2];
+        Arrays.fill(coefficients, 0, dimension, 1);
+        if (scale != null) {
+            if (scale.length != dimension) {
+                throw new IllegalArgumentException("Expected " + dimension + " scale factors but got " + scale.length + '.');
+            }
+            System.arraycopy(scale, 0, coefficients, 0, dimension);
+        }
+        if (offset != null) {
+            if (offset.length != dimension) {
+                throw new IllegalArgumentException("Expected " + dimension + " offsets but got " + offset.length + '.');
+            }
+            System.arraycopy(offset, 0, coefficients, dimension, dimension);
+        }
+        return coefficients;
+    }
+
+    /**
+     * Sets the conversion to apply on source coordinates before the coordinate operation.
+     * Each source value <var>q</var> is converted to a coordinate value <var>x</var> by
+     * <var>x</var> = <var>q</var> × {@code scale[i]} + {@code offset[i]} where <var>i</var> is the dimension.
+     * This conversion is applied on all source arrays, including arrays of floating point values.
+     *
+     * @param  scale   the scale factor for each source dimension, or {@code null} for 1 in all dimensions.
+     * @param  offset  the offset for each source dimension, or {@code null} for 0 in all dimensions.
+     * @throws IllegalArgumentException if an array length is not the number of source dimensions.
+     */
+    public void setSourceQuantization(final double[] scale, final double[] offset) {
+        dequantize = coefficients(scale, offset, srcDim);
+    }
+
+    /**
+     * Sets the conversion to apply on target coordinates after the coordinate operation.
+     * Each coordinate value <var>x</var> is converted to a target value <var>q</var> by
+     * <var>q</var> = <var>x</var> × {@code scale[i]} + {@code offset[i]} where <var>i</var> is the dimension.
+     * If the target array is an array of integers, then <var>q</var> is rounded to the nearest integer and
+     * clamped to the range of the integer type. NaN values are stored as 0 in arrays of integers.
+     *
+     * @param  scale   the scale factor for each target dimension, or {@code null} for 1 in all dimensions.
+     * @param  offset  the offset for each target dimension, or {@code null} for 0 in all dimensions.
+     * @throws IllegalArgumentException if an array length is not the number of target dimensions.
+     */
+    public void setTargetQuantization(final double[] scale, final double[] offset) {
+        quantize = coefficients(scale, offset, dstDim);
+    }
+
+    /**
+     * Returns whether points are transformed in an order that preserves spatial locality.
+     *
+     * @return whether points are transformed in Morton order.
+     */
+    public boolean isSpatialOrdering() {
+        return (flags & Transform.REORDER) != 0;
+    }
+
+    /**
+     * Sets whether points should be transformed in an order that preserves spatial locality.
+     * If {@code true}, the points of each batch are sorted along a Morton (Z-order) curve using
+     * their two first coordinates, transformed in that order, then stored in their original order.
+     * The results are the same as without ordering, but operations using datum shift grids may
+     * be faster because of better use of PROJ grid caches. The cost is a temporary native copy
+     * of all coordinates and a sort. This option should not be enabled if the points are already
+     * in a spatially coherent order, for example the vertices of a polyline.
+     *
+     * @param  enabled  whether to transform points in Morton order.
+     */
+    public void setSpatialOrdering(final boolean enabled) {
+        setFlag(Transform.REORDER, enabled);
+    }
+
+    /**
+     * Returns whether repeated coordinate tuples are transformed only once per batch.
+     *
+     * @return whether deduplication is enabled.
+     */
+    public boolean isDeduplication() {
+        return (flags & Transform.DEDUPLICATE) != 0;
+    }
+
+    /**
+     * Sets whether repeated coordinate tuples should be transformed only once per batch.
+     * If {@code true}, tuples having exactly the same source values are detected by hashing in native code,
+     * each distinct tuple is transformed once, and the result is copied to all occurrences.
+     * This is useful for polygon meshes and networks, where many vertices are shared.
+     *
+     * <p>Deduplication has a cost (a temporary native copy of all coordinates and a hash table).
+     * For avoiding to pay that cost when it does not bring any benefit, the rate of duplicated tuples is
+     * estimated on the first few thousands tuples of each batch. If that rate is low, deduplication is
+     * skipped for the batch. Results are the same in all cases.</p>
+     *
+     * @param  enabled  whether to transform repeated tuples only once.
+     */
+    public void setDeduplication(final boolean enabled) {
+        setFlag(Transform.DEDUPLICATE, enabled);
+    }
+
+    /**
+     * Sets the extent of target points to retain by {@link #transform(double[], int, double[], int, int, boolean[])
+     * transform(…, mask)}. Points outside this extent (in target CRS units, before quantization) are counted
+     * in the {@linkplain Summary summary}, excluded from the envelope and marked as not retained in the mask.
+     * A {@code null} value for a bound means that the extent is unbounded in that direction.
+     *
+     * @param  minimum  the minimal coordinate value in each target dimension, or {@code null}.
+     * @param  maximum  the maximal coordinate value in each target dimension, or {@code null}.
+     * @throws IllegalArgumentException if an array length is not the number of target dimensions.
+     */
+    public void setTargetExtent(final double[] minimum, final double[] maximum) {
+        if (minimum == null && maximum == null) {
+            extent = null;
+            return;
+        }
+        final double[] bounds = new double[dstDim * 2];
+        Arrays.fill(bounds, 0, dstDim, Double.NEGATIVE_INFINITY);
+        Arrays.fill(bounds, dstDim, bounds.length, Double.POSITIVE_INFINITY);
+        if (minimum != null) {
+            if (minimum.length != dstDim) {
+                throw new IllegalArgumentException("Expected " + dstDim + " minimal values but got " + minimum.length + '.');
+            }
+            System.arraycopy(minimum, 0, bounds, 0, dstDim);
+        }
+        if (maximum != null) {
+            if (maximum.length != dstDim) {
+                throw new IllegalArgumentException("Expected " + dstDim + " maximal values but got " + maximum.length + '.');
+            }
+            System.arraycopy(maximum, 0, bounds, dstDim, dstDim);
+        }
+        extent = bounds;
+    }
+
+    /**
+     * Returns whether {@code transform(…, mask)} writes only the retained points.
+     *
+     * @return whether the output is compacted.
+     */
+    public boolean isCompaction() {
+        return (flags & Transform.COMPACT) != 0;
+    }
+
+    /**
+     * Sets whether {@link #transform(double[], int, double[], int, int, boolean[]) transform(…, mask)}
+     * should write only the retained points. If {@code true}, the points that failed or are outside the
+     * {@linkplain #setTargetExtent target extent} are not written, and the retained points are stored
+     * consecutively from the destination offset. The number of written points is given by
+     * {@link Summary#getRetainedCount()}. The mask can be used for finding the source of each point.
+     *
+     * @param  enabled  whether to write only the retained points.
+     */
+    public void setCompaction(final boolean enabled) {
+        setFlag(Transform.COMPACT, enabled);
+    }
+
+    /**
+     * Returns whether points are checked against the domain of validity of the operation before the transform.
+     *
+     * @return whether the domain guard is enabled.
+     */
+    public boolean isDomainGuard() {
+        return domainBounds != null;
+    }
+
+    /**
+     * Sets whether points should be checked against the domain of validity of the operation before the transform.
+     * If {@code true}, the source coordinates are converted to geographic coordinates in native code and compared
+     * to the geographic bounding box of the operation domain of validity. Points outside that box are not given
+     * to the operation, which avoids useless grid lookups or meaningless results for operations designed for
+     * a national area. Instead, those points are transformed by the given {@code fallback} transform if non-null
+     * (for example a ballpark transformation), or set to NaN otherwise. NaN values are not reported as errors
+     * by the {@code transform(…)} methods, but are counted as failures in the {@linkplain Summary summary}.
+     *
+     * <p>The domain guard is applied to the transforms of arrays. It is not applied to Arrow and WKB data.</p>
+     *
+     * @param  enabled   whether to check the domain of validity.
+     * @param  fallback  the transform for the points outside the domain, or {@code null} for NaN.
+     *                   Shall have the same number of dimensions than the transform of this batch.
+     * @throws UnsupportedOperationException if the transform is not a coordinate operation with a source CRS.
+     * @throws UnsupportedImplementationException if the fallback is not a PROJ-JNI implementation.
+     * @throws IllegalArgumentException if the fallback does not have the expected number of dimensions.
+     * @throws FactoryException if the operation has no domain of validity, or if the conversion
+     *         of source coordinates to geographic coordinates can not be created.
+     */
+    public void setDomainGuard(final boolean enabled, final MathTransform fallback) throws FactoryException {
+        if (!enabled) {
+            domainBounds  = null;
+            this.fallback = null;
+            return;
+        }
+        if (!(transform instanceof Operation)) {
+            throw new UnsupportedOperationException("The transform has no domain of validity.");
+        }
+        final Operation op = (Operation) transform;
+        final double[] bounds = op.impl.getArrayProperty(Property.DOMAIN_OF_VALIDITY);
+        if (bounds == null) {
+            throw new FactoryException("The operation has no domain of validity.");
+        }
+        TransformPool other = null;
+        boolean otherInverted = false;
+        if (fallback != null) {
+            if (fallback instanceof Operation) {
+                other = ((Operation) fallback).transforms;
+            } else if (fallback instanceof Pipeline) {
+                other = ((Pipeline) fallback).transforms;
+                otherInverted = ((Pipeline) fallback).inverted;
+            } else {
+                throw new UnsupportedImplementationException("fallback", fallback);
+            }
+            if (fallback.getSourceDimensions() != srcDim || fallback.getTargetDimensions() != dstDim) {
+                throw new IllegalArgumentException("Mismatched number of dimensions in the fallback transform.");
+            }
+        }
+        if (domain == null) {
+            final Object crs = op.getSourceCRS();
+            if (!(crs instanceof IdentifiableObject)) {
+                throw new UnsupportedOperationException("The operation has no source CRS.");
+            }
+            final TransformPool pool = new TransformPool(((IdentifiableObject) crs).toWKT(), TransformPool.DOMAIN);
+            try (Context c = Context.acquire()) {
+                pool.release(pool.acquire(c));          // Verify that the conversion can be created.
+            } catch (TransformException e) {
+                pool.dispose();
+                throw new FactoryException(e.getMessage(), e);
+            } catch (FactoryException e) {
+                pool.dispose();
+                throw e;
+            }
+            pool.disposeWhenUnreachable(this);
+            domain = pool;
+        }
+        domainBounds     = bounds;
+        this.fallback    = other;
+        fallbackInverted = otherInverted;
+    }
+
+    /**
+     * Returns the lane in which the transforms are executed.
+     *
+     * @return the lane in which the transforms are executed.
+     */
+    public Priority getPriority() {
+        return priority;
+    }
+
+    /**
+     * Sets the lane in which the transforms are executed. The default value is {@link Priority#INTERACTIVE}.
+     * Large batches which are not latency-sensitive, such as backfills, should be executed in the
+     * {@link Priority#BULK} lane. In that lane, the transforms use PROJ resources that are not shared
+     * with interactive requests, the number of concurrent threads is limited, and batches are split in
+     * chunks of a fixed number of points. Between two chunks, the native resources are given back to
+     * the lane and the thread yields if interactive requests are in progress.
+     * Spatial ordering and deduplication are applied on each chunk separately.
+     *
+     * @param  priority  the lane in which to execute the transforms.
+     */
+    public void setPriority(final Priority priority) {
+        this.priority = Objects.requireNonNull(priority);
+    }
+
+    /**
+     * Sets or clears the given bit in the {@link #flags} bitmask.
+     *
+     * @param  flag     the bit to set or clear.
+     * @param  enabled  whether to set the bit.
+     */
+    private void setFlag(final int flag, final boolean enabled) {
+        if (enabled) {
+            flags |= flag;
+        } else {
+            flags &= ~flag;
+        }
+    }
+
+    /**
+     * Transforms an array of floating point coordinates.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     *                 May be the same than {@code srcPts}.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final double[] srcPts, final int srcOff,
+                          final double[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.DOUBLE, srcOff,
+            dstPts, dstPts.length, Transform.DOUBLE, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms an array of floating point coordinates and computes a summary of the results in the same pass.
+     * The transformed points are classified as failures (NaN or infinite coordinates), outside the
+     * {@linkplain #setTargetExtent target extent}, or retained. Failures are counted instead of causing an
+     * exception. The envelope is computed on the retained points only. If {@code mask} is non-null,
+     * {@code mask[i]} is set to whether the point <var>i</var> is retained. If {@linkplain #setCompaction
+     * compaction} is enabled, only the retained points are written in the destination array.
+     *
+     * <p>All reductions are computed in native code right after the coordinate operation,
+     * on the values before {@linkplain #setTargetQuantization quantization}.</p>
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     *                 May be the same than {@code srcPts}.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @param  mask    where to store whether each point is retained, or {@code null} if not needed.
+     * @return the failure count, the number of points outside the extent and the envelope of retained points.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if the coordinate operation can not be executed.
+     */
+    public Summary transform(final double[] srcPts, final int srcOff,
+                             final double[] dstPts, final int dstOff, final int numPts,
+                             final boolean[] mask) throws TransformException
+    {
+        if (mask != null && mask.length < numPts) {
+            throw new IllegalArgumentException("The mask array is too small.");
+        }
+        final double[] summary = new double[3 + 2*dstDim];
+        Arrays.fill(summary, 3, 3 + dstDim, Double.POSITIVE_INFINITY);
+        Arrays.fill(summary, 3 + dstDim, summary.length, Double.NEGATIVE_INFINITY);
+        run(srcPts, srcPts.length, Transform.DOUBLE, srcOff,
+            dstPts, dstPts.length, Transform.DOUBLE, dstOff, numPts, mask, summary);
+        return new Summary(summary, dstDim);
+    }
+
+    /**
+     * Transforms an array of floating point coordinates and stores the results as integers.
+     * This method is typically used with {@linkplain #setTargetQuantization target quantization}.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final double[] srcPts, final int srcOff,
+                          final int[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.DOUBLE, srcOff,
+            dstPts, dstPts.length, Transform.INT, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms an array of floating point coordinates and stores the results as short integers.
+     * This method is typically used with {@linkplain #setTargetQuantization target quantization}.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final double[] srcPts, final int srcOff,
+                          final short[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.DOUBLE, srcOff,
+            dstPts, dstPts.length, Transform.SHORT, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms an array of integer coordinates and stores the results as floating point values.
+     * This method is typically used with {@linkplain #setSourceQuantization source quantization}.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final int[] srcPts, final int srcOff,
+                          final double[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.INT, srcOff,
+            dstPts, dstPts.length, Transform.DOUBLE, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms an array of short integer coordinates and stores the results as floating point values.
+     * This method is typically used with {@linkplain #setSourceQuantization source quantization}.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final short[] srcPts, final int srcOff,
+                          final double[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.SHORT, srcOff,
+            dstPts, dstPts.length, Transform.DOUBLE, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms an array of integer coordinates and stores the results as integers.
+     * This method is typically used with both source and target quantization.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     *                 May be the same than {@code srcPts}.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transform(final int[] srcPts, final int srcOff,
+                          final int[] dstPts, final int dstOff, final int numPts) throws TransformException
+    {
+        run(srcPts, srcPts.length, Transform.INT, srcOff,
+            dstPts, dstPts.length, Transform.INT, dstOff, numPts, null, null);
+    }
+
+    /**
+     * Transforms the given points forward then backward, and computes statistics about the differences
+     * with the original coordinates. Both directions are applied with the same {@code PJ}, on copies of
+     * the points made by chunks in native code, so the given array is not modified. The differences are
+     * Euclidean distances in units of the source CRS, computed on all source dimensions. Points that can
+     * not be transformed are counted instead of causing an exception.
+     *
+     * <p>Quantization, spatial ordering, deduplication, reductions and domain guard are not applied.</p>
+     *
+     * @param  srcPts      the array containing the source point coordinates. Not modified.
+     * @param  srcOff      the offset to the first point to audit in the source array.
+     * @param  numPts      the number of points to audit.
+     * @param  worstCount  the number of points having the largest errors to report.
+     * @return failure counts, error statistics and the points having the largest errors.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws NoninvertibleTransformException if the coordinate operation has no inverse.
+     * @throws TransformException if the audit can not be executed for another reason.
+     */
+    public Audit audit(final double[] srcPts, final int srcOff, final int numPts, final int worstCount)
+            throws TransformException
+    {
+        if (worstCount < 0) {
+            throw new IllegalArgumentException("Negative number of worst points.");
+        }
+        final double[] statistics = new double[Audit.SIZE];
+        final int[]    worst      = new int[worstCount];
+        final double[] errors     = new double[worstCount];
+        if (numPts > 0) {
+            Operation.ensureValidRange(srcPts.length, srcOff, numPts, srcDim);
+            try (Context c = Context.acquire(priority)) {
+                final Transform tr = transforms.acquire(c, inverted);
+                try {
+                    tr.audit(srcDim, srcPts, srcOff, numPts, statistics, worst, errors);
+                } finally {
+                    transforms.release(tr);
+                }
+            } catch (FactoryException e) {
+                throw canNotDelegateToPROJ(e);
+            }
+        } else {
+            Arrays.fill(statistics, Audit.MAXIMUM, Audit.SIZE, Double.NaN);
+            Arrays.fill(worst, -1);
+            Arrays.fill(errors, Double.NaN);
+        }
+        return new Audit(statistics, worst, errors);
+    }
+
+    /**
+     * Computes the distortion factors of the map projection to the target CRS at the given geographic locations.
+     * The target CRS of the coordinate operation shall be a projected CRS. The source points are (<var>longitude</var>,
+     * <var>latitude</var>) tuples in degrees on the datum of that projected CRS, with longitudes relative to its prime
+     * meridian. This is not necessarily the axis order of the source CRS of the coordinate operation.
+     *
+     * <p>For each point, {@value #NUM_FACTORS} values are stored consecutively in the {@code dstFactors} array,
+     * in the order given by the {@link #MERIDIONAL_SCALE} … {@link #DY_DPHI} constants. If the factors can not
+     * be computed at a point, all its values are set to NaN and the point is counted in the returned value.
+     * The factors are computed by {@code proj_factors(…)} with a {@code PJ} created once and cached.</p>
+     *
+     * <p>Quantization, spatial ordering, deduplication, reductions and domain guard are not applied.</p>
+     *
+     * @param  srcPts      the array containing the geographic coordinates, as (λ,φ) tuples in degrees.
+     * @param  srcOff      the offset to the first point in the source array.
+     * @param  dstFactors  the array where to store the factors, {@value #NUM_FACTORS} values per point.
+     * @param  dstOff      the offset to the location of the first factor to store in the destination array.
+     * @param  numPts      the number of points for which to compute the factors.
+     * @return number of points for which the factors could not be computed.
+     * @throws UnsupportedOperationException if the target CRS is not a projected CRS.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if the factors can not be computed for another reason.
+     */
+    public int factors(final double[] srcPts, final int srcOff, final double[] dstFactors, final int dstOff,
+                       final int numPts) throws TransformException
+    {
+        if (numPts <= 0) {
+            return 0;
+        }
+        Operation.ensureValidRange(srcPts.length, srcOff, numPts, 2);
+        Operation.ensureValidRange(dstFactors.length, dstOff, numPts, NUM_FACTORS);
+        try (Context c = Context.acquire(priority)) {
+            final TransformPool pool = factorsPool();
+            final Transform tr = pool.acquire(c);
+            try {
+                return tr.factors(srcPts, srcOff, dstFactors, dstOff, numPts);
+            } finally {
+                pool.release(tr);
+            }
+        } catch (FactoryException e) {
+            throw canNotDelegateToPROJ(e);
+        }
+    }
+
+    /**
+     * Returns the pool of {@code PJ} for computing the distortion factors, creating it when first needed.
+     *
+     * @return the pool of {@code PJ} for {@link Transform#factors Transform.factors(…)}.
+     * @throws UnsupportedOperationException if the target CRS is not a projected CRS.
+     */
+    private TransformPool factorsPool() {
+        TransformPool pool = factors;
+        if (pool == null) {
+            synchronized (this) {
+                pool = factors;
+                if (pool == null) {
+                    final Object crs = (transform instanceof Operation) ? ((Operation) transform).getTargetCRS() : null;
+                    if (!(crs instanceof CRS.Projected)) {
+                        throw new UnsupportedOperationException("The target CRS is not a projected CRS.");
+                    }
+                    pool = new TransformPool(((CRS.Projected) crs).toWKT(), TransformPool.FACTORS);
+                    pool.disposeWhenUnreachable(this);
+                    factors = pool;
+                }
+            }
+        }
+        return pool;
+    }
+
+    /**
+     * Returns the exception to throw when a {@code PJ} can not be obtained for the transform.
+     *
+     * @param  e  the exception that occurred while creating the {@code PJ}.
+     * @return the exception to throw.
+     */
+    private TransformException canNotDelegateToPROJ(final FactoryException e) {
+        return (transform instanceof Operation) ? ((Operation) transform).canNotDelegateToPROJ(e)
+                                                : ((Pipeline)  transform).canNotDelegateToPROJ(e);
+    }
+
+    /**
+     * A task to execute with a {@code PJ} of the transform. This is used by the adapters
+     * for other formats of coordinates, such as {@link WKBTransform} and {@link TextTransform}.
+     *
+     * @param  <R>  type of the task result.
+     * @param  <E>  type of the checked exception thrown by the task in addition to {@link TransformException}.
+     */
+    @FunctionalInterface
+    interface Task<R, E extends Exception> {
+        /**
+         * Executes the task with the given {@code PJ}.
+         *
+         * @param  tr  the {@code PJ} of the transform, associated to a {@code PJ_CONTEXT} for the current thread.
+         * @return the task result.
+         * @throws TransformException if a point can not be transformed.
+         * @throws E if the task failed for another reason.
+         */
+        R run(Transform tr) throws TransformException, E;
+    }
+
+    /**
+     * Executes the given task with a {@code PJ} of the transform, in the lane of this batch transform.
+     * Only the {@linkplain #getPriority() priority} of this batch transform is used. Options such as
+     * quantization or spatial ordering are ignored, since they apply only to arrays of coordinates.
+     *
+     * @param  <R>   type of the task result.
+     * @param  <E>   type of the checked exception thrown by the task in addition to {@link TransformException}.
+     * @param  task  the task to execute.
+     * @return the task result.
+     * @throws TransformException if the {@code PJ} can not be created or if a point can not be transformed.
+     * @throws E if the task failed for another reason.
+     */
+    final <R, E extends Exception> R execute(final Task<R,E> task) throws TransformException, E {
+        try (Context c = Context.acquire(priority)) {
+            final Transform tr = transforms.acquire(c, inverted);
+            try {
+                return task.run(tr);
+            } finally {
+                transforms.release(tr);
+            }
+        } catch (FactoryException e) {
+            throw canNotDelegateToPROJ(e);
+        }
+    }
+
+    /**
+     * Verifies the arguments, then delegates the work to native code.
+     *
+     * @param  srcPts   the array containing the source point coordinates.
+     * @param  srcLen   length of the source array.
+     * @param  srcType  one of the {@link Transform#DOUBLE}, <i>etc.</i> constants.
+     * @param  srcOff   the offset to the first point to be transformed in the source array.
+     * @param  dstPts   the array into which the transformed point coordinates are returned.
+     * @param  dstLen   length of the destination array.
+     * @param  dstType  one of the {@link Transform#DOUBLE}, <i>etc.</i> constants.
+     * @param  dstOff   the offset to the first transformed point in the destination array.
+     * @param  numPts   the number of point objects to be transformed.
+     * @param  mask     where to store whether each point is retained, or {@code null} if none.
+     * @param  summary  counts and envelope to update, or {@code null} for no reduction.
+     * @throws TransformException if a point can not be transformed.
+     */
+    private void run(Object srcPts, final int srcLen, final int srcType, int srcOff,
+                     final Object dstPts, final int dstLen, final int dstType, final int dstOff,
+                     final int numPts, final boolean[] mask, final double[] summary) throws TransformException
+    {
+        if (numPts > 0) {
+            Operation.ensureValidRange(srcLen, srcOff, numPts, srcDim);
+            Operation.ensureValidRange(dstLen, dstOff, numPts, dstDim);
+            if (srcPts == dstPts && (srcOff != dstOff || srcDim != dstDim)) {
+                /*
+                 * Native code processes the coordinates by chunks, so writing the results of a chunk
+                 * may overwrite the source coordinates of next chunks. Use a copy of the source.
+                 */
+                final int length = srcDim * numPts;
+                final Object copy = Array.newInstance(srcPts.getClass().getComponentType(), length);
+                System.arraycopy(srcPts, srcOff, copy, 0, length);
+                srcPts = copy;
+                srcOff = 0;
+            }
+            /*
+             * In the bulk lane, transform the points by chunks and give the context back to the lane
+             * after each chunk. Like the native code, continue after a failure and report the first
+             * failure at the end, so all points that can be transformed are transformed.
+             */
+            final Priority lane = priority;
+            final double[] guard = domainBounds;
+            final TransformPool other = fallback;
+            final boolean otherInverted = fallbackInverted;
+            final int options = (summary != null) ? flags : flags & ~Transform.COMPACT;
+            final double[] bounds = (summary != null) ? extent : null;
+            final int chunkSize = (lane == Priority.BULK) ? BULK_CHUNK_SIZE : numPts;
+            TransformException failure = null;
+            int done = 0;
+            for (;;) {
+                final int n = Math.min(chunkSize, numPts - done);
+                final int written = (options & Transform.COMPACT) != 0 ? (int) summary[2] : done;
+                try (Context c = Context.acquire(lane)) {
+                    final Transform tr = transforms.acquire(c, inverted);
+                    Transform dg = null, fb = null;
+                    try {
+                        if (guard != null) {
+                            dg = domain.acquire(c);
+                            if (other != null) {
+                                fb = other.acquire(c, otherInverted);
+                            }
+                        }
+                        tr.transformBatch(srcDim, srcPts, srcType, srcOff + done * srcDim, dequantize,
+                                          dstDim, dstPts, dstType, dstOff + written * dstDim, quantize,
+                                          n, options, bounds, mask, done, summary, dg, guard, fb);
+                    } catch (TransformException e) {
+                        if (failure == null) failure = e;
+                    } finally {
+                        if (fb != null) other.release(fb);
+                        if (dg != null) domain.release(dg);
+                        transforms.release(tr);
+                    }
+                } catch (FactoryException e) {
+                    throw canNotDelegateToPROJ(e);
+                }
+                done += n;
+                if (done >= numPts) break;
+                if (Context.isInteractiveBusy()) {
+                    Thread.yield();                 // Let interactive requests run between two chunks.
+                }
+            }
+            if (failure != null) {
+                throw failure;
+            }
+        }
+    }
+
+    /**
+     * Results of the reductions computed by {@link #transform(double[], int, double[], int, int, boolean[])
+     * transform(…, mask)}. Points are classified in three categories: failures (points that PROJ could not
+     * transform), points outside the {@linkplain #setTargetExtent target extent}, and retained points.
+     *
+     * @author  Martin Desruisseaux (Geomatys)
+     * @version 2.1
+     * @since   2.1
+     */
+    public static final class Summary {
+        /**
+         * Number of failures, number of points outside the extent and number of retained points.
+         */
+        private final int failures, outside, retained;
+
+        /**
+         * Minimal and maximal coordinate values of the retained points.
+         */
+        private final double[] minimum, maximum;
+
+        /**
+         * Creates a summary from the values computed by native code.
+         *
+         * @param  values     the counts followed by the minimal values and the maximal values.
+         * @param  dimension  number of target dimensions.
+         */
+        Summary(final double[] values, final int dimension) {
+            failures = (int) values[0];
+            outside  = (int) values[1];
+            retained = (int) values[2];
+            minimum  = Arrays.copyOfRange(values, 3, 3 + dimension);
+            maximum  = Arrays.copyOfRange(values, 3 + dimension, 3 + 2*dimension);
+        }
+
+        /**
+         * Returns the number of points that could not be transformed.
+         * Those points have NaN or infinite coordinates in the output.
+         *
+         * @return number of points that could not be transformed.
+         */
+        public int getFailureCount() {
+            return failures;
+        }
+
+        /**
+         * Returns the number of points successfully transformed but outside the target extent.
+         *
+         * @return number of points outside the target extent.
+         */
+        public int getOutsideCount() {
+            return outside;
+        }
+
+        /**
+         * Returns the number of points successfully transformed and inside the target extent.
+         * If compaction is enabled, this is the number of points written in the destination array.
+         *
+         * @return number of retained points.
+         */
+        public int getRetainedCount() {
+            return retained;
+        }
+
+        /**
+         * Returns the minimal coordinate values of retained points in each target dimension.
+         * If there is no retained point, all values are positive infinity.
+         *
+         * @return minimal coordinate values of the envelope of retained points.
+         */
+        public double[] getMinimum() {
+            return minimum.clone();
+        }
+
+        /**
+         * Returns the maximal coordinate values of retained points in each target dimension.
+         * If there is no retained point, all values are negative infinity.
+         *
+         * @return maximal coordinate values of the envelope of retained points.
+         */
+        public double[] getMaximum() {
+            return maximum.clone();
+        }
+
+        /**
+         * Returns a string representation of this summary for debugging purposes.
+         *
+         * @return a string representation of this summary.
+         */
+        @Override
+        public String toString() {
+            return "Summary[retained=" + retained + ", outside=" + outside + ", failures=" + failures
+                    + ", minimum=" + Arrays.toString(minimum) + ", maximum=" + Arrays.toString(maximum) + ']';
+        }
+    }
+
+    /**
+     * Results of a {@linkplain #audit round-trip audit}. Points are transformed forward then backward,
+     * and the differences with the original coordinates are the errors. Points are classified in three
+     * categories: forward failures, inverse failures, and points which completed the round trip.
+     * The error statistics are computed on the latter only.
+     *
+     * @author  Martin Desruisseaux (Geomatys)
+     * @version 2.1
+     * @since   2.1
+     */
+    public static final class Audit {
+        /**
+         * Indices of values in the array computed by native code.
+         * Must be consistent with the {@code AUDIT_*} constants in native code.
+         */
+        static final int FORWARD_FAILURES = 0, INVERSE_FAILURES = 1, COUNT = 2,
+                MAXIMUM = 3, MEAN = 4, MEDIAN = 5, P95 = 6, P99 = 7, SIZE = 8;
+
+        /**
+         * The failure counts and the error statistics, at the indices given by the constants.
+         */
+        private final double[] statistics;
+
+        /**
+         * Indices of the points having the largest errors, in decreasing order of errors.
+         */
+        private final int[] worst;
+
+        /**
+         * Errors of the points in the {@link #worst} array.
+         */
+        private final double[] worstErrors;
+
+        /**
+         * Creates an audit from the values computed by native code.
+         *
+         * @param  statistics   the failure counts and the error statistics.
+         * @param  worst        indices of the points having the largest errors.
+         * @param  worstErrors  errors of the points in the {@code worst} array.
+         */
+        Audit(final double[] statistics, final int[] worst, final double[] worstErrors) {
+            this.statistics  = statistics;
+            int n = worst.length;
+            while (n > 0 && worst[n-1] < 0) n--;
+            this.worst       = Arrays.copyOf(worst, n);
+            this.worstErrors = Arrays.copyOf(worstErrors, n);
+        }
+
+        /**
+         * Returns the number of points that could not be transformed in the forward direction.
+         *
+         * @return number of forward failures.
+         */
+        public int getForwardFailureCount() {
+            return (int) statistics[FORWARD_FAILURES];
+        }
+
+        /**
+         * Returns the number of points transformed in the forward direction but not in the inverse direction.
+         *
+         * @return number of inverse failures.
+         */
+        public int getInverseFailureCount() {
+            return (int) statistics[INVERSE_FAILURES];
+        }
+
+        /**
+         * Returns the number of points which completed the round trip.
+         * This is the number of points on which the error statistics are computed.
+         *
+         * @return number of points which completed the round trip.
+         */
+        public int getCount() {
+            return (int) statistics[COUNT];
+        }
+
+        /**
+         * Returns the largest error, in units of the source CRS.
+         * This is NaN if no point completed the round trip.
+         *
+         * @return the largest error.
+         */
+        public double getMaximum() {
+            return statistics[MAXIMUM];
+        }
+
+        /**
+         * Returns the mean error, in units of the source CRS.
+         * This is NaN if no point completed the round trip.
+         *
+         * @return the mean error.
+         */
+        public double getMean() {
+            return statistics[MEAN];
+        }
+
+        /**
+         * Returns the error at the given percentile, in units of the source CRS.
+         * Only the 50, 95 and 99 percentiles are computed.
+         * This is NaN if no point completed the round trip.
+         *
+         * @param  percentile  50, 95 or 99.
+         * @return the error at the given percentile.
+         * @throws IllegalArgumentException if the given percentile is not one of the computed ones.
+         */
+        public double getPercentile(final int percentile) {
+            switch (percentile) {
+                case 50: return statistics[MEDIAN];
+                case 95: return statistics[P95];
+                case 99: return statistics[P99];
+                default: throw new IllegalArgumentException("Unsupported percentile: " + percentile);
+            }
+        }
+
+        /**
+         * Returns the indices of the points having the largest errors, in decreasing order of errors.
+         * Indices are relative to the first audited point. The array length is the number of worst
+         * points requested, or less if fewer points completed the round trip.
+         *
+         * @return indices of the points having the largest errors.
+         */
+        public int[] getWorstIndices() {
+            return worst.clone();
+        }
+
+        /**
+         * Returns the errors of the points identified by {@link #getWorstIndices()}, in the same order.
+         *
+         * @return errors of the points having the largest errors.
+         */
+        public double[] getWorstErrors() {
+            return worstErrors.clone();
+        }
+
+        /**
+         * Returns a string representation of this audit for debugging purposes.
+         *
+         * @return a string representation of this audit.
+         */
+        @Override
+        public String toString() {
+            return "Audit[count=" + getCount() + ", forwardFailures=" + getForwardFailureCount()
+                    + ", inverseFailures=" + getInverseFailureCount() + ", maximum=" + getMaximum()
+                    + ", mean=" + getMean() + ", p95=" + statistics[P95] + ']';
+        }
+    }
+}
@@ -32,10 +32,11 @@ import java.util.logging.Logger;
  * A thread processing all {@link Reference} instances enqueued in a {@link ReferenceQueue}.
  * This is the central place where every soft references produced by the PROJ-JNI library
  * are consumed. This thread will invoke the {@link SharedPointer#release()} method for
- * each references enqueued by the garbage collector.
+ * each references enqueued by the garbage collector, or dispose the {@link TransformPool}
+ * of objects which are not wrappers of PROJ objects.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 final class CleanerThread extends Thread {
@@ -92,15 +93,18 @@ final class CleanerThread extends Thread {
                  * may be in the middle of a shutdown. Continue anyway as long as we didn't
                  * received the kill event.
                  */
-                final SharedObjects.Entry ref = (SharedObjects.Entry) queue.remove();
-                if (ref != null) {
+                final Reference<?> ref = queue.remove();
+                if (ref instanceof TransformPool.Disposer) {
+                    ((TransformPool.Disposer) ref).dispose();
+                } else if (ref != null) {
                     /*
                      * If the reference does not implement the SharedObjects.Entry class, we want
                      * the ClassCastException to be logged in the "catch" block since it would be
                      * a programming error that we want to know about.
                      */
-                    ref.cleaner.release();
-                    SharedObjects.CACHE.remove(ref);
+                    final SharedObjects.Entry entry = (SharedObjects.Entry) ref;
+                    entry.cleaner.release();
+                    SharedObjects.CACHE.remove(entry);
                 }
             } catch (Throwable exception) {
                 Logger.getLogger(NativeResource.LOGGER_NAME).log(Level.WARNING, exception.getLocalizedMessage(), exception);
@@ -26,7 +26,10 @@ import java.io.File;
 import java.util.Map;
 import java.util.Deque;
 import java.util.HashMap;
+import java.util.Objects;
 import java.util.concurrent.ConcurrentLinkedDeque;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.atomic.AtomicInteger;
 import java.lang.annotation.Native;
 import org.opengis.util.FactoryException;
 import org.opengis.referencing.operation.TransformException;
@@ -36,6 +39,7 @@ import org.opengis.referencing.operation.TransformException;
  * Wrapper for {@code PJ_CONTEXT}, the PROJ threading context.
  * A {@code PJ_CONTEXT} can be used by only one thread at a time, not necessarily the creator thread.
  * Contexts are stored in a pool so any {@link Context} not in current use can be taken by any thread.
+ * There is one pool for each {@link Priority}, so bulk jobs do not take the contexts of interactive requests.
  * Contexts that have not been used for at least {@value #TIMEOUT} nanoseconds may be disposed.
  *
  * <p>This class holds also all PROJ resources that depends on that particular {@code PJ_CONTEXT} instance.
@@ -64,11 +68,59 @@ final class Context extends NativeResource implements AutoCloseable {
     private static final long TIMEOUT = 1 * 60 * 1000_000_000L;
 
     /**
-     * The previously created {@code PJ_CONTEXT} instances.
-     * Those instances are pushed back to the pool after usage for
-     * allowing the same thread or another thread to use them again.
+     * The resources reserved to a {@link Priority}. Each lane has its own pool of contexts,
+     * so a lane never takes the contexts of another lane, and an optional limit on the number
+     * of contexts used concurrently.
      */
-    private static final Deque<Context> CONTEXTS = new ConcurrentLinkedDeque<>();
+    private static final class Lane {
+        /**
+         * The previously created {@code PJ_CONTEXT} instances.
+         * Those instances are pushed back to the pool after usage for
+         * allowing the same thread or another thread to use them again.
+         */
+        final Deque<Context> contexts = new ConcurrentLinkedDeque<>();
+
+        /**
+         * Permits for using a context of this lane, or {@code null} if there is no limit.
+         */
+        final Semaphore permits;
+
+        /**
+         * Number of contexts of this lane which are currently in use.
+         */
+        final AtomicInteger active = new AtomicInteger();
+
+        /**
+         * Creates a lane with a concurrency limit given by the specified system property.
+         *
+         * @param  property      name of the system property for the maximal number of concurrent threads.
+         * @param  defaultValue  the limit to use if the property is not set, or 0 for no limit.
+         */
+        Lane(final String property, final int defaultValue) {
+            final Integer n = Integer.getInteger(property);
+            final int limit = (n != null) ? Math.max(0, n) : defaultValue;
+            permits = (limit != 0) ? new Semaphore(limit, true) : null;
+        }
+    }
+
+    /**
+     * The resources of each lane, indexed by {@link Priority} ordinal values.
+     * The system properties are documented in the package javadoc.
+     */
+    private static final Lane[] LANES = {
+        new Lane("org.osgeo.proj.interactiveThreads", 0),
+        new Lane("org.osgeo.proj.bulkThreads", Math.max(1, Runtime.getRuntime().availableProcessors() - 1))
+    };
+
+    /**
+     * The priority of the work done with this context.
+     */
+    final Priority priority;
+
+    /**
+     * The lane which owns this context.
+     */
+    private final Lane lane;
 
     /**
      * Timestamp (as given by {@link System#nanoTime()}) of last use of this context.
@@ -90,14 +142,23 @@ final class Context extends NativeResource implements AutoCloseable {
      */
     private final Map<String,AuthorityFactory> factories = new HashMap<>();
 
+    /**
+     * Value of the {@code "org.osgeo.proj.data"} system property when the last context was created.
+     * Used for detecting changes of the search path, which may change the database.
+     */
+    private static volatile String lastSearchPath;
+
     /**
      * Creates and wraps a new {@code PJ_CONTEXT}.
      * The search path system property is documented in the package javadoc.
      *
+     * @param  priority  the priority of the work to be done with this context.
      * @throws FactoryException if the PROJ object can not be allocated.
      */
-    private Context() throws FactoryException {
-        super(create(System.getProperty("org.osgeo.proj.data"), File.pathSeparatorChar));
+    private Context(final Priority priority) throws FactoryException {
+        super(create(searchPath(), File.pathSeparatorChar));
+        this.priority = priority;
+        this.lane = LANES[priority.ordinal()];
     }
 
     /**
@@ -110,6 +171,34 @@ final class Context extends NativeResource implements AutoCloseable {
      */
     private static native long create(String searchPath, char pathSeparator);
 
+    /**
+     * Returns the search path of PROJ resource files to give to new contexts. If that path changed since
+     * the creation of the last context, then the codes that were not found in the previous database are
+     * forgotten.
+     *
+     * @return the location of PROJ resource files, or {@code null} for default.
+     */
+    private static String searchPath() {
+        final String path = System.getProperty("org.osgeo.proj.data");
+        if (!Objects.equals(path, lastSearchPath)) {
+            lastSearchPath = path;
+            AuthorityFactory.API.clearMissingCodes();
+        }
+        return path;
+    }
+
+    /**
+     * Creates a context which is not managed by the pools. This is used by the {@link Reclaimer},
+     * which needs its own context for destroying {@code PJ} objects outside the threads that used them.
+     * The caller is responsible for using the returned context in only one thread at a time.
+     *
+     * @return wrapper for a new {@code PJ_CONTEXT} structure.
+     * @throws FactoryException if the PROJ object can not be allocated.
+     */
+    static Context createDetached() throws FactoryException {
+        return new Context(Priority.BULK);
+    }
+
     /**
      * Gets a PROJ context, creating a new one if needed.
      * This method shall be invoked in a {@code try} block as below:
@@ -122,13 +211,56 @@ final class Context extends NativeResource implements AutoCloseable {
      * }
      *
      * All objects obtained from {@link Context} shall be used inside the {@code try} block.
+     * The context is taken from the {@linkplain Priority#INTERACTIVE interactive} lane.
      *
      * @return wrapper for the {@code PJ_CONTEXT} structure, together with resources that depends on it.
      * @throws FactoryException if the PROJ object can not be allocated.
      */
     static Context acquire() throws FactoryException {
-        final Context c = CONTEXTS.pollLast();
-        return (c != null) ? c : new Context();
+        return acquire(Priority.INTERACTIVE);
+    }
+
+    /**
+     * Gets a PROJ context from the lane of the given priority, creating a new one if needed.
+     * If the lane has a concurrency limit and that limit is reached, then this method blocks
+     * until another thread closes a context of the same lane.
+     *
+     * @param  priority  the lane from which to take the context.
+     * @return wrapper for the {@code PJ_CONTEXT} structure, together with resources that depends on it.
+     * @throws FactoryException if the PROJ object can not be allocated or if the thread has been interrupted.
+     */
+    static Context acquire(final Priority priority) throws FactoryException {
+        final Lane lane = LANES[priority.ordinal()];
+        if (lane.permits != null) try {
+            lane.permits.acquire();
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new FactoryException("Interrupted while waiting for a PROJ context.", e);
+        }
+        boolean success = false;
+        try {
+            Context c = lane.contexts.pollLast();
+            if (c == null) {
+                c = new Context(priority);
+            }
+            lane.active.incrementAndGet();
+            success = true;
+            return c;
+        } finally {
+            if (!success && lane.permits != null) {
+                lane.permits.release();
+            }
+        }
+    }
+
+    /**
+     * Returns whether at least one context of the {@linkplain Priority#INTERACTIVE interactive} lane is in use.
+     * This is used by long bulk tasks for deciding whether to give other threads an opportunity to run.
+     *
+     * @return whether interactive work is in progress.
+     */
+    static boolean isInteractiveBusy() {
+        return LANES[Priority.INTERACTIVE.ordinal()].active.get() != 0;
     }
 
     /**
@@ -153,6 +285,27 @@ final class Context extends NativeResource implements AutoCloseable {
         return factory;
     }
 
+    /**
+     * Returns whether this context has an authority factory for the given authority.
+     * Used only for describing the cache state in {@link SlowCall} records.
+     *
+     * @param  authority  name of the authority.
+     * @return whether a factory for the given authority has already been created in this context.
+     */
+    final boolean hasFactory(final String authority) {
+        return factories.containsKey(authority);
+    }
+
+    /**
+     * Returns whether the database context has already been created for this context.
+     * Used only for describing the cache state in {@link SlowCall} records.
+     *
+     * @return whether the database context exists.
+     */
+    final boolean hasDatabase() {
+        return database != 0;
+    }
+
     /**
      * Invokes the C++ {@code createFromUserInput(text, ctx)} method.
      *
@@ -173,23 +326,60 @@ final class Context extends NativeResource implements AutoCloseable {
      */
     native long createPJ(NativeResource operation) throws TransformException;
 
+    /**
+     * Creates the PROJ {@code PJ} object for the given PROJ string, without building a coordinate operation.
+     * The {@code PJ} shall be used in the same thread than this {@code Context}.
+     *
+     * @param  definition  the PROJ string, typically a {@code "+proj=pipeline"} definition.
+     * @return address of the {@code PJ} created by this method, or 0 if out of memory.
+     * @throws FactoryException if the PROJ string is invalid or does not define a coordinate operation.
+     */
+    native long createPipeline(String definition) throws FactoryException;
+
+    /**
+     * Creates a PROJ {@code PJ} object converting coordinates in the given CRS to geographic coordinates
+     * (longitude first, in degrees) on the same datum. This is used for checking if points are inside
+     * the domain of validity of a coordinate operation having the given CRS as its source.
+     *
+     * @param  definition  the definition (typically WKT) of the source CRS.
+     * @return address of the {@code PJ} created by this method, or 0 if out of memory.
+     * @throws FactoryException if the CRS has no geographic CRS or the conversion can not be created.
+     */
+    native long createDomainPJ(String definition) throws FactoryException;
+
+    /**
+     * Creates a PROJ {@code PJ} object for computing the map projection distortion factors of the given
+     * projected CRS. The {@code PJ} converts geographic coordinates in radians (longitude first) on the
+     * datum of the projected CRS to the projected coordinates, as expected by {@code proj_factors(…)}.
+     *
+     * @param  definition  the definition (typically WKT) of the projected CRS.
+     * @return address of the {@code PJ} created by this method, or 0 if out of memory.
+     * @throws FactoryException if the CRS is not a projected CRS or the conversion can not be created.
+     */
+    native long createFactorsPJ(String definition) throws FactoryException;
+
     /**
      * Disposes this context. This method returns the {@code PJ_CONTEXT} structure to the pool,
      * so it can be reused again by this thread or by another thread. Old {@code PJ_CONTEXT}s
-     * not used for a long time are opportunistically discarded.
+     * not used for a long time are opportunistically discarded by the {@link Reclaimer} thread.
      *
      * <p>This method should not be invoked explicitly. Instead it is invoked in try-with-resource
      * statements as documented in {@linkplain Context class javadoc}.</p>
      */
     @Override
     public final void close() {
+        lane.active.decrementAndGet();
         try {
-            destroyExpired();
+            destroyExpired(lane.contexts);
             lastUse = System.nanoTime();
-            CONTEXTS.add(this);
+            lane.contexts.add(this);
         } catch (Throwable e) {
             destroy();              // We will forget this instance (it has not been pushed back to the pool).
             throw e;
+        } finally {
+            if (lane.permits != null) {
+                lane.permits.release();
+            }
         }
     }
 
@@ -197,39 +387,65 @@ final class Context extends NativeResource implements AutoCloseable {
      * Disposes all {@code PJ_CONTEXT} structures which have not been used for at least {@value #TIMEOUT} nanoseconds.
      * This method should be invoked when there is a chance that some contexts are no longer needed, for example when
      * some PROJ objects are garbage collected.
+     *
+     * @param  contexts  the pool of contexts of a lane.
      */
-    private static void destroyExpired() {
-        Context c = CONTEXTS.peekFirst();
+    private static void destroyExpired(final Deque<Context> contexts) {
+        Context c = contexts.peekFirst();
         if (c != null) {
             final long time = System.nanoTime();
             while (time - c.lastUse > TIMEOUT) {
-                c = CONTEXTS.pollFirst();                   // Verify again since it may have changed concurrently.
+                c = contexts.pollFirst();                   // Verify again since it may have changed concurrently.
                 if (c == null) return;
                 if (time - c.lastUse <= TIMEOUT) try {
                     c.lastUse = time;                       // Pretend we just used that context, for consistent ordering.
-                    CONTEXTS.add(c);
+                    contexts.add(c);
                     return;
                 } catch (Throwable e) {
                     c.destroy();
                     throw e;
                 }
-                c.destroy();
-                c = CONTEXTS.peekFirst();                   // Check if next context should also be disposed.
+                Reclaimer.destroy(c::destroy);              // Closes databases and grids in background.
+                c = contexts.peekFirst();                   // Check if next context should also be disposed.
                 if (c == null) break;
             }
         }
     }
 
+    /**
+     * Returns the number of contexts in the pools of all lanes, waiting for reuse.
+     * Used for diagnostic of memory growth.
+     *
+     * @return number of pooled contexts.
+     */
+    static int pooledCount() {
+        int n = 0;
+        for (final Lane lane : LANES) {
+            n += lane.contexts.size();
+        }
+        return n;
+    }
+
     /**
      * Destroys all {@code PJ_CONTEXT} instances. This is invoked at JVM shutdown time.
      */
     static void destroyAll() {
-        Context c;
-        while ((c = CONTEXTS.poll()) != null) {
-            c.destroy();
+        for (final Lane lane : LANES) {
+            Context c;
+            while ((c = lane.contexts.poll()) != null) {
+                c.destroy();
+            }
         }
     }
 
+    /**
+     * Destroys a context created by {@link #createDetached()}.
+     * The caller shall ensure that the context is not used anymore.
+     */
+    final void destroyDetached() {
+        destroy();
+    }
+
     /**
      * Disposes all native resources associated to this context. First, this method releases all
      * {@code osgeo::proj::io::AuthorityFactory} or similar objects. Then {@code PJ_CONTEXT} is
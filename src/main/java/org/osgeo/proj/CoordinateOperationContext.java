@@ -36,6 +36,7 @@ import org.opengis.metadata.extent.Extent;
  * <ul>
  *   <li>The {@linkplain #setAreaOfInterest(Extent) area of interest}.</li>
  *   <li>The {@linkplain #setDesiredAccuracy(double) desired accuracy}.</li>
+ *   <li>Whether to {@linkplain #setPreferFastest(boolean) prefer the fastest operation} meeting that accuracy.</li>
  * </ul>
  *
  * <h2>Limitations</h2>
@@ -44,7 +45,7 @@ import org.opengis.metadata.extent.Extent;
  * and rarely needs to be shared between different threads.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  *
  * @see <a href="https://proj.org/development/reference/cpp/operation.html#_CPPv4N5osgeo4proj9operation26CoordinateOperationContextE">PROJ C++ API</a>
@@ -108,6 +109,11 @@ public class CoordinateOperationContext implements Cloneable, Serializable {
      */
     private boolean discardSuperseded;
 
+    /**
+     * Whether to select the fastest operation among the ones meeting the desired accuracy.
+     */
+    private boolean preferFastest;
+
     /**
      * Creates a new context initialized to default value.
      */
@@ -348,6 +354,49 @@ public class CoordinateOperationContext implements Cloneable, Serializable {
         return discardSuperseded;
     }
 
+    /**
+     * Sets whether to select the fastest operation among the ones meeting the {@linkplain #setDesiredAccuracy
+     * desired accuracy}. By default, PROJ selects the most accurate operation even if a cheaper one would be
+     * sufficient. For example, a 1 metre Helmert transformation may be sufficient for map rendering at 10 metres
+     * resolution, but a 5 centimetres grid-based transformation would be selected by default.
+     *
+     * <p>When this flag is set and a desired accuracy is specified, the cost of each candidate operation is
+     * measured by transforming a grid of sample points in the {@linkplain #setAreaOfInterest area of interest}
+     * (or in the domain of validity of the source CRS if no area of interest is specified).
+     * Operations failing on most sample points are not selected.
+     * The measurements are cached, so they are done only once per operation and area.
+     * This flag has no effect if the desired accuracy is 0 (best accuracy available).</p>
+     *
+     * <p>Because the costs are wall-clock timings, the selected operation is not deterministic.
+     * It may differ between machines, between executions, or after the cache of measurements has been cleared.
+     * A candidate is preferred to a more accurate one only if it is significantly faster, which reduces
+     * the variations when the costs are similar. The selection is logged at {@code FINE} level when it
+     * differs from the previous selection among the same candidates.
+     * Applications needing reproducible results should leave this flag to {@code false}.</p>
+     *
+     * <p>The default is false.</p>
+     *
+     * @param  fastest  whether to prefer the fastest operation meeting the desired accuracy.
+     *
+     * @since 2.1
+     */
+    public void setPreferFastest(final boolean fastest) {
+        preferFastest = fastest;
+    }
+
+    /**
+     * Returns whether to select the fastest operation among the ones meeting the desired accuracy.
+     * This is the value given in last call to the {@linkplain #setPreferFastest setter},
+     * or the default value ({@code false}) if no value has been explicitly set.
+     *
+     * @return whether to prefer the fastest operation meeting the desired accuracy.
+     *
+     * @since 2.1
+     */
+    public boolean getPreferFastest() {
+        return preferFastest;
+    }
+
     /**
      * Returns a hash code value for this context.
      * This value does not need to be stable between different versions of this class.
@@ -357,7 +406,7 @@ public class CoordinateOperationContext implements Cloneable, Serializable {
     @Override
     public int hashCode() {
         return Objects.hash(authority, areaOfInterest, desiredAccuracy, sourceAndTargetCRSExtentUse,
-                spatialCriterion, gridAvailabilityUse, allowUseIntermediateCRS, discardSuperseded);
+                spatialCriterion, gridAvailabilityUse, allowUseIntermediateCRS, discardSuperseded, preferFastest);
     }
 
     /**
@@ -384,6 +433,7 @@ public class CoordinateOperationContext implements Cloneable, Serializable {
         return Objects.equals(areaOfInterest, other.areaOfInterest) && authority.equals(other.authority) &&
                Double.doubleToLongBits(other.desiredAccuracy) == Double.doubleToLongBits(desiredAccuracy)
                                     && other.discardSuperseded           == discardSuperseded
+                                    && other.preferFastest               == preferFastest
                                     && other.sourceAndTargetCRSExtentUse == sourceAndTargetCRSExtentUse
                                     && other.spatialCriterion            == spatialCriterion
                                     && other.gridAvailabilityUse         == gridAvailabilityUse
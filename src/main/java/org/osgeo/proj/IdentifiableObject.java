@@ -50,16 +50,42 @@ import org.opengis.metadata.extent.Extent;
  * We consider those other types as kind of identifiable objects too since they are usually created
  * from EPSG codes.
  *
+ * <p>The native resources are released automatically after the wrapper has been garbage collected.
+ * They can also be released explicitly by a call to {@link #close()}, either directly or through a
+ * {@link ProjScope}.</p>
+ *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
-abstract class IdentifiableObject implements Formattable {
+abstract class IdentifiableObject implements Formattable, AutoCloseable {
     /**
      * Provides access to the PROJ implementation.
      */
     final SharedPointer impl;
 
+    /**
+     * Whether this wrapper has been requested from the cache since the last time that the CLOCK
+     * algorithm examined it. Used only when {@link SharedObjects} is in bounded mode.
+     * This field is set by native code when an existing wrapper is returned.
+     * Accesses are not synchronized since this is only a hint for the eviction policy.
+     */
+    boolean recentlyUsed;
+
+    /**
+     * Index of the slot where this wrapper has been stored in the ring of {@link SharedObjects} in bounded mode,
+     * or -1 if none. This is only a hint for removing this wrapper from the ring without scanning the whole ring.
+     * The value may be stale if this wrapper has been evicted since.
+     */
+    int slot = -1;
+
+    /**
+     * The entry which will release PROJ resources when this wrapper is garbage collected,
+     * or {@code null} if none. Used by {@link SharedObjects} for discarding this wrapper.
+     * Taken atomically by {@link SharedObjects#discard(IdentifiableObject)}.
+     */
+    volatile SharedObjects.Entry entry;
+
     /**
      * Creates a wrapper for the given pointer to a PROJ structure.
      * It is caller's responsibility to invoke {@link #releaseWhenUnreachable()} after construction.
@@ -86,20 +112,32 @@ abstract class IdentifiableObject implements Formattable {
     /**
      * Registers a cleaner which will release PROJ resources when this {@code IdentifiableObject}
      * is garbage collected. This method shall be invoked exactly once after construction.
-     * This method usually returns {@code this}, unless another wrapper has been created concurrently
-     * for the same PROJ object. In the later case, {@code this} wrapper is destroyed and the existing
-     * wrapper is returned.
+     * Note that another wrapper may have been created concurrently for the same PROJ object.
+     * In such case, the native code closes the wrapper which has been registered last.
      *
-     * @return the wrapper to use (usually {@code this} unless another wrapper has been created concurrently).
+     * @return {@code this}, for convenience.
      */
     final IdentifiableObject releaseWhenUnreachable() {
-        final IdentifiableObject existing = SharedObjects.CACHE.putIfAbsent(impl.rawPointer(), this);
-        if (existing == null) {
-            return this;            // Normal case.
-        } else {
-            impl.release();         // Destroy this wrapper, use the existing one instead.
-            return existing;
-        }
+        SharedObjects.CACHE.register(this);
+        ProjScope.register(this);
+        return this;
+    }
+
+    /**
+     * Releases the native PROJ resources used by this object. This method removes this wrapper from
+     * the cache of shared objects, then releases the native object. After this method call, this object
+     * can not be used anymore. Invoking this method many times has no effect.
+     *
+     * <p>Since PROJ-JNI may return the same wrapper to different callers asking for the same object,
+     * this method should be invoked only when the caller knows that no other code is using this object.
+     * Invoking this method while another thread is using this object results in undefined behavior.</p>
+     *
+     * @see ProjScope
+     */
+    @Override
+    public void close() {
+        SharedObjects.CACHE.discard(this);
+        impl.release();
     }
 
     /**
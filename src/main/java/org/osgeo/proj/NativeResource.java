@@ -66,6 +66,14 @@ abstract class NativeResource {
      */
     static final String UNSUPPORTED = "Not supported.";
 
+    /**
+     * Indices of the counters filled by {@link #resourceCounts(long[])}: number of {@code std::shared_ptr}
+     * blocks allocated for Java wrappers, number of {@code PJ_CONTEXT}, number of {@code PJ} created for
+     * transforms, and number of bytes in use by the C allocator (or -1 if unknown).
+     */
+    @Native
+    static final int SHARED_POINTERS = 0, CONTEXTS = 1, TRANSFORMS = 2, MALLOC_IN_USE = 3, NUM_COUNTERS = 4;
+
     /**
      * The pointer to PROJ structure allocated in the C/C++ heap. This value has no meaning in Java code.
      * <strong>Do not modify</strong>, since this value is required for using PROJ. Do not rename neither,
@@ -108,6 +116,16 @@ abstract class NativeResource {
      */
     static native String version();
 
+    /**
+     * Gets the numbers of native resources currently allocated by the bindings.
+     * This is used for detecting memory growth in long-running applications.
+     *
+     * @param  counts  an array of length {@link #NUM_COUNTERS} where to store the counters.
+     *
+     * @see Proj#getResourceCounts()
+     */
+    static native void resourceCounts(long[] counts);
+
     /**
      * Returns an absolute path to the Java Native Interface C/C++ code.
      * If the resources can not be accessed by an absolute path,
@@ -212,19 +230,6 @@ abstract class NativeResource {
      */
     private static native void initialize();
 
-    /**
-     * Verifies if a wrapper already exists for the given object. This method is invoked by native code;
-     * it shall not be moved or have method signature modified unless the C++ binding is updated accordingly.
-     * If an exception is thrown in this Java method, the native method will release the memory allocated
-     * for {@code rawPointer}.
-     *
-     * @param  rawPointer  raw (non-shared) pointer to the PROJ object. Used for identification only.
-     * @return existing wrapper for the given object, or {@code null} if none.
-     */
-    private IdentifiableObject findWrapper(final long rawPointer) {
-        return SharedObjects.CACHE.get(rawPointer);
-    }
-
     /**
      * Creates an object of the given type. This method is invoked by native code; it shall not be moved,
      * renamed or have method signature modified unless the C++ bindings are updated accordingly.
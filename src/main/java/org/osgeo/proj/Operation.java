@@ -55,30 +55,10 @@ import org.opengis.referencing.operation.TransformException;
  * Each subtype is represented by an inner class in this file.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 class Operation extends ParameterGroup implements CoordinateOperation, MathTransform {
-    /**
-     * The maximum number of {@link Transform} instances to cache. This maximum should be the expected
-     * maximum number of threads (or the "optimal" number of threads) using the same {@link Operation}
-     * concurrently. A low value does not necessarily block more threads from using {@code Operation},
-     * but the extra threads may observe a performance degradation.
-     */
-    private static final int NUM_THREADS;
-    static {
-        final Integer n = Integer.getInteger("org.osgeo.proj.maxThreadsPerInstance");
-        /*
-         * The default value below (4) is arbitrary. If that default value is modified,
-         * then the documentation in package-info.java file should be updated accordingly.
-         * The maximum is also arbitrary; we need to put a relatively low maximum because
-         * the simple algorithm used for the `transforms` array does not scale to a large
-         * number of entries. It should not be necessary to allow high numbers because it
-         * is only the maximum number of threads per Operation instance, not a global maximum.
-         */
-        NUM_THREADS = (n != null) ? Math.max(1, Math.min(16, n)) : 4;
-    }
-
     /**
      * The dimensions of source and target coordinate reference systems, or 0 if unknown.
      */
@@ -92,22 +72,18 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
     private transient Operation inverse;
 
     /**
-     * The objects which will perform the actual coordinate operations.
-     * Each {@code Transform} instance can be used by only one thread at a time.
-     * We cache the {@code Transform} instances after use so they can be reused
-     * by the same thread or another thread.
-     *
-     * <p>The array length is an arbitrary limit on the number of instances to cache,
-     * but this will not limit the number of concurrent threads doing transformations.
-     * It only means that the additional threads will go through the most costly process
-     * of creating new {@link Transform} instances.</p>
+     * The message of the exception thrown when a {@code PJ} can not be created, computed when first needed.
+     * Cached for avoiding a native call to {@link #getName()} each time that a remembered failure is reported.
      *
-     * <p><b>Design note:</b> the use of {@link java.util.concurrent.ArrayBlockingQueue}
-     * would be more efficient, but it is also a relatively heavy class for this simple need.
-     * We use an array for now, with the requirement that all accesses to this array must be
-     * synchronized of {@code transforms}.</p>
+     * @see #canNotDelegateToPROJ(FactoryException)
      */
-    private final Transform[] transforms;
+    private transient volatile String delegationFailure;
+
+    /**
+     * The objects which will perform the actual coordinate operations.
+     * This is a reference to the pool owned by the {@link Cleaner}.
+     */
+    final TransformPool transforms;
 
     /**
      * Task executed when the enclosing {@link Operation} is garbage collected.
@@ -117,10 +93,9 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
      */
     private static final class Cleaner extends SharedPointer {
         /**
-         * A copy of the {@link Operation#transforms} reference.
-         * They are the references to {@code PJ} objects to destroy.
+         * The cache of {@code PJ} objects to destroy when the operation is released.
          */
-        private final Transform[] transforms;
+        private final TransformPool transforms;
 
         /**
          * Wraps the shared pointer at the given address.
@@ -131,28 +106,17 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
          */
         Cleaner(final long ptr) throws FactoryException {
             super(ptr);
-            transforms = new Transform[NUM_THREADS];
+            transforms = new TransformPool(this);
         }
 
         /**
-         * Invoked by the cleaner thread when the {@link Operation} has been garbage collected.
-         * This method destroy all @code PJ} objects, then the PROJ {@code CoordinateOperation}.
+         * Invoked by the cleaner thread when the {@link Operation} has been garbage collected,
+         * or by {@link Operation#close()} when the operation is closed explicitly.
+         * This method destroy all {@code PJ} objects, then the PROJ {@code CoordinateOperation}.
          */
         @Override
         final void release() {
-            /*
-             * Synchronization should not be needed since the array should not be used anymore.
-             * But we still want the memory barrier effect, and the synchronization is a safety.
-             */
-            synchronized (transforms) {
-                for (int i=transforms.length; --i >= 0;) {
-                    final Transform tr = transforms[i];
-                    if (tr != null) {
-                        transforms[i] = null;       // Theoretically not needed but done as a safety.
-                        tr.destroy();
-                    }
-                }
-            }
+            transforms.dispose();
             super.release();
         }
     }
@@ -506,36 +470,65 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
      * @return the {@code PJ} wrapper for the current thread.
      * @throws TransformException if the {@code PJ} object can not be created.
      */
-    private Transform acquire(final Context c) throws FactoryException, TransformException {
-        synchronized (transforms) {
-            for (int i=transforms.length; --i >= 0;) {
-                final Transform tr = transforms[i];
-                if (tr != null) {
-                    transforms[i] = null;
-                    tr.assign(c);
-                    return tr;
-                }
-            }
-        }
-        return new Transform(impl, c);
+    final Transform acquire(final Context c) throws FactoryException, TransformException {
+        return transforms.acquire(c);
     }
 
     /**
-     * Releases the {@code PJ} wrapper, or destroys it if the cache is full.
+     * Releases the {@code PJ} wrapper, or destroys it if the cache is full or the operation has been closed.
      *
      * @param  tr  wrapper of the {@code PJ} to cache for reuse or to destroy.
      */
-    private void release(final Transform tr) {
-        synchronized (transforms) {
-            for (int i=transforms.length; --i >= 0;) {
-                if (transforms[i] == null) {
-                    transforms[i] = tr;
-                    tr.assign(null);
-                    return;
-                }
+    final void release(final Transform tr) {
+        transforms.release(tr);
+    }
+
+    /**
+     * Phases of {@link #run(int, double[], int, int)} reported in {@link SlowCall} records.
+     */
+    static final String[] TRANSFORM_PHASES = {"context", "acquire PJ", "transform"};
+
+    /**
+     * Transforms in-place the coordinates in the given array.
+     * The call is recorded if it exceeds the {@linkplain SlowCall slow-call} threshold.
+     *
+     * @param  dimension    the dimension of each coordinate tuple.
+     * @param  coordinates  the coordinates to transform.
+     * @param  offset       index of the first coordinate value to transform.
+     * @param  numPts       number of points to transform.
+     * @throws TransformException if a point can not be transformed.
+     */
+    private void run(final int dimension, final double[] coordinates, final int offset, final int numPts)
+            throws TransformException
+    {
+        final long start = SlowCall.now();
+        long acquired = 0, created = 0;
+        boolean recycled = false;
+        Throwable failure = null;
+        try (Context c = Context.acquire()) {
+            acquired = SlowCall.now(start);
+            final Transform tr = acquire(c);
+            recycled = tr.recycled;
+            created = SlowCall.now(start);
+            try {
+                tr.transform(dimension, coordinates, offset, numPts);
+            } finally {
+                release(tr);
+            }
+        } catch (FactoryException e) {
+            failure = e;
+            throw canNotDelegateToPROJ(e);
+        } catch (Throwable e) {
+            failure = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                SlowCall.record("Transform.transform",
+                        SlowCall.label(getSourceCRS()) + " → " + SlowCall.label(getTargetCRS()),
+                        numPts, recycled ? "PJ reused" : "PJ created", failure,
+                        start, TRANSFORM_PHASES, acquired, created, SlowCall.now(start));
             }
         }
-        tr.destroy();
     }
 
     /**
@@ -544,7 +537,11 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
      * @param  e  the exception that occurred when trying to get the PROJ object.
      * @return the exception to throw.
      */
-    private TransformException canNotDelegateToPROJ(FactoryException e) {
+    final TransformException canNotDelegateToPROJ(FactoryException e) {
+        String message = delegationFailure;
+        if (message != null) {
+            return new TransformException(message, e);
+        }
         Exception suppressed = null;
         String name = null;
         try {
@@ -554,9 +551,12 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
             suppressed = s;
         }
         if (name == null) name = "?";
-        TransformException t = new TransformException("Can not delegate “" + name + "” to PROJ.", e);
+        message = "Can not delegate “" + name + "” to PROJ.";
+        TransformException t = new TransformException(message, e);
         if (suppressed != null) {
             t.addSuppressed(suppressed);
+        } else {
+            delegationFailure = message;
         }
         return t;
     }
@@ -587,16 +587,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
         /*
          * Delegate the transform to PROJ, which will overwrite the coordinates in-place.
          */
-        try (Context c = Context.acquire()) {
-            final Transform tr = acquire(c);
-            try {
-                tr.transform(ordinates.length, ordinates, 0, 1);
-            } finally {
-                release(tr);
-            }
-        } catch (FactoryException e) {
-            throw canNotDelegateToPROJ(e);
-        }
+        run(ordinates.length, ordinates, 0, 1);
         /*
          * Copy the result to final location.
          */
@@ -625,7 +616,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
      * @param dimension    number of dimensions. Must be positive.
      * @throws IllegalArgumentException if the offset or number of points is out of bounds.
      */
-    private static void ensureValidRange(final int arrayLength, final int offset, final int numPts, final int dimension) {
+    static void ensureValidRange(final int arrayLength, final int offset, final int numPts, final int dimension) {
         if (offset < 0 || Math.addExact(offset, Math.multiplyExact(numPts, dimension)) > arrayLength) {
             if (offset < 0 || offset >= arrayLength) {
                 throw new IllegalArgumentException("Offset " + offset + " is out of bounds.");
@@ -792,16 +783,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
              * Delegate the transform to PROJ, which will overwrite the coordinates in-place.
              * If we used a temporary buffer, we will need to copy the results to `dstPts`.
              */
-            try (Context c = Context.acquire()) {
-                final Transform tr = acquire(c);
-                try {
-                    tr.transform(dimension, buffer, bufOff, numPts);
-                } finally {
-                    release(tr);
-                }
-            } catch (FactoryException e) {
-                throw canNotDelegateToPROJ(e);
-            }
+            run(dimension, buffer, bufOff, numPts);
             if (buffer != dstPts) {
                 copy(buffer, bufOff, dimension,
                      dstPts, dstOff, dstDim, numPts);
@@ -833,16 +815,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
             final int dimension = Math.max(srcDim, dstDim);
             final double[] buffer = new double[dimension * numPts];
             floatsToDoubles(srcPts, srcOff, srcDim, buffer, 0, dimension, numPts);
-            try (Context c = Context.acquire()) {
-                final Transform tr = acquire(c);
-                try {
-                    tr.transform(dimension, buffer, 0, numPts);
-                } finally {
-                    release(tr);
-                }
-            } catch (FactoryException e) {
-                throw canNotDelegateToPROJ(e);
-            }
+            run(dimension, buffer, 0, numPts);
             doublesToFloats(buffer, 0, dimension, dstPts, dstOff, dstDim, numPts);
         }
     }
@@ -870,16 +843,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
             final int dimension = Math.max(srcDim, dstDim);
             final double[] buffer = new double[dimension * numPts];
             copy(srcPts, srcOff, srcDim, buffer, 0, dimension, numPts);
-            try (Context c = Context.acquire()) {
-                final Transform tr = acquire(c);
-                try {
-                    tr.transform(dimension, buffer, 0, numPts);
-                } finally {
-                    release(tr);
-                }
-            } catch (FactoryException e) {
-                throw canNotDelegateToPROJ(e);
-            }
+            run(dimension, buffer, 0, numPts);
             doublesToFloats(buffer, 0, dimension, dstPts, dstOff, dstDim, numPts);
         }
     }
@@ -917,16 +881,7 @@ class Operation extends ParameterGroup implements CoordinateOperation, MathTrans
                 bufOff = 0;
             }
             floatsToDoubles(srcPts, srcOff, srcDim, buffer, bufOff, dimension, numPts);
-            try (Context c = Context.acquire()) {
-                final Transform tr = acquire(c);
-                try {
-                    tr.transform(dimension, buffer, 0, numPts);
-                } finally {
-                    release(tr);
-                }
-            } catch (FactoryException e) {
-                throw canNotDelegateToPROJ(e);
-            }
+            run(dimension, buffer, bufOff, numPts);
             if (buffer != dstPts) {
                 copy(buffer, bufOff, dimension,
                      dstPts, dstOff, dstDim, numPts);
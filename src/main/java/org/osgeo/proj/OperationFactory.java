@@ -42,10 +42,15 @@ import org.opengis.util.FactoryException;
  * Creates coordinate operations from a pair of CRS, optionally with some contextual information.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 final class OperationFactory implements CoordinateOperationFactory {
+    /**
+     * Phases of the operation creation reported in {@link SlowCall} records.
+     */
+    private static final String[] CREATE_PHASES = {"context", "factory", "create operation"};
+
     /**
      * The context in which coordinate operations are to be used.
      */
@@ -118,6 +123,7 @@ final class OperationFactory implements CoordinateOperationFactory {
         final int     gridAvailabilityUse         = ordinal(context.getGridAvailabilityUse());
         final int     allowUseIntermediateCRS     = ordinal(context.getAllowUseIntermediateCRS());
         final boolean discardSuperseded           = context.getDiscardSuperseded();
+        final boolean preferFastest               = context.getPreferFastest();
         final Extent  extent                      = context.getAreaOfInterest();
         /*
          * ISO 19115 allows the extent to be specified in many way (it can be a polygon for instance),
@@ -142,14 +148,32 @@ final class OperationFactory implements CoordinateOperationFactory {
             }
         }
         final Operation result;
+        final long start = SlowCall.now();
+        long acquired = 0, created = 0;
+        boolean cached = false;
+        Throwable failure = null;
         try (Context c = Context.acquire()) {
-            result = c.factory(authority).createOperation(
+            acquired = SlowCall.now(start);
+            cached = c.hasFactory(authority);
+            final AuthorityFactory factory = c.factory(authority);
+            created = SlowCall.now(start);
+            result = factory.createOperation(
                         sourceCRS.impl,     targetCRS.impl,
                         westBoundLongitude, eastBoundLongitude,
                         southBoundLatitude, northBoundLatitude,
                         desiredAccuracy,
                         sourceAndTargetCRSExtentUse, spatialCriterion, gridAvailabilityUse, allowUseIntermediateCRS,
-                        discardSuperseded);
+                        discardSuperseded, preferFastest ? c : null);
+        } catch (Throwable e) {
+            failure = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                SlowCall.record("AuthorityFactory.createOperation",
+                        SlowCall.label(sourceCRS) + " → " + SlowCall.label(targetCRS), 1,
+                        cached ? "factory reused" : "factory created", failure,
+                        start, CREATE_PHASES, acquired, created, SlowCall.now(start));
+            }
         }
         return java.util.Collections.singletonList(result);
     }
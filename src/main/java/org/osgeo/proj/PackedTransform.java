@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Objects;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * Transforms in-place the coordinates of many geometries stored in packed arrays, with a single native call.
+ * Each array is either a {@code double[]} or a {@code float[]} containing tuples of a given number of values,
+ * where the last values of each tuple may be measures. This layout is the one used by packed coordinate
+ * sequences of geometry libraries such as JTS, and this class is used by the {@link org.osgeo.proj.jts}
+ * integration.
+ *
+ * <p>Instances of this class are thread-safe if the {@link BatchTransform} is not modified concurrently.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class PackedTransform {
+    /**
+     * The batch transform which provides the {@code PJ} and the execution lane.
+     */
+    private final BatchTransform batch;
+
+    /**
+     * Creates a new adapter for transforming packed arrays with the given batch transform.
+     * Only the {@linkplain BatchTransform#getPriority() priority} of the batch transform is used;
+     * quantization, spatial ordering, deduplication, reductions and domain guard are not applied.
+     *
+     * @param  batch  the batch transform to use.
+     */
+    public PackedTransform(final BatchTransform batch) {
+        this.batch = Objects.requireNonNull(batch);
+    }
+
+    /**
+     * Transforms in-place the coordinates stored in the given arrays. The array at index <var>i</var>
+     * contains tuples of {@code dimensions[i]} values, where the last {@code measures[i]} values of each
+     * tuple are measures. The spatial values are (<var>x</var>, <var>y</var>) or (<var>x</var>, <var>y</var>,
+     * <var>z</var>) and are transformed. The measures are left unchanged. A NaN <var>z</var> value is handled
+     * as 0 and is left NaN.
+     *
+     * <p>The {@code double[]} arrays are transformed directly in the Java heap, without copy.
+     * The garbage collector may be blocked during the transformation of each array.
+     * The {@code float[]} arrays are copied in a temporary buffer of {@code double} values,
+     * then the transformed values are written back.</p>
+     *
+     * @param  arrays      the {@code double[]} or {@code float[]} arrays to transform in-place.
+     * @param  dimensions  number of values per tuple in each array, including measures.
+     * @param  measures    number of measures per tuple in each array.
+     * @throws IllegalArgumentException if an array is not of a supported type, or if a dimension is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public void transformInPlace(final Object[] arrays, final int[] dimensions, final int[] measures)
+            throws TransformException
+    {
+        final int count = arrays.length;
+        if (dimensions.length < count || measures.length < count) {
+            throw new IllegalArgumentException("Expected " + count + " dimensions and measures.");
+        }
+        final int[] layouts = new int[count * 3];
+        for (int i=0; i<count; i++) {
+            final Object array = arrays[i];
+            final int type;
+            if (array instanceof double[]) {
+                type = Transform.DOUBLE;
+            } else if (array instanceof float[]) {
+                type = Transform.FLOAT;
+            } else {
+                throw new IllegalArgumentException("Unsupported array type at index " + i + '.');
+            }
+            final int spatial = dimensions[i] - measures[i];
+            if (spatial < 2 || spatial > 3 || measures[i] < 0) {
+                throw new IllegalArgumentException("Illegal number of dimensions at index " + i + '.');
+            }
+            layouts[i*3    ] = type;
+            layouts[i*3 + 1] = dimensions[i];
+            layouts[i*3 + 2] = (spatial == 3) ? 1 : 0;
+        }
+        if (count != 0) {
+            batch.execute((tr) -> {
+                tr.transformPacked(arrays, layouts, count);
+                return null;
+            });
+        }
+    }
+}
@@ -0,0 +1,383 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import org.opengis.util.FactoryException;
+import org.opengis.geometry.DirectPosition;
+import org.opengis.geometry.MismatchedDimensionException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.Matrix;
+import org.opengis.referencing.operation.NoninvertibleTransformException;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * A transform created directly from a PROJ string, typically a {@code "+proj=pipeline"} definition.
+ * Contrarily to {@link Operation}, this class does not wrap any {@code CoordinateOperation} object:
+ * the string is given to {@code proj_create(…)} and the resulting {@code PJ} objects are cached in a
+ * {@link TransformPool} like the ones used by {@link Operation}. Coordinates are given to PROJ as-is,
+ * in the axis order and units expected by the PROJ string. The inverse transform uses the same {@code PJ}
+ * objects, executed in the inverse direction.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+final class Pipeline implements MathTransform {
+    /**
+     * The PROJ string given at construction time.
+     */
+    private final String definition;
+
+    /**
+     * Number of dimensions of source and target coordinates.
+     */
+    private final int dimension;
+
+    /**
+     * The objects which will perform the actual coordinate operations.
+     */
+    final TransformPool transforms;
+
+    /**
+     * Whether this transform executes the {@code PJ} objects of the {@linkplain #transforms pool}
+     * in the inverse direction.
+     */
+    final boolean inverted;
+
+    /**
+     * The inverse transform, created only when first needed.
+     *
+     * @see #inverse()
+     */
+    private Pipeline inverse;
+
+    /**
+     * Creates a new transform for the given PROJ string. This constructor creates a first {@code PJ}
+     * object immediately for verifying that the given string is valid. That object is kept in the cache.
+     *
+     * @param  definition  the PROJ string of the coordinate operation.
+     * @param  dimension   number of dimensions of source and target coordinates.
+     * @throws FactoryException if the PROJ string can not be parsed or does not define a coordinate operation.
+     */
+    Pipeline(final String definition, final int dimension) throws FactoryException {
+        this.definition = definition;
+        this.dimension  = dimension;
+        inverted   = false;
+        transforms = new TransformPool(definition, TransformPool.PIPELINE);
+        try (Context c = Context.acquire()) {
+            transforms.release(transforms.acquire(c));
+        } catch (TransformException e) {
+            throw new FactoryException(e.getMessage(), e);
+        }
+        transforms.disposeWhenUnreachable(this);
+    }
+
+    /**
+     * Creates the inverse of the given transform. The new transform shares the same {@code PJ} objects,
+     * which will be executed in the opposite direction.
+     *
+     * @param  forward  the transform to invert.
+     */
+    private Pipeline(final Pipeline forward) {
+        definition = forward.definition;
+        dimension  = forward.dimension;
+        transforms = forward.transforms;
+        inverted   = !forward.inverted;
+        inverse    = forward;
+    }
+
+    /**
+     * Gets the dimension of input points.
+     *
+     * @return the dimension of input points.
+     */
+    @Override
+    public int getSourceDimensions() {
+        return dimension;
+    }
+
+    /**
+     * Gets the dimension of output points.
+     *
+     * @return the dimension of output points.
+     */
+    @Override
+    public int getTargetDimensions() {
+        return dimension;
+    }
+
+    /**
+     * Returns {@code false} since this class can not determine easily if a PROJ string is an identity operation.
+     */
+    @Override
+    public boolean isIdentity() {
+        return false;
+    }
+
+    /**
+     * Returns the exception to throw when a call to {@code acquire(…)} failed to allocate a PROJ object.
+     *
+     * @param  e  the exception that occurred when trying to get the PROJ object.
+     * @return the exception to throw.
+     */
+    final TransformException canNotDelegateToPROJ(final FactoryException e) {
+        return new TransformException("Can not delegate “" + definition + "” to PROJ.", e);
+    }
+
+    /**
+     * Transforms in-place the coordinates in the given array.
+     *
+     * @param  coordinates  the coordinates to transform.
+     * @param  offset       index of the first coordinate value to transform.
+     * @param  numPts       number of points to transform.
+     * @throws TransformException if a point can not be transformed.
+     */
+    private void run(final double[] coordinates, final int offset, final int numPts) throws TransformException {
+        final long start = SlowCall.now();
+        long acquired = 0, created = 0;
+        boolean recycled = false;
+        Throwable failure = null;
+        try (Context c = Context.acquire()) {
+            acquired = SlowCall.now(start);
+            final Transform tr = transforms.acquire(c, inverted);
+            recycled = tr.recycled;
+            created = SlowCall.now(start);
+            try {
+                tr.transform(dimension, coordinates, offset, numPts);
+            } finally {
+                transforms.release(tr);
+            }
+        } catch (FactoryException e) {
+            failure = e;
+            throw canNotDelegateToPROJ(e);
+        } catch (Throwable e) {
+            failure = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                SlowCall.record("Transform.transform", definition, numPts, recycled ? "PJ reused" : "PJ created",
+                                failure, start, Operation.TRANSFORM_PHASES, acquired, created, SlowCall.now(start));
+            }
+        }
+    }
+
+    /**
+     * Transforms the specified {@code ptSrc} and stores the result in {@code ptDst}.
+     * If {@code ptDst} is {@code null}, a new {@link DirectPosition} object is allocated.
+     * The positions are not associated to any CRS.
+     *
+     * @param  ptSrc the specified coordinate point to be transformed.
+     * @param  ptDst the specified coordinate point that stores the result of transforming {@code ptSrc}, or {@code null}.
+     * @return the coordinate point after transforming {@code ptSrc} and storing the result.
+     * @throws MismatchedDimensionException if {@code ptSrc} or {@code ptDst} does not have the expected dimension.
+     * @throws TransformException if the point can not be transformed.
+     */
+    @Override
+    public DirectPosition transform(final DirectPosition ptSrc, DirectPosition ptDst) throws TransformException {
+        if (ptSrc.getDimension() != dimension || (ptDst != null && ptDst.getDimension() != dimension)) {
+            throw new MismatchedDimensionException();
+        }
+        final double[] ordinates = ptSrc.getCoordinate();
+        run(ordinates, 0, 1);
+        if (ptDst == null) {
+            return new SimpleDirectPosition(null, ordinates);
+        }
+        for (int i=0; i<dimension; i++) {
+            ptDst.setOrdinate(i, ordinates[i]);
+        }
+        return ptDst;
+    }
+
+    /**
+     * Transforms an array of coordinate tuples. The source coordinates are copied to the destination
+     * array (if not already there), then transformed in-place.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     *                 May be the same than {@code srcPts}.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    @Override
+    public void transform(final double[] srcPts, final int srcOff,
+                          final double[] dstPts, final int dstOff,
+                          final int numPts) throws TransformException
+    {
+        if (numPts > 0) {
+            Operation.ensureValidRange(srcPts.length, srcOff, numPts, dimension);
+            Operation.ensureValidRange(dstPts.length, dstOff, numPts, dimension);
+            if (srcPts != dstPts || srcOff != dstOff) {
+                System.arraycopy(srcPts, srcOff, dstPts, dstOff, dimension * numPts);
+            }
+            run(dstPts, dstOff, numPts);
+        }
+    }
+
+    /**
+     * Copies the {@code float} arrays to {@code double} arrays, then transforms the coordinate tuples.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     *                 May be the same than {@code srcPts}.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    @Override
+    public void transform(final float[] srcPts, final int srcOff,
+                          final float[] dstPts, final int dstOff,
+                          final int numPts) throws TransformException
+    {
+        if (numPts > 0) {
+            Operation.ensureValidRange(dstPts.length, dstOff, numPts, dimension);
+            final double[] buffer = new double[dimension * numPts];
+            transform(srcPts, srcOff, buffer, 0, numPts);
+            for (int i=0; i<buffer.length; i++) {
+                dstPts[dstOff + i] = (float) buffer[i];
+            }
+        }
+    }
+
+    /**
+     * Copies the {@code float} array to the {@code double} array, then transforms the coordinate tuples.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    @Override
+    public void transform(final float[]  srcPts, final int srcOff,
+                          final double[] dstPts, final int dstOff,
+                          final int numPts) throws TransformException
+    {
+        if (numPts > 0) {
+            Operation.ensureValidRange(srcPts.length, srcOff, numPts, dimension);
+            Operation.ensureValidRange(dstPts.length, dstOff, numPts, dimension);
+            final int length = dimension * numPts;
+            for (int i=0; i<length; i++) {
+                dstPts[dstOff + i] = srcPts[srcOff + i];
+            }
+            run(dstPts, dstOff, numPts);
+        }
+    }
+
+    /**
+     * Transforms the coordinate tuples in a temporary {@code double[]} array, then copies to the {@code float[]} array.
+     *
+     * @param  srcPts  the array containing the source point coordinates.
+     * @param  srcOff  the offset to the first point to be transformed in the source array.
+     * @param  dstPts  the array into which the transformed point coordinates are returned.
+     * @param  dstOff  the offset to the location of the first transformed point that is stored in the destination array.
+     * @param  numPts  the number of point objects to be transformed.
+     * @throws IllegalArgumentException if an offset or number of points argument is invalid.
+     * @throws TransformException if a point can not be transformed.
+     */
+    @Override
+    public void transform(final double[] srcPts, final int srcOff,
+                          final float[]  dstPts, final int dstOff,
+                          final int numPts) throws TransformException
+    {
+        if (numPts > 0) {
+            Operation.ensureValidRange(srcPts.length, srcOff, numPts, dimension);
+            Operation.ensureValidRange(dstPts.length, dstOff, numPts, dimension);
+            final double[] buffer = new double[dimension * numPts];
+            System.arraycopy(srcPts, srcOff, buffer, 0, buffer.length);
+            run(buffer, 0, numPts);
+            for (int i=0; i<buffer.length; i++) {
+                dstPts[dstOff + i] = (float) buffer[i];
+            }
+        }
+    }
+
+    /**
+     * The PROJ library does not provide derivative functions.
+     *
+     * @return the derivative at the given position.
+     * @throws TransformException if the derivative can not be computed.
+     */
+    @Override
+    public Matrix derivative(final DirectPosition point) throws TransformException {
+        throw new TransformException(NativeResource.UNSUPPORTED);
+    }
+
+    /**
+     * Returns the inverse transform.
+     * The inverse executes the same {@code PJ} objects in the inverse direction.
+     *
+     * @return the inverse transform.
+     * @throws NoninvertibleTransformException if the PROJ operation has no inverse.
+     */
+    @Override
+    public synchronized MathTransform inverse() throws NoninvertibleTransformException {
+        if (inverse == null) {
+            final boolean invertible;
+            try (Context c = Context.acquire()) {
+                final Transform tr = transforms.acquire(c);
+                try {
+                    invertible = tr.hasInverse();
+                } finally {
+                    transforms.release(tr);
+                }
+            } catch (FactoryException | TransformException e) {
+                throw new NoninvertibleTransformException(e.getMessage(), e);
+            }
+            if (!invertible) {
+                throw new NoninvertibleTransformException("The “" + definition + "” operation has no inverse.");
+            }
+            inverse = new Pipeline(this);
+        }
+        return inverse;
+    }
+
+    /**
+     * Unsupported operation, since this transform is not backed by an object that can be formatted in WKT.
+     *
+     * @return never returned.
+     * @throws UnsupportedOperationException always thrown.
+     */
+    @Override
+    public String toWKT() throws UnsupportedOperationException {
+        throw new UnsupportedOperationException(NativeResource.UNSUPPORTED);
+    }
+
+    /**
+     * Returns the PROJ string of this transform. For an inverse transform,
+     * the string is the definition given at construction time prefixed by "Inverse of".
+     *
+     * @return the PROJ string given at construction time.
+     */
+    @Override
+    public String toString() {
+        return inverted ? "Inverse of " + definition : definition;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+
+/**
+ * Priority lane in which native work is executed.
+ * Each lane has its own pool of PROJ contexts, its own cache of {@code PJ} objects in each transform,
+ * and its own limit on the number of threads executing native work concurrently.
+ * Consequently a bulk job can not take the resources needed by interactive requests.
+ * Long bulk batches are furthermore executed by chunks, which gives other threads an
+ * opportunity to run between chunks.
+ *
+ * <p>The concurrency limits can be specified by the {@code org.osgeo.proj.interactiveThreads}
+ * and {@code org.osgeo.proj.bulkThreads} system properties, as documented in the
+ * {@linkplain org.osgeo.proj package javadoc}.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ *
+ * @see BatchTransform#setPriority(Priority)
+ */
+public enum Priority {
+    /**
+     * Requests for which latency matters, such as the transformation of a few points for display.
+     * This is the lane used by all PROJ-JNI methods unless otherwise specified.
+     * By default, the number of concurrent threads in this lane is not limited.
+     */
+    INTERACTIVE,
+
+    /**
+     * Jobs for which throughput matters more than latency, such as the transformation of millions of points.
+     * By default, the number of concurrent threads in this lane is the number of processors minus one,
+     * so at least one processor is left for interactive requests on multi-processors machines.
+     */
+    BULK
+}
@@ -22,7 +22,11 @@
  */
 package org.osgeo.proj;
 
+import java.lang.ref.Reference;
+import java.util.Map;
 import java.util.List;
+import java.util.Collections;
+import java.util.LinkedHashMap;
 import java.util.Objects;
 import java.util.Optional;
 import java.util.logging.Level;
@@ -34,6 +38,7 @@ import org.opengis.geometry.MismatchedDimensionException;
 import org.opengis.referencing.IdentifiedObject;
 import org.opengis.referencing.crs.CRSAuthorityFactory;
 import org.opengis.referencing.crs.CoordinateReferenceSystem;
+import org.opengis.referencing.datum.Ellipsoid;
 import org.opengis.referencing.operation.CoordinateOperation;
 import org.opengis.referencing.operation.CoordinateOperationFactory;
 import org.opengis.referencing.operation.OperationNotFoundException;
@@ -58,7 +63,7 @@ import org.opengis.referencing.operation.MathTransform;
  * (need to fetch the factory before invoking methods on it).
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 public final class Proj {
@@ -142,6 +147,38 @@ public final class Proj {
         return new AuthorityFactory.API(authority.trim());    // Intentional NullPointerException if authority is null.
     }
 
+    /**
+     * Creates an object of the given type from an authority code, or returns an empty value if the code is unknown.
+     * This method is equivalent to invoking the {@code createFoo(code)} method of the {@linkplain #getAuthorityFactory
+     * authority factory} for the given type, except that an unknown code or a code identifying an object of another
+     * type results in an empty value instead of a {@link org.opengis.referencing.NoSuchAuthorityCodeException}.
+     * Unknown codes are remembered in a bounded cache, so validating many codes where the same invalid codes
+     * appear repeatedly is fast. Example:
+     *
+     * {@snippet lang="java" :
+     * Optional<GeographicCRS> crs = Proj.tryCreate("EPSG", "4326", GeographicCRS.class);
+     * }
+     *
+     * The size of the cache of unknown codes can be set by the "{@systemProperty org.osgeo.proj.maxMissingCodes}"
+     * system property at startup time. The default value is 10000.
+     *
+     * @param  <T>        compile-time value of the {@code type} argument.
+     * @param  authority  authority name of the code (e.g. {@code "EPSG"}).
+     * @param  code       code allocated by the authority (e.g. {@code "4326"}).
+     * @param  type       GeoAPI interface of the object to create, for example {@code GeographicCRS.class}.
+     * @return the object for the given code, or empty if there is no object of the given type for that code.
+     * @throws IllegalArgumentException if the given type is not a GeoAPI interface of a referencing object.
+     * @throws FactoryException if the object creation failed for another reason than an unknown code.
+     *
+     * @since 2.1
+     */
+    public static <T extends IdentifiedObject> Optional<T> tryCreate(final String authority, final String code,
+            final Class<T> type) throws FactoryException
+    {
+        final AuthorityFactory.API factory = new AuthorityFactory.API(authority.trim());
+        return factory.tryCreate(type, AuthorityFactory.API.typeOf(type), code);
+    }
+
     /**
      * Creates a new operation factory for the given context.
      *
@@ -253,8 +290,23 @@ public final class Proj {
     public static IdentifiedObject createFromUserInput(final String text) throws FactoryException {
         Objects.requireNonNull(text);
         final Object result;
+        final long start = SlowCall.now();
+        long acquired = 0;
+        boolean cached = false;
+        Throwable failure = null;
         try (Context c = Context.acquire()) {
+            acquired = SlowCall.now(start);
+            cached = c.hasDatabase();
             result = c.createFromUserInput(text);
+        } catch (Throwable e) {
+            failure = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                SlowCall.record("Context.createFromUserInput", text, text.length(),
+                        cached ? "database reused" : "database opened", failure,
+                        start, SlowCall.PARSE_PHASES, acquired, SlowCall.now(start));
+            }
         }
         if (result instanceof IdentifiedObject) {
             return (IdentifiedObject) result;
@@ -339,6 +391,34 @@ public final class Proj {
                 (context != null) ? context : new CoordinateOperationContext());
     }
 
+    /**
+     * Creates a transform directly from a PROJ string, typically a {@code "+proj=pipeline"} definition.
+     * Contrarily to {@link #createFromUserInput(String)}, this method does not create any coordinate operation
+     * or other metadata object: the string is given directly to PROJ. This is faster when the pipeline is
+     * already known, for example because it has been saved from a previous run.
+     *
+     * <p>The returned transform expects coordinates in the axis order and units of the PROJ string.
+     * For example a pipeline starting with {@code "+step +proj=unitconvert +xy_in=deg"} expects
+     * (<var>longitude</var>, <var>latitude</var>) coordinates in degrees.
+     * The number of dimensions can not be inferred from the PROJ string and shall be specified.
+     * The returned transform can be given to the {@link BatchTransform} constructor.</p>
+     *
+     * @param  definition  the PROJ string of the coordinate operation.
+     * @param  dimension   number of dimensions of source and target coordinates, from 1 to 4 inclusive.
+     * @return transform executing the given PROJ string.
+     * @throws IllegalArgumentException if the number of dimensions is out of range.
+     * @throws FactoryException if the PROJ string can not be parsed or does not define a coordinate operation.
+     *
+     * @since 2.1
+     */
+    public static MathTransform createTransform(final String definition, final int dimension) throws FactoryException {
+        Objects.requireNonNull(definition);
+        if (dimension < 1 || dimension > 4) {
+            throw new IllegalArgumentException("Illegal number of dimensions: " + dimension);
+        }
+        return new Pipeline(definition, dimension);
+    }
+
     /**
      * Creates a position with the given coordinate values and an optional CRS.
      *
@@ -401,6 +481,215 @@ public final class Proj {
         }
     }
 
+    /**
+     * Returns the names of all given objects in a single call to the native library.
+     * This is equivalent to invoking {@code getName().getCode()} on each object,
+     * but more efficient when the values of a single property are desired for many objects.
+     * Null elements give null names.
+     *
+     * @param  objects  the objects for which to get the names.
+     * @return the object names, in the same order than the given objects.
+     * @throws UnsupportedImplementationException if an object is not a PROJ implementation.
+     *
+     * @since 2.1
+     */
+    public static String[] getNames(final IdentifiedObject... objects) {
+        final SharedPointer[] column = unwrap(objects);
+        try {
+            return SharedPointer.getStringColumn(column, Property.NAME_STRING);
+        } finally {
+            Reference.reachabilityFence(objects);
+        }
+    }
+
+    /**
+     * Returns the EPSG identifiers of all given objects in a single call to the native library.
+     * Identifiers are formatted as {@code "EPSG:code"}. Null elements and objects without
+     * EPSG code give null values.
+     *
+     * @param  objects  the objects for which to get the identifiers.
+     * @return the object identifiers, in the same order than the given objects.
+     * @throws UnsupportedImplementationException if an object is not a PROJ implementation.
+     *
+     * @since 2.1
+     */
+    public static String[] getIdentifiers(final IdentifiedObject... objects) {
+        final SharedPointer[] column = unwrap(objects);
+        try {
+            return SharedPointer.getStringColumn(column, Property.IDENTIFIER_STRING);
+        } finally {
+            Reference.reachabilityFence(objects);
+        }
+    }
+
+    /**
+     * Returns whether each given object is deprecated, in a single call to the native library.
+     * Null elements give {@code false} values.
+     *
+     * @param  objects  the objects for which to get the deprecation flags.
+     * @return the deprecation flags, in the same order than the given objects.
+     * @throws UnsupportedImplementationException if an object is not a PROJ implementation.
+     *
+     * @since 2.1
+     */
+    public static boolean[] areDeprecated(final IdentifiedObject... objects) {
+        final SharedPointer[] column = unwrap(objects);
+        try {
+            return SharedPointer.getBooleanColumn(column, Property.IS_DEPRECATED);
+        } finally {
+            Reference.reachabilityFence(objects);
+        }
+    }
+
+    /**
+     * Returns the semi-major axis lengths of all given ellipsoids in a single call to the native library.
+     * Null elements give NaN values.
+     *
+     * @param  ellipsoids  the ellipsoids for which to get the semi-major axis lengths.
+     * @return the semi-major axis lengths, in the same order than the given ellipsoids.
+     * @throws UnsupportedImplementationException if an ellipsoid is not a PROJ implementation.
+     *
+     * @since 2.1
+     */
+    public static double[] getSemiMajorAxes(final Ellipsoid... ellipsoids) {
+        final SharedPointer[] column = unwrap(ellipsoids);
+        try {
+            return SharedPointer.getNumericColumn(column, Property.SEMI_MAJOR);
+        } finally {
+            Reference.reachabilityFence(ellipsoids);
+        }
+    }
+
+    /**
+     * Returns the geographic bounding boxes of the domains of validity of all given objects.
+     * The values are fetched in a single call to the native library and returned in a flat array
+     * where the box of object <var>i</var> is stored at indices 4<var>i</var> to 4<var>i</var>+3
+     * inclusive, in (<var>west</var>, <var>east</var>, <var>south</var>, <var>north</var>) order.
+     * Objects without domain of validity give NaN values.
+     *
+     * @param  objects  the CRS, datums or coordinate operations for which to get the domains of validity.
+     * @return the bounding boxes in degrees, in the same order than the given objects.
+     * @throws UnsupportedImplementationException if an object is not a PROJ implementation.
+     *
+     * @since 2.1
+     */
+    public static double[] getDomainsOfValidity(final IdentifiedObject... objects) {
+        final SharedPointer[] column = unwrap(objects);
+        try {
+            return SharedPointer.getArrayColumn(column, Property.DOMAIN_OF_VALIDITY, 4);
+        } finally {
+            Reference.reachabilityFence(objects);
+        }
+    }
+
+    /**
+     * Returns the shared pointers of all given objects, for the "get column" methods.
+     * Callers must keep the given array reachable until the native method returned.
+     *
+     * @param  objects  the objects to unwrap. Null elements are allowed.
+     * @return the shared pointers of all objects.
+     * @throws UnsupportedImplementationException if an object is not a PROJ implementation.
+     */
+    private static SharedPointer[] unwrap(final Object[] objects) {
+        final SharedPointer[] column = new SharedPointer[objects.length];
+        for (int i=0; i<objects.length; i++) {
+            final Object object = objects[i];
+            if (object instanceof IdentifiableObject) {
+                column[i] = ((IdentifiableObject) object).impl;
+            } else if (object != null) {
+                throw new UnsupportedImplementationException("objects[" + i + ']', object);
+            }
+        }
+        return column;
+    }
+
+    /**
+     * Opens a scope where all PROJ objects created by the current thread will be released on scope exit.
+     * This method should be used in a {@code try} … {@code finally} block as below:
+     *
+     * {@snippet lang="java" :
+     *     try (ProjScope scope = Proj.scope()) {
+     *         // Create and use temporary PROJ objects here.
+     *     }
+     * }
+     *
+     * @return a new scope, to be closed by the same thread.
+     *
+     * @since 2.1
+     */
+    public static ProjScope scope() {
+        return new ProjScope();
+    }
+
+    /**
+     * Returns the numbers of native resources and cached objects currently held by PROJ-JNI.
+     * This is a diagnostic tool for detecting memory growth in long-running applications:
+     * in a steady workload, all values should stabilize. The map contains the following entries:
+     *
+     * <ul>
+     *   <li>{@code "sharedPointers"}: native blocks referencing PROJ objects from Java wrappers or factories.</li>
+     *   <li>{@code "wrappers"}: Java wrappers whose native resources have not yet been released.</li>
+     *   <li>{@code "contexts"}: {@code PJ_CONTEXT} instances, either in use or pooled, including the one of the reclaimer thread.</li>
+     *   <li>{@code "pooledContexts"}: {@code PJ_CONTEXT} instances waiting for reuse.</li>
+     *   <li>{@code "transforms"}: {@code PJ} objects created for coordinate operations, either in use or cached.</li>
+     *   <li>{@code "unreachablePools"}: caches of {@code PJ} objects waiting for the garbage collection of their owner.</li>
+     *   <li>{@code "pendingReclaims"}: native resources waiting for destruction in the background thread.</li>
+     *   <li>{@code "mallocInUse"}: bytes in use by the C allocator, or -1 if unknown on this platform.</li>
+     * </ul>
+     *
+     * Values are snapshots which may be modified concurrently by other threads.
+     *
+     * @return numbers of native resources and cached objects, keyed by the names listed above.
+     *
+     * @since 2.1
+     */
+    public static Map<String,Long> getResourceCounts() {
+        final long[] counts = new long[NativeResource.NUM_COUNTERS];
+        NativeResource.resourceCounts(counts);
+        final Map<String,Long> map = new LinkedHashMap<>();
+        map.put("sharedPointers",   counts[NativeResource.SHARED_POINTERS]);
+        map.put("wrappers",         (long) SharedObjects.CACHE.size());
+        map.put("contexts",         counts[NativeResource.CONTEXTS]);
+        map.put("pooledContexts",   (long) Context.pooledCount());
+        map.put("transforms",       counts[NativeResource.TRANSFORMS]);
+        map.put("unreachablePools", (long) TransformPool.disposerCount());
+        map.put("pendingReclaims",  (long) Reclaimer.pending());
+        map.put("mallocInUse",      counts[NativeResource.MALLOC_IN_USE]);
+        return Collections.unmodifiableMap(map);
+    }
+
+    /**
+     * Returns the most recent calls to PROJ which exceeded the slow-call threshold, from oldest to newest.
+     * The recorder is disabled by default; it is enabled by the "{@code org.osgeo.proj.slowCallThreshold}"
+     * system property documented in the package javadoc. Each record contains the operation or CRS identifiers,
+     * the input size, the cache state, the durations of the sub-phases and the Java stack trace of the caller.
+     *
+     * @return the most recent slow calls, or an empty list if none or if the recorder is disabled.
+     *
+     * @since 2.1
+     */
+    public static List<SlowCall> getSlowCalls() {
+        return SlowCall.recent();
+    }
+
+    /**
+     * Forgets the coordinate operations that PROJ could not instantiate. When a coordinate operation can not
+     * be executed (for example because a datum shift grid is missing), the failure is remembered and next
+     * transforms with that operation fail immediately with the same message, without new attempt.
+     * This method should be invoked after the conditions may have changed, for example after grid files
+     * have been installed or the network access has been enabled.
+     * This method also forgets the authority codes for which no object was found.
+     *
+     * <p>Failures can also be forgotten automatically after a delay specified by the
+     * "{@code org.osgeo.proj.failureRetryDelay}" system property, documented in the package javadoc.</p>
+     *
+     * @since 2.1
+     */
+    public static void invalidateFailures() {
+        TransformPool.invalidateFailures();
+        AuthorityFactory.API.clearMissingCodes();
+    }
+
     /**
      * Returns {@code true} if the given objects are equivalent according the given criterion.
      * If the two given objects are {@code null}, this method returns {@code true}.
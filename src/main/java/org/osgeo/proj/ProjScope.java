@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.ArrayList;
+import java.util.List;
+
+
+/**
+ * A region of code where all PROJ objects created by the current thread are released on exit.
+ * By default, the native resources used by PROJ objects are released only after the Java wrappers
+ * have been garbage collected, which may happen a long time after their last use. Applications creating
+ * a large amount of temporary objects (e.g. a batch job creating a CRS and an operation for each record)
+ * can release those resources deterministically as below:
+ *
+ * {@snippet lang="java" :
+ *     try (ProjScope scope = Proj.scope()) {
+ *         CoordinateReferenceSystem crs = Proj.createFromUserInput(code);
+ *         // Do some work with the CRS here.
+ *     }   // The CRS can not be used anymore after this point.
+ * }
+ *
+ * All PROJ objects created by the current thread inside the {@code try} block, including objects created
+ * indirectly (for example the coordinate system of a CRS), are {@linkplain AutoCloseable#close() closed}
+ * when the scope is closed. Objects which already existed before the scope was opened are not affected,
+ * even if they are obtained again inside the scope. Callers shall ensure that no object created inside
+ * the scope is used after the scope has been closed, including by other threads.
+ *
+ * <p>Scopes can be nested. Each scope is associated to the thread which created it
+ * and does not track the objects created by other threads.
+ * A scope shall be closed by the same thread than the one which created it.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class ProjScope implements AutoCloseable {
+    /**
+     * The innermost scope opened by the current thread, or {@code null} if none.
+     */
+    private static final ThreadLocal<ProjScope> CURRENT = new ThreadLocal<>();
+
+    /**
+     * The scope which was current before this scope has been opened, or {@code null} if none.
+     */
+    private final ProjScope parent;
+
+    /**
+     * The objects created in this scope, in creation order.
+     * Set to {@code null} after this scope has been closed.
+     */
+    private List<IdentifiableObject> created;
+
+    /**
+     * Creates a new scope and makes it the current scope of the calling thread.
+     * Callers should use {@link Proj#scope()} instead.
+     */
+    ProjScope() {
+        parent  = CURRENT.get();
+        created = new ArrayList<>();
+        CURRENT.set(this);
+    }
+
+    /**
+     * Registers the given object for being closed when the current scope will be closed.
+     * This method does nothing if there is no scope for the current thread.
+     * This method shall be invoked only for newly created wrappers.
+     *
+     * @param  object  the newly created wrapper.
+     */
+    static void register(final IdentifiableObject object) {
+        final ProjScope scope = CURRENT.get();
+        if (scope != null) {
+            scope.created.add(object);
+        }
+    }
+
+    /**
+     * Releases the native resources of all PROJ objects created by the current thread since this scope
+     * has been opened. The objects are released in reverse order of creation. After this method call,
+     * those objects can not be used anymore. Invoking this method many times has no effect.
+     *
+     * @throws IllegalStateException if this scope is closed by a different thread than the one which created it.
+     */
+    @Override
+    public void close() {
+        final List<IdentifiableObject> objects = created;
+        if (objects != null) {
+            if (CURRENT.get() != this) {
+                throw new IllegalStateException("This scope is not the innermost scope of current thread.");
+            }
+            created = null;
+            if (parent != null) {
+                CURRENT.set(parent);
+            } else {
+                CURRENT.remove();
+            }
+            for (int i = objects.size(); --i >= 0;) {
+                objects.get(i).close();
+            }
+        }
+    }
+}
@@ -127,5 +127,6 @@ final class Property {
     static final short HAS_NAME       = 600,
                        IS_SPHERE      = 601,
                        IVF_DEFINITIVE = 602,
-                       PARAMETER_BOOL = 603;
+                       PARAMETER_BOOL = 603,
+                       IS_DEPRECATED  = 604;
 }
@@ -0,0 +1,237 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.CountDownLatch;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+import org.opengis.util.FactoryException;
+
+
+/**
+ * A thread destroying native resources on behalf of the threads that release them.
+ * Destroying a {@code PJ} or a {@code PJ_CONTEXT} may be costly, since it may close SQLite databases
+ * and grid files. Instead of doing that work in the thread of a user request, the release paths
+ * hand the destruction over to this thread, so the caller only pays the cost of a queue insertion.
+ *
+ * <p>The queue is bounded. If it is full (for example because resources are released faster than they
+ * can be destroyed), the destruction is executed synchronously in the caller thread. This fallback slows
+ * down the producers and prevents an unbounded accumulation of native memory waiting for reclamation.
+ * The queue capacity is given by the "{@code org.osgeo.proj.reclaimQueueSize}" system property.
+ * A value of 0 disables this thread, in which case all destructions are synchronous.</p>
+ *
+ * <p>A {@code PJ} shall not be destroyed with the default {@code PJ_CONTEXT}, since that context may be used
+ * concurrently by other threads. The reclaimer thread owns a dedicated context for that purpose, which is
+ * destroyed by {@link #drain()}. When the destruction is synchronous, the {@code PJ} is destroyed with a
+ * context of the caller thread.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+final class Reclaimer extends Thread {
+    /**
+     * The destructions waiting to be executed, or {@code null} if all destructions are synchronous.
+     */
+    private static final BlockingQueue<Runnable> QUEUE;
+
+    /**
+     * Whether the reclaimer thread has been stopped by {@link #drain()}.
+     * After that point, all destructions are synchronous.
+     */
+    private static volatile boolean stopped;
+
+    /**
+     * The context in which to destroy {@code PJ} objects in the background, created when first needed.
+     * Used only by the thread executing the queued tasks: the reclaimer thread, then the thread which
+     * invoked {@link #drain()}. Destroyed by {@code drain()}.
+     */
+    private static Context context;
+
+    /**
+     * Creates the singleton instance of the {@code Reclaimer} thread, unless disabled.
+     */
+    static {
+        final Integer n = Integer.getInteger("org.osgeo.proj.reclaimQueueSize");
+        final int capacity = (n != null) ? Math.max(0, n) : 1024;
+        if (capacity != 0) {
+            QUEUE = new ArrayBlockingQueue<>(capacity);
+            /*
+             * Call to Thread.start() must be outside the constructor
+             * (Reference: Goetz et al.: "Java Concurrency in Practice").
+             */
+            new Reclaimer().start();
+        } else {
+            QUEUE = null;
+        }
+    }
+
+    /**
+     * Constructs a new thread as a daemon thread. This thread will be sleeping most of the time.
+     * Contrarily to {@link CleanerThread}, this thread keeps the normal priority since the work
+     * that it executes is not urgent.
+     */
+    private Reclaimer() {
+        super(null, null, "PROJ resources reclaimer", 16*1024);     // Small (16 kb) stack size is sufficient.
+        setDaemon(true);
+    }
+
+    /**
+     * Executes the given destruction in the background thread if possible, or in the caller thread otherwise.
+     * The given task shall not use any resource that may still be used by the caller after this method call.
+     *
+     * @param  task  the destruction of a native resource.
+     */
+    static void destroy(final Runnable task) {
+        if (!offer(task)) {
+            task.run();
+        }
+    }
+
+    /**
+     * Adds the given task in the queue of the background thread if possible.
+     *
+     * @param  task  the destruction of a native resource.
+     * @return whether the task has been queued. If {@code false}, the caller shall execute the task itself.
+     */
+    private static boolean offer(final Runnable task) {
+        return QUEUE != null && !stopped && QUEUE.offer(task);
+    }
+
+    /**
+     * Destroys the given {@code PJ} wrapper in the background thread if possible, or in the caller thread otherwise.
+     * In the background thread, the {@code PJ} is assigned to the context owned by this class before destruction.
+     * In the caller thread, the {@code PJ} is destroyed with the caller's context if {@code assigned} is true,
+     * or with a context acquired for the current thread otherwise. No global lock is held in any case.
+     * The caller shall not use the given wrapper after this method call.
+     *
+     * @param  tr        wrapper of the {@code PJ} to destroy.
+     * @param  assigned  whether the wrapper is assigned to a context of the caller.
+     */
+    static void destroy(final Transform tr, final boolean assigned) {
+        /*
+         * The lock on `tr` makes the background task wait until the caller has detached the
+         * wrapper from its context. It does not block the destruction of other wrappers.
+         */
+        synchronized (tr) {
+            if (offer(() -> {
+                synchronized (tr) {
+                    final Context c = context();
+                    if (c != null) tr.assign(c);
+                    tr.destroy();
+                }
+            })) {
+                if (assigned) {
+                    tr.assign(null);    // The caller's context may be reused by another thread after return.
+                }
+                return;
+            }
+        }
+        if (assigned) {
+            tr.destroy();
+        } else try (Context c = Context.acquire()) {
+            tr.assign(c);
+            tr.destroy();
+        } catch (FactoryException e) {
+            // Should happen only if out of memory. Destroy with the default context anyway.
+            Logger.getLogger(NativeResource.LOGGER_NAME).log(Level.WARNING, e.getLocalizedMessage(), e);
+            tr.destroy();
+        }
+    }
+
+    /**
+     * Returns the context in which to destroy {@code PJ} objects in the background, creating it when first needed.
+     * Shall be invoked only by the thread executing the queued tasks.
+     *
+     * @return the context owned by this class, or {@code null} if it can not be created.
+     */
+    private static Context context() {
+        if (context == null) try {
+            context = Context.createDetached();
+        } catch (FactoryException e) {
+            // Should happen only if out of memory. Destroy with the default context anyway.
+            Logger.getLogger(NativeResource.LOGGER_NAME).log(Level.WARNING, e.getLocalizedMessage(), e);
+        }
+        return context;
+    }
+
+    /**
+     * Returns the number of destructions waiting in the queue.
+     * Used for diagnostic of memory growth.
+     *
+     * @return number of pending destructions.
+     */
+    static int pending() {
+        return (QUEUE != null) ? QUEUE.size() : 0;
+    }
+
+    /**
+     * Waits for the completion of all destructions waiting in the queue, then stops the background thread.
+     * This is invoked at JVM shutdown time, before all remaining contexts are destroyed. A sentinel task is
+     * appended to the queue, so this method returns only after the task in progress (if any) has completed.
+     * Destructions requested after this call are executed synchronously. The context owned by this class
+     * is destroyed last.
+     */
+    static void drain() {
+        if (QUEUE != null && !stopped) {
+            final CountDownLatch done = new CountDownLatch(1);
+            try {
+                QUEUE.put(() -> {
+                    stopped = true;
+                    done.countDown();
+                });
+                done.await();
+            } catch (InterruptedException e) {
+                Logger.getLogger(NativeResource.LOGGER_NAME).log(Level.WARNING, "Interrupted while draining.", e);
+                return;
+            }
+            Runnable task;
+            while ((task = QUEUE.poll()) != null) {
+                task.run();     // Tasks added concurrently with the sentinel.
+            }
+            if (context != null) {
+                context.destroyDetached();
+                context = null;
+            }
+        }
+    }
+
+    /**
+     * Loop to be run during the virtual machine lifetime.
+     * Public as an implementation side-effect; <strong>do not invoke explicitly!</strong>
+     */
+    @Override
+    public final void run() {
+        while (!stopped) {
+            try {
+                QUEUE.take().run();
+            } catch (InterruptedException e) {
+                // Should not happen since nobody should interrupt this thread. Continue anyway.
+            } catch (Throwable exception) {
+                Logger.getLogger(NativeResource.LOGGER_NAME).log(Level.WARNING, exception.getLocalizedMessage(), exception);
+            }
+        }
+    }
+}
@@ -220,10 +220,26 @@ public class ReferencingFormat {
     public Object parse(final String text) throws UnparsableObjectException {
         warnings.clear();
         Objects.requireNonNull(text);
+        final long start = SlowCall.now();
+        long acquired = 0;
+        boolean cached = false;
+        Throwable failure = null;
         try (Context c = Context.acquire()) {
+            acquired = SlowCall.now(start);
+            cached = c.hasDatabase();
             return parse(text, c, convention.ordinal(), strict);
         } catch (FactoryException e) {
+            failure = e;
             throw new UnparsableObjectException("Can not parse WKT.", e);
+        } catch (Throwable e) {
+            failure = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                SlowCall.record("ReferencingFormat.parse", convention.name(), text.length(),
+                        cached ? "database reused" : "database opened", failure,
+                        start, SlowCall.PARSE_PHASES, acquired, SlowCall.now(start));
+            }
         }
     }
 
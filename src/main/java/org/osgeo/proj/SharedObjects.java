@@ -22,28 +22,23 @@
  */
 package org.osgeo.proj;
 
-import java.util.Arrays;
+import java.util.Iterator;
+import java.util.Set;
 import java.lang.ref.SoftReference;
-import java.util.concurrent.locks.StampedLock;
+import java.lang.ref.WeakReference;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+import java.util.concurrent.atomic.AtomicReferenceFieldUpdater;
 
 
 /**
- * A map of pointer values to Java wrappers retained by soft references.
- * This class is convenient for avoiding the creation of duplicated elements,
- * as in the example below:
- *
- * {@snippet lang="java" :
- *     long pointer = ...
- *     IdentifiableObject wrapper = CACHE.get(pointer);
- *     if (wrapper == null) {
- *         wrapper = ...;                           // Create the value here.
- *         IdentifiableObject existing = CACHE.putIfAbsent(pointer, wrapper);
- *         if (existing != null) {                  // Created concurrently.
- *             wrapper.release();
- *             wrapper = existing;
- *         }
- *     }
- * }
+ * The set of Java wrappers retained by soft references or by a bounded cache.
+ * The search for an existing wrapper of a PROJ object is done by native code,
+ * which keeps a map from PROJ objects to weak references to their wrappers.
+ * This class only determines how long the wrappers are retained, and releases
+ * the native resources when a wrapper is garbage collected.
+ * Registration of new wrappers does not acquire any global lock.
  *
  * <h2>Design note</h2>
  * We use soft references instead than weak references because PROJ-JNI does not retain hard reference
@@ -51,337 +46,210 @@ import java.util.concurrent.locks.StampedLock;
  * If we were using weak references, the component wrapper could be recreated almost every time the
  * {@link CRS#getCoordinateSystem()} method is invoked.
  *
- * <p>This class extends {@link StampedLock} for implementation convenience only.
- * We allow ourself to do that because this class is not public.
- * Callers should not rely on this implementation detail.</p>
+ * <p>However soft references are cleared only when the Java heap is under pressure, while the main cost
+ * of PROJ objects is in native memory, which is invisible to the garbage collector. For applications
+ * where this is a problem, the "{@code org.osgeo.proj.maxCachedObjects}" system property can be set to
+ * a positive number. In that mode, at most that number of wrappers are retained by strong references
+ * with a CLOCK (second chance) eviction policy, and all other wrappers are retained only by weak references.
+ * The amount of native memory retained by this cache is then bounded regardless of the Java heap state.</p>
  *
  * @author  Martin Desruisseaux (IRD, Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
-@SuppressWarnings("serial")
-final class SharedObjects extends StampedLock implements Runnable {
+final class SharedObjects implements Runnable {
     /**
-     * Number of nanoseconds to wait before to rehash the table for reducing its size.
-     * When the garbage collector collects a lot of elements, we will wait at least this amount of time
-     * before rehashing the tables, in case lot of news elements are going to be added. Without this
-     * field, we noticed many "reduce", "expand", "reduce", "expand", <i>etc.</i> cycles.
+     * Maximal number of wrappers retained by strong references, or 0 for retaining them by soft references.
+     * This is the value of the {@code "org.osgeo.proj.maxCachedObjects"} system property at startup time.
      */
-    private static final long REHASH_DELAY = 4000_000_000L;             // 4 seconds.
-
-    /**
-     * Map capacities as prime numbers close to powers of 2.
-     */
-    private static final int[] CAPACITIES = {61, 127, 257, 509, 1021, 2053, 4093, 8191, 16381, 32771, 65537};
+    private static final int MAX_CACHED_OBJECTS;
+    static {
+        final Integer n = Integer.getInteger("org.osgeo.proj.maxCachedObjects");
+        MAX_CACHED_OBJECTS = (n != null) ? Math.max(0, n) : 0;
+    }
 
     /**
-     * An entry in the {@link SharedObjects}. This is a soft reference
-     * to the Java wrapper together with the pointer value.
+     * An entry in the {@link SharedObjects}. This is a weak reference to the Java wrapper
+     * together with the object to use for releasing the native resources. In the default mode,
+     * the wrapper is also retained by a soft reference, which make the combination behave like
+     * a soft reference. In the bounded mode, the wrapper is instead retained by the {@link #pinned} array.
      */
-    static final class Entry extends SoftReference<IdentifiableObject> {
-        /**
-         * Raw memory address of the native object. This is not the memory address of the shared pointer.
-         * This value is used only for identifying if the value pointed by a shared pointer is the same
-         * than the value pointed by another shared pointer.
-         */
-        final long key;
-
+    static final class Entry extends WeakReference<IdentifiableObject> {
         /**
-         * The next entry, or {@code null} if there is none.
-         * This is used when more than one entry has the same hash code value.
+         * The object containing the code for releasing native resource.
          */
-        private Entry next;
+        final SharedPointer cleaner;
 
         /**
-         * The object containing the code for releasing native resource.
+         * Soft reference to the wrapper for retaining it until the Java heap is under pressure,
+         * or {@code null} if the cache is in bounded mode.
          */
-        final SharedPointer cleaner;
+        @SuppressWarnings("unused")
+        private final SoftReference<IdentifiableObject> retain;
 
         /**
-         * Constructs a new soft reference.
+         * Constructs a new reference.
          *
-         * @param  key    raw memory address of the native object.
          * @param  value  the object for which to release native resource after garbage collection.
-         * @param  next   next entry having the same hash value, or {@code null} if there is none.
+         * @param  soft   whether to retain the wrapper by a soft reference.
          */
-        private Entry(final long key, final IdentifiableObject value, final Entry next) {
+        private Entry(final IdentifiableObject value, final boolean soft) {
             super(value, CleanerThread.QUEUE);
-            this.key     = key;
-            this.next    = next;
             this.cleaner = value.impl;
-        }
-
-        /**
-         * Removes this entry from the given table of entries at the given index.
-         * This method should be invoked only after the soft reference has been cleaned.
-         *
-         * @param  table     the table from which to remove this entry.
-         * @param  removeAt  the index of this entry in the given table.
-         * @return {@code true} if this entry has been found and removed, or {@code false} otherwise.
-         */
-        private boolean removeFrom(final Entry[] table, final int removeAt) {
-            Entry prev = null;
-            Entry e = table[removeAt];
-            while (e != null) {
-                if (e == this) {
-                    if (prev != null) {
-                        prev.next = e.next;
-                    } else {
-                        table[removeAt] = e.next;
-                    }
-                    // We can not continue the loop pass that point, since `e` is no longer valid.
-                    return true;
-                }
-                prev = e;
-                e = e.next;
-            }
-            return false;
+            this.retain  = soft ? new SoftReference<>(value) : null;
         }
     }
 
     /**
-     * Table of soft references.
+     * All entries for wrappers that have not yet been released. This set uses identity comparisons,
+     * since {@link Entry} does not override {@link Object#equals(Object)}. It is needed for keeping
+     * the {@link Entry} instances reachable until they are processed by the {@link CleanerThread}.
      */
-    private Entry[] table;
+    private final Set<Entry> entries;
 
     /**
-     * Number of non-null elements in {@link #table}.
-     * This is used for determining when {@link #rehash(Entry[], int)} needs to be invoked.
+     * Wrappers retained by strong references when the cache is in bounded mode, or {@code null} if
+     * the cache is in soft references mode. This is the ring of a CLOCK algorithm: on insertion,
+     * the {@linkplain #hand} skips (and clears the flag of) the wrappers that have been
+     * {@linkplain IdentifiableObject#recentlyUsed recently used}, then replaces the first other one.
+     * The evicted wrapper is still in the {@link #entries} set but become only weakly reachable.
      */
-    private int count;
+    private final AtomicReferenceArray<IdentifiableObject> pinned;
 
     /**
-     * The last time when {@link #table} was not in need for rehash. When the garbage collector
-     * collected a lot of elements, we will wait a few seconds before rehashing {@link #table}
-     * in case lot of news entries are going to be added. Without this field, we noticed many
-     * "reduce", "expand", "reduce", "expand", <i>etc.</i> cycles.
-     */
-    private transient long lastTimeNormalCapacity;
-
-    /**
-     * The unique instance of {@link SharedObjects}.
+     * Counter from which is derived the index of the next slot to examine in the {@link #pinned} array.
      */
-    static final SharedObjects CACHE = new SharedObjects();
+    private final AtomicInteger hand;
 
     /**
-     * Creates a map of shared objects.
+     * Updater for taking the {@link IdentifiableObject#entry} value atomically, so that concurrent
+     * invocations of {@link #discard(IdentifiableObject)} do not process the same entry twice.
      */
-    private SharedObjects() {
-        lastTimeNormalCapacity = System.nanoTime();
-        table = new Entry[CAPACITIES[0]];
-    }
+    private static final AtomicReferenceFieldUpdater<IdentifiableObject, Entry> ENTRY =
+            AtomicReferenceFieldUpdater.newUpdater(IdentifiableObject.class, Entry.class, "entry");
 
     /**
-     * If the number of elements is less than this threshold,
-     * then the table should be rehashed for saving space.
-     *
-     * @param  capacity  the table capacity.
-     * @return minimal number of elements for not rehashing.
+     * The unique instance of {@link SharedObjects}.
      */
-    private static int lowerCapacityThreshold(final int capacity) {
-        return capacity >>> 2;
-    }
+    static final SharedObjects CACHE = new SharedObjects(MAX_CACHED_OBJECTS);
 
     /**
-     * If the number of elements is greater than this threshold,
-     * then the table should be rehashed for better performance.
+     * Creates a set of shared objects. There is only one instance used by PROJ-JNI,
+     * but this constructor is package-private for allowing tests of the bounded mode.
      *
-     * @param  capacity  the table capacity.
-     * @return maximal number of elements for not rehashing.
+     * @param  maxCachedObjects  maximal number of wrappers retained by strong references,
+     *                           or 0 for retaining them by soft references.
      */
-    private static int upperCapacityThreshold(final int capacity) {
-        return capacity - (capacity >>> 2);
+    SharedObjects(final int maxCachedObjects) {
+        entries = ConcurrentHashMap.newKeySet();
+        hand    = new AtomicInteger();
+        pinned  = (maxCachedObjects != 0) ? new AtomicReferenceArray<>(maxCachedObjects) : null;
     }
 
     /**
-     * Returns a hash value for the given pointer when used in a table of the given capacity.
+     * Retains the given wrapper by a strong reference if the cache is in bounded mode.
+     * If the cache is full, the least recently used wrapper (as approximated by the CLOCK
+     * algorithm) is evicted. Concurrent invocations of this method advance the hand of
+     * the clock independently, so they never replace the same slot at the same time.
+     * Wrappers which have been {@linkplain #discard discarded} but are still in the ring
+     * (because their slot was not known at discard time) are replaced without second chance.
      *
-     * @param  key       the pointer value.
-     * @param  capacity  the hash table capacity.
-     * @return index in the table of given capacity.
+     * @param  value  the wrapper to retain.
      */
-    private static int hash(final long key, final int capacity) {
-        return (int) ((key & Long.MAX_VALUE) % capacity);
-    }
-
-    /**
-     * Rehashes the given table.
-     *
-     * @param  oldTable  the table to rehash.
-     * @param  count     number of elements in the table (including chained elements).
-     * @return the new table array, or {@code oldTable} if no rehash were needed.
-     */
-    private static Entry[] rehash(final Entry[] oldTable, final int count) {
-        /*
-         * Compute the capacity as twice the expected number of elements, then take
-         * (if possible) the closest prime number. This is based on classical books
-         * saying that prime values reduce the risk of key collisions.
-         */
-        int capacity = count * 2;
-        int i = ~Arrays.binarySearch(CAPACITIES, capacity);
-        if (i >= 0 && i < CAPACITIES.length) {
-            if (i != 0 && capacity - CAPACITIES[i-1] < CAPACITIES[i] - capacity) {
-                i--;
-            }
-            capacity = CAPACITIES[i];
-        }
-        if (capacity == oldTable.length) {
-            return oldTable;
-        }
-        /*
-         * Rehash the table.
-         */
-        final Entry[] table = new Entry[capacity];
-        for (Entry next : oldTable) {
-            while (next != null) {
-                final Entry e = next;
-                next = next.next;                       // Fetch `next` now because its value will change.
-                final int index = hash(e.key, capacity);
-                e.next = table[index];
-                table[index] = e;
+    private void pin(final IdentifiableObject value) {
+        if (pinned != null) {
+            final int length = pinned.length();
+            for (;;) {
+                final int i = Math.floorMod(hand.getAndIncrement(), length);
+                final IdentifiableObject candidate = pinned.get(i);
+                if (candidate != null && candidate.recentlyUsed && candidate.entry != null) {
+                    candidate.recentlyUsed = false;
+                } else if (pinned.compareAndSet(i, candidate, value)) {
+                    value.slot = i;
+                    break;
+                }
             }
         }
-        return table;
     }
 
     /**
-     * Invoked by {@link CleanerThread} when an element has been collected by the garbage collector.
-     * This method removes the soft reference from the {@link #table}. It is caller's responsibility
-     * to invoke {@link SharedPointer#release()} if invoked from {@link CleanerThread}.
+     * Registers a new wrapper. The wrapper will be retained according the policy described in class javadoc,
+     * and its native resources will be released by the {@link CleanerThread} after it has been garbage collected.
+     * This method shall be invoked at most once per wrapper.
      *
-     * @param  toRemove  the entry to remove from this map.
+     * @param  value  the wrapper to register.
      */
-    final void remove(final Entry toRemove) {
-        final long stamp = writeLock();
-        try {
-            removeUnderLock(toRemove);
-        } finally {
-            unlockWrite(stamp);
-        }
+    final void register(final IdentifiableObject value) {
+        final Entry entry = new Entry(value, pinned == null);
+        value.entry = entry;
+        entries.add(entry);
+        pin(value);
     }
 
     /**
-     * Implementation of {@link #remove(Entry)} invoked when the caller already has a lock.
-     * This variant is required because {@link StampedLock} is not re-entrant.
-     * This method does nothing if the given entry is not found.
+     * Returns whether the given wrapper is currently retained by a strong reference in the bounded mode.
+     * This method is for testing purpose only.
      *
-     * @param  toRemove  the entry to remove from this map.
+     * @param  value  the wrapper to test.
+     * @return whether the given wrapper is in the ring of the CLOCK algorithm.
      */
-    private void removeUnderLock(final Entry toRemove) {
-        assert isWriteLocked();
-        final int capacity = table.length;
-        if (toRemove.removeFrom(table, hash(toRemove.key, capacity))) {
-            if (--count < lowerCapacityThreshold(capacity)) {
-                final long currentTime = System.nanoTime();
-                if (currentTime - lastTimeNormalCapacity > REHASH_DELAY) {
-                    table = rehash(table, count);
-                    lastTimeNormalCapacity = currentTime;
+    final boolean isPinned(final IdentifiableObject value) {
+        if (pinned != null) {
+            for (int i = pinned.length(); --i >= 0;) {
+                if (pinned.get(i) == value) {
+                    return true;
                 }
             }
-            assert isValid();
         }
+        return false;
     }
 
     /**
-     * Checks if this {@code SharedObjects} is valid. This method counts the number of elements
-     * and compares it to {@link #count}. This method is invoked in assertions only.
+     * Returns the number of wrappers whose native resources have not yet been released.
+     * This includes wrappers that have been garbage collected but not yet processed by
+     * the {@link CleanerThread}.
      *
-     * @return whether {@link #count} matches the expected value.
+     * @return number of registered wrappers.
      */
-    private boolean isValid() {
-        if (count >= table.length) {
-            throw new AssertionError(count);
-        }
-        int n = 0;
-        for (Entry e : table) {
-            while (e != null) {
-                n++;
-                e = e.next;
-            }
-        }
-        return n == count;
+    final int size() {
+        return entries.size();
     }
 
     /**
-     * Returns the value to which this map maps the specified key.
-     * Returns {@code null} if the map contains no mapping for this key.
-     * Null keys are considered never present.
+     * Invoked by {@link CleanerThread} when an element has been collected by the garbage collector.
+     * This method removes the weak reference from the set of entries. It is caller's responsibility
+     * to invoke {@link SharedPointer#release()} if invoked from {@link CleanerThread}.
      *
-     * @param  key  key whose associated value is to be returned.
-     * @return the value to which this map maps the specified key.
+     * @param  toRemove  the entry to remove from this set.
      */
-    final IdentifiableObject get(final long key) {
-        /*
-         * First, try to get the entry without acquiring a lock. We look only at the entry
-         * found directly in the table; we do not follow the chain of entries because they
-         * may be inconsistent.
-         */
-        long stamp = tryOptimisticRead();
-        if (stamp != 0) {
-            final Entry[] t = table;                    // Protect from concurrent change.
-            final Entry e = t[hash(key, t.length)];
-            if (validate(stamp)) {
-                if (e == null) {
-                    return null;
-                } else if (e.key == key) {
-                    return e.get();
-                }
-            }
-        }
-        /*
-         * If the optimistic read did not worked, perform the "real" read here.
-         */
-        stamp = readLock();
-        try {
-            final int index = hash(key, table.length);
-            for (Entry e = table[index]; e != null; e = e.next) {
-                if (e.key == key) {
-                    return e.get();
-                }
-            }
-        } finally {
-            unlockRead(stamp);
-        }
-        return null;
+    final void remove(final Entry toRemove) {
+        entries.remove(toRemove);
     }
 
     /**
-     * Associates the specified value with the specified key in this map if no value were previously associated.
-     * If an other value is already associated to the given key, then the map is left unchanged and the current
-     * value is returned. Otherwise the specified value is associated to the key using a {@link SoftReference}
-     * and {@code null} is returned.
+     * Removes the entry for the given wrapper, if present, without enqueuing it in the {@link CleanerThread}.
+     * This is invoked when the caller will release the native resource explicitly. This method does nothing
+     * if the given wrapper has not been registered or has already been discarded.
      *
-     * @param  key    key with which the specified value is to be associated.
-     * @param  value  value to be associated with the specified key.
-     * @return the current value associated with specified key, or {@code null} if there was no mapping for key.
+     * @param  value  the wrapper to remove from this set.
      */
-    final IdentifiableObject putIfAbsent(final long key, final IdentifiableObject value) {
-        final long stamp = writeLock();
-        try {
-            int index = hash(key, table.length);
-            for (Entry e = table[index]; e != null; e = e.next) {
-                if (e.key == key) {
-                    final IdentifiableObject oldValue = e.get();
-                    if (oldValue != null) {
-                        return oldValue;
-                    }
-                    removeUnderLock(e);
-                    index = hash(key, table.length);
-                }
-            }
-            if (++count >= lowerCapacityThreshold(table.length)) {
-                if (count > upperCapacityThreshold(table.length)) {
-                    table = rehash(table, count);
-                    index = hash(key, table.length);
+    final void discard(final IdentifiableObject value) {
+        final Entry entry = ENTRY.getAndSet(value, null);
+        if (entry != null) {
+            entry.clear();                  // Cleared references are not enqueued.
+            entries.remove(entry);
+            if (pinned != null) {
+                /*
+                 * The slot is only a hint: it may be stale if the wrapper has been evicted,
+                 * in which case the slot contains another wrapper and the CAS does nothing.
+                 * If the slot is not yet known, the hand of the clock will clear it later.
+                 */
+                final int i = value.slot;
+                if (i >= 0 && i < pinned.length()) {
+                    pinned.compareAndSet(i, value, null);
                 }
-                lastTimeNormalCapacity = System.nanoTime();
             }
-            table[index] = new Entry(key, value, table[index]);
-            assert isValid();
-        } finally {
-            unlockWrite(stamp);
         }
-        return null;
     }
 
     /**
@@ -390,25 +258,23 @@ final class SharedObjects extends StampedLock implements Runnable {
      */
     @Override
     public void run() {
+        if (pinned != null) {
+            for (int i = pinned.length(); --i >= 0;) {
+                pinned.set(i, null);
+            }
+        }
         boolean found;
         do {
-            final Entry[] entries;
-            final long stamp = writeLock();
-            try {
-                entries = table;
-                table = new Entry[3];       // In case some write operation continue concurrently (but should not happen).
-            } finally {
-                unlockWrite(stamp);
-            }
             found = false;
-            for (Entry e : entries) {
-                while (e != null) {
-                    e.cleaner.release();
-                    e = e.next;
-                    found = true;
-                }
+            final Iterator<Entry> it = entries.iterator();
+            while (it.hasNext()) {
+                final Entry e = it.next();
+                it.remove();
+                e.cleaner.release();
+                found = true;
             }
-        } while (found);
+        } while (found);        // In case some write operation continue concurrently (but should not happen).
+        Reclaimer.drain();
         Context.destroyAll();
     }
 
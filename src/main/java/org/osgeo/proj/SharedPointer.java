@@ -106,6 +106,55 @@ class SharedPointer extends NativeResource {
      */
     final native boolean getBooleanProperty(short property);
 
+    /**
+     * Returns the same property for all given objects as a column of strings.
+     * This is equivalent to invoking {@link #getStringProperty(short)} on each element,
+     * but with a single crossing of the JNI boundary. Null elements give null values.
+     *
+     * @param  objects   the objects for which to get property values.
+     * @param  property  one of {@link Property#NAME_STRING}, <i>etc.</i> values.
+     * @return values of the specified property, in the same order than the given objects.
+     * @throws RuntimeException if the specified property does not exist for one of the objects.
+     */
+    static native String[] getStringColumn(SharedPointer[] objects, short property);
+
+    /**
+     * Returns the same property for all given objects as a column of floating point numbers.
+     * This is equivalent to invoking {@link #getNumericProperty(short)} on each element,
+     * but with a single crossing of the JNI boundary. Null elements give NaN values.
+     *
+     * @param  objects   the objects for which to get property values.
+     * @param  property  one of {@link Property#MINIMUM}, <i>etc.</i> values.
+     * @return values of the specified property, in the same order than the given objects.
+     * @throws RuntimeException if the specified property does not exist for one of the objects.
+     */
+    static native double[] getNumericColumn(SharedPointer[] objects, short property);
+
+    /**
+     * Returns the same property for all given objects as a flattened column of arrays.
+     * Values of object <var>i</var> are stored at index {@code i*length} inclusive to
+     * {@code (i+1)*length} exclusive. Undefined values are NaN.
+     *
+     * @param  objects   the objects for which to get property values.
+     * @param  property  one of {@link Property#DOMAIN_OF_VALIDITY}, <i>etc.</i> values.
+     * @param  length    number of values per object.
+     * @return values of the specified property, in the same order than the given objects.
+     * @throws RuntimeException if the specified property does not exist for one of the objects.
+     */
+    static native double[] getArrayColumn(SharedPointer[] objects, short property, int length);
+
+    /**
+     * Returns the same property for all given objects as a column of boolean values.
+     * This is equivalent to invoking {@link #getBooleanProperty(short)} on each element,
+     * but with a single crossing of the JNI boundary. Null elements give false values.
+     *
+     * @param  objects   the objects for which to get property values.
+     * @param  property  one of {@link Property#IS_SPHERE}, <i>etc.</i> values.
+     * @return values of the specified property, in the same order than the given objects.
+     * @throws RuntimeException if the specified property does not exist for one of the objects.
+     */
+    static native boolean[] getBooleanColumn(SharedPointer[] objects, short property);
+
     /**
      * Returns the size of the identified property of kind {@code std::vector}.
      * If {@code property} is {@link Property#AXIS}, the returned value is the number of dimensions.
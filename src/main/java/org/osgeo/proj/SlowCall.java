@@ -0,0 +1,392 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.time.Instant;
+import java.util.Arrays;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+
+
+/**
+ * A call to PROJ which took more time than a configurable threshold.
+ * The slow-call recorder is disabled by default. It is enabled by setting the
+ * "{@code org.osgeo.proj.slowCallThreshold}" system property to a duration in milliseconds.
+ * When enabled, the calls to PROJ for creating coordinate operations, creating {@code PJ} objects,
+ * transforming coordinates, parsing WKT and creating objects from user input are timed, and the
+ * calls that exceed the threshold are kept in a ring of bounded capacity. The capacity is given by
+ * the "{@code org.osgeo.proj.slowCallCapacity}" system property (100 by default).
+ * The most recent slow calls can be obtained by {@link Proj#getSlowCalls()}.
+ *
+ * <p>Each record contains the operation or CRS identifiers, the input size, the state of the caches
+ * that may explain the latency, whether the call failed, the durations of the sub-phases of the call
+ * and the Java stack trace of the caller. Slow calls are recorded whether they succeeded or failed. When the recorder is disabled, the cost on the instrumented calls is negligible.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class SlowCall {
+    /**
+     * Minimal duration in nanoseconds of the calls to record, or 0 if the recorder is disabled.
+     * Initialized from the {@code "org.osgeo.proj.slowCallThreshold"} system property (in milliseconds).
+     */
+    private static volatile long threshold;
+    static {
+        final Long n = Long.getLong("org.osgeo.proj.slowCallThreshold");
+        threshold = (n != null && n > 0) ? TimeUnit.MILLISECONDS.toNanos(n) : 0;
+    }
+
+    /**
+     * The most recent slow calls. This array is used as a ring buffer.
+     * All accesses shall be synchronized on this array.
+     */
+    private static final SlowCall[] RING;
+    static {
+        final Integer n = Integer.getInteger("org.osgeo.proj.slowCallCapacity");
+        RING = new SlowCall[(n != null) ? Math.max(1, n) : 100];
+    }
+
+    /**
+     * Phases of the parsing of WKT or user input reported in records.
+     */
+    static final String[] PARSE_PHASES = {"context", "parse"};
+
+    /**
+     * Total number of slow calls recorded since the JVM started.
+     * The index in {@link #RING} of the next slow call is this count modulo the ring length.
+     * All accesses shall be synchronized on {@link #RING}.
+     */
+    private static long count;
+
+    /**
+     * Name of the instrumented call, for example {@code "Transform.transform"}.
+     */
+    private final String call;
+
+    /**
+     * Identifiers or description of the operation or CRS involved in the call, or {@code null} if none.
+     */
+    private final String subject;
+
+    /**
+     * Size of the input, as a number of points, characters or CRS pairs depending on the call.
+     */
+    private final long inputSize;
+
+    /**
+     * State of the caches at the time of the call, or {@code null} if not applicable.
+     */
+    private final String cacheState;
+
+    /**
+     * Description of the exception thrown by the call, or {@code null} if the call completed normally.
+     */
+    private final String failure;
+
+    /**
+     * Time when the call started.
+     */
+    private final Instant start;
+
+    /**
+     * Total duration of the call in nanoseconds.
+     */
+    private final long duration;
+
+    /**
+     * Names of the sub-phases of the call, in execution order.
+     */
+    private final String[] phases;
+
+    /**
+     * Durations in nanoseconds of the sub-phases, in the same order than {@link #phases}.
+     */
+    private final long[] phaseDurations;
+
+    /**
+     * Name of the thread which executed the call.
+     */
+    private final String thread;
+
+    /**
+     * The Java stack trace of the caller.
+     */
+    private final StackTraceElement[] stackTrace;
+
+    /**
+     * Creates a new record. See {@link #record record(…)} for a description of arguments.
+     * Phases with an end time of 0 have not been reached because of a failure, and are omitted.
+     */
+    private SlowCall(final String call, final String subject, final long inputSize, final String cacheState,
+                     final Throwable failure, final long startTime, final String[] phases, final long[] ends)
+    {
+        final long now  = System.nanoTime();
+        this.call       = call;
+        this.subject    = subject;
+        this.inputSize  = inputSize;
+        this.cacheState = cacheState;
+        this.failure    = (failure != null) ? failure.toString() : null;
+        this.duration   = now - startTime;
+        this.start      = Instant.now().minusNanos(duration);
+        this.phases     = phases;
+        int reached = 0;
+        while (reached < ends.length && ends[reached] != 0) reached++;
+        phaseDurations  = new long[reached];
+        long previous   = startTime;
+        for (int i=0; i<reached; i++) {
+            phaseDurations[i] = ends[i] - previous;
+            previous = ends[i];
+        }
+        thread = Thread.currentThread().getName();
+        final StackTraceElement[] trace = new Throwable().getStackTrace();
+        stackTrace = Arrays.copyOfRange(trace, Math.min(2, trace.length), trace.length);    // Omit constructor and record(…).
+    }
+
+    /**
+     * Returns the current time for measuring the duration of an instrumented call,
+     * or 0 if the recorder is disabled. This method shall be invoked only at the beginning of the call.
+     * The end of each sub-phase shall be obtained by {@link #now(long)}, so that the recorder state
+     * is captured only once per call.
+     *
+     * @return value of {@link System#nanoTime()}, or 0 if the recorder is disabled.
+     */
+    static long now() {
+        return (threshold != 0) ? System.nanoTime() : 0;
+    }
+
+    /**
+     * Returns the current time for measuring the end of a sub-phase of an instrumented call,
+     * or 0 if the recorder was disabled at the beginning of the call. The recorder state is
+     * not checked again, so a change of threshold during the call can not produce negative durations.
+     *
+     * @param  startTime  value returned by {@link #now()} at the beginning of the call.
+     * @return value of {@link System#nanoTime()}, or 0 if the recorder was disabled.
+     */
+    static long now(final long startTime) {
+        return (startTime != 0) ? System.nanoTime() : 0;
+    }
+
+    /**
+     * Returns whether a call which started at the given time exceeded the threshold.
+     * This method returns {@code false} if the recorder is disabled.
+     *
+     * @param  startTime  value returned by {@link #now()} at the beginning of the call.
+     * @return whether the call should be recorded.
+     */
+    static boolean isSlow(final long startTime) {
+        final long t = threshold;
+        return t != 0 && startTime != 0 && System.nanoTime() - startTime >= t;
+    }
+
+    /**
+     * Records a slow call. This method should be invoked only if {@link #isSlow(long)} returned {@code true},
+     * in the thread which executed the call for capturing the stack trace of the caller. It should be invoked
+     * in a {@code finally} block, so that failed calls are recorded too.
+     *
+     * @param call        name of the instrumented call.
+     * @param subject     identifiers of the operation or CRS involved in the call, or {@code null} if none.
+     * @param inputSize   size of the input, as a number of points, characters or CRS pairs.
+     * @param cacheState  state of the caches at the time of the call, or {@code null} if not applicable.
+     * @param failure     the exception thrown by the call, or {@code null} if the call completed normally.
+     * @param startTime   value returned by {@link #now()} at the beginning of the call.
+     * @param phases      names of the sub-phases of the call, in execution order.
+     * @param ends        values returned by {@link #now(long)} at the end of each sub-phase,
+     *                    or 0 for the phases that have not been reached.
+     */
+    static void record(final String call, final String subject, final long inputSize, final String cacheState,
+                       final Throwable failure, final long startTime, final String[] phases, final long... ends)
+    {
+        final SlowCall entry = new SlowCall(call, subject, inputSize, cacheState, failure, startTime, phases, ends);
+        synchronized (RING) {
+            RING[(int) (count++ % RING.length)] = entry;
+        }
+    }
+
+    /**
+     * Returns a label for the given object, for use as the subject of a record.
+     *
+     * @param  object  the CRS or operation, or {@code null}.
+     * @return authority code or name of the given object, or {@code null}.
+     */
+    static String label(final Object object) {
+        return (object instanceof IdentifiableObject) ? ((IdentifiableObject) object).getNameString(true) : null;
+    }
+
+    /**
+     * Sets the minimal duration of the calls to record. A value of 0 disables the recorder.
+     * This is used by tests, since the threshold is normally given by a system property.
+     *
+     * @param  value  the new threshold in nanoseconds, or 0 for disabling the recorder.
+     */
+    static void setThreshold(final long value) {
+        threshold = Math.max(0, value);
+    }
+
+    /**
+     * Returns the most recent slow calls, from oldest to newest.
+     *
+     * @return the most recent slow calls.
+     *
+     * @see Proj#getSlowCalls()
+     */
+    static List<SlowCall> recent() {
+        final List<SlowCall> list = new ArrayList<>();
+        synchronized (RING) {
+            final int length = RING.length;
+            for (long i = Math.max(0, count - length); i < count; i++) {
+                list.add(RING[(int) (i % length)]);
+            }
+        }
+        return Collections.unmodifiableList(list);
+    }
+
+    /**
+     * Returns the name of the instrumented call, for example {@code "Transform.transform"}.
+     *
+     * @return name of the instrumented call.
+     */
+    public String getCall() {
+        return call;
+    }
+
+    /**
+     * Returns the identifiers or a description of the operation or CRS involved in the call.
+     * For coordinate operations, this is the source and target CRS identifiers.
+     *
+     * @return the operation or CRS involved in the call, or {@code null} if unknown.
+     */
+    public String getSubject() {
+        return subject;
+    }
+
+    /**
+     * Returns the size of the input. This is a number of points for transforms, a number of
+     * characters for parsing and creation from PROJ strings, or 1 for coordinate operation searches.
+     *
+     * @return size of the input.
+     */
+    public long getInputSize() {
+        return inputSize;
+    }
+
+    /**
+     * Returns the state of the caches that may explain the latency, for example
+     * whether the {@code PJ} object was reused or created for this call.
+     *
+     * @return state of the caches, or {@code null} if not applicable.
+     */
+    public String getCacheState() {
+        return cacheState;
+    }
+
+    /**
+     * Returns a description of the exception thrown by the call, or {@code null} if the call completed normally.
+     *
+     * @return the exception thrown by the call, or {@code null} if none.
+     */
+    public String getFailure() {
+        return failure;
+    }
+
+    /**
+     * Returns the time when the call started.
+     *
+     * @return time when the call started.
+     */
+    public Instant getStartTime() {
+        return start;
+    }
+
+    /**
+     * Returns the total duration of the call.
+     *
+     * @param  unit  the desired unit of measurement.
+     * @return duration of the call in the given unit.
+     */
+    public long getDuration(final TimeUnit unit) {
+        return unit.convert(duration, TimeUnit.NANOSECONDS);
+    }
+
+    /**
+     * Returns the durations in nanoseconds of the sub-phases of the call, in execution order.
+     * Typical phases are the acquisition of a thread context, the acquisition of a {@code PJ}
+     * object and the call to PROJ. If the call failed, the phases after the failure are omitted.
+     *
+     * @return durations in nanoseconds of the sub-phases, keyed by phase name.
+     */
+    public Map<String,Long> getPhases() {
+        final Map<String,Long> map = new LinkedHashMap<>();
+        for (int i=0; i<phaseDurations.length; i++) {
+            map.put(phases[i], phaseDurations[i]);
+        }
+        return map;
+    }
+
+    /**
+     * Returns the name of the thread which executed the call.
+     *
+     * @return name of the thread which executed the call.
+     */
+    public String getThreadName() {
+        return thread;
+    }
+
+    /**
+     * Returns the Java stack trace of the caller.
+     *
+     * @return the stack trace of the caller.
+     */
+    public StackTraceElement[] getStackTrace() {
+        return stackTrace.clone();
+    }
+
+    /**
+     * Returns a single-line summary of this record, without the stack trace.
+     *
+     * @return a summary of this record.
+     */
+    @Override
+    public String toString() {
+        final StringBuilder buffer = new StringBuilder(call).append(" (");
+        if (subject != null) {
+            buffer.append(subject).append(", ");
+        }
+        buffer.append("input size ").append(inputSize);
+        if (cacheState != null) {
+            buffer.append(", ").append(cacheState);
+        }
+        if (failure != null) {
+            buffer.append(", failed with ").append(failure);
+        }
+        buffer.append(") took ").append(duration / 1E6).append(" ms:");
+        for (int i=0; i<phaseDurations.length; i++) {
+            buffer.append(' ').append(phases[i]).append('=').append(phaseDurations[i] / 1E6).append(" ms");
+        }
+        return buffer.toString();
+    }
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Arrays;
+import java.util.Objects;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * Transforms the coordinates in CSV or other delimited texts. The texts are parsed, transformed and
+ * formatted back in native code, from a direct buffer to another. Files are read and written by chunks.
+ * The text contains one coordinate tuple per line, with values in columns separated by a delimiter.
+ * If the delimiter is {@code '\0'}, then the columns are separated by sequences of spaces or tabulations.
+ * Otherwise each occurrence of the delimiter starts a new column, and spaces around values are ignored.
+ * Quotes are not interpreted. Numbers are always parsed and formatted with {@code '.'} as the decimal
+ * separator, regardless of the locale of the process.
+ *
+ * <p>The coordinate values are read from the given columns in the order expected by the coordinate
+ * operation (for example latitude before longitude for EPSG:4326), and the transformed values are
+ * written in the same columns, in the order of the target coordinate reference system.
+ * Other columns, delimiters, line separators, empty lines, lines starting with {@code '#'}
+ * and the {@linkplain #setHeaderLines header lines} are copied unchanged.</p>
+ *
+ * <h2>Limitations</h2>
+ * <p>{@code TextTransform} is <em>not</em> thread-safe during configuration. After configuration,
+ * the {@code transform(…)} methods can be invoked concurrently if the configuration is not modified.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class TextTransform {
+    /**
+     * Number of bytes read from a file in each chunk. The target buffer is initially twice as large.
+     */
+    private static final int CHUNK_SIZE = 1 << 20;
+
+    /**
+     * The batch transform which provides the {@code PJ} and the execution lane.
+     */
+    private final BatchTransform batch;
+
+    /**
+     * The column delimiter, or 0 for sequences of spaces and tabulations.
+     */
+    private final char delimiter;
+
+    /**
+     * Index of the column of each coordinate value.
+     */
+    private final int[] columns;
+
+    /**
+     * Number of lines to copy unchanged at the beginning of a file.
+     */
+    private int headerLines;
+
+    /**
+     * Number of fraction digits of formatted values, or -1 for the shortest representation
+     * which is parsed back to the same {@code double} value.
+     */
+    private int fractionDigits;
+
+    /**
+     * Creates a new adapter for transforming texts with the given batch transform, delimiter and columns.
+     * Only the {@linkplain BatchTransform#getPriority() priority} of the batch transform is used;
+     * quantization, spatial ordering, deduplication, reductions and domain guard are not applied.
+     *
+     * @param  batch      the batch transform to use.
+     * @param  delimiter  the column delimiter (for example {@code ','} or {@code ';'}),
+     *                    or {@code '\0'} for sequences of spaces and tabulations.
+     * @param  columns    zero-based index of the column of each coordinate value (2 or 3 values).
+     * @throws IllegalArgumentException if the delimiter is not an ASCII character,
+     *         or if the column indices are negative, duplicated or not 2 or 3.
+     */
+    public TextTransform(final BatchTransform batch, final char delimiter, final int... columns) {
+        this.batch = Objects.requireNonNull(batch);
+        if (delimiter >= 128 || delimiter == '\n' || delimiter == '\r') {
+            throw new IllegalArgumentException("Illegal delimiter.");
+        }
+        if (columns.length < 2 || columns.length > 3 || Arrays.stream(columns).distinct().count() != columns.length
+                || Arrays.stream(columns).anyMatch((i) -> i < 0))
+        {
+            throw new IllegalArgumentException("Illegal column indices: " + Arrays.toString(columns));
+        }
+        this.delimiter = delimiter;
+        this.columns   = columns.clone();
+        fractionDigits = -1;
+    }
+
+    /**
+     * Returns the number of lines to copy unchanged at the beginning of a file.
+     *
+     * @return number of header lines. The default value is 0.
+     */
+    public int getHeaderLines() {
+        return headerLines;
+    }
+
+    /**
+     * Sets the number of lines to copy unchanged at the beginning of a file.
+     * This is used for skipping the column titles of CSV files.
+     *
+     * @param  count  number of header lines.
+     */
+    public void setHeaderLines(final int count) {
+        if (count < 0) {
+            throw new IllegalArgumentException("Negative number of lines.");
+        }
+        headerLines = count;
+    }
+
+    /**
+     * Returns the number of fraction digits of the transformed values, or -1 for shortest round-trip.
+     *
+     * @return number of fraction digits, or -1 for the shortest representation.
+     */
+    public int getFractionDigits() {
+        return fractionDigits;
+    }
+
+    /**
+     * Sets the number of fraction digits of the transformed values. A negative value (the default)
+     * formats each value with the smallest number of significant digits which is parsed back to the
+     * same {@code double} value. A fixed number of digits (for example 3 for millimetres in a projected
+     * CRS, or 8 for degrees) gives shorter files.
+     *
+     * @param  digits  number of fraction digits, or -1 for the shortest round-trip representation.
+     */
+    public void setFractionDigits(final int digits) {
+        fractionDigits = Math.max(-1, Math.min(17, digits));
+    }
+
+    /**
+     * Transforms the coordinates of a text file and writes the result in another text file.
+     * The result is written with the same lines, where only the coordinate values are replaced.
+     * The file is read and written by chunks, which are parsed, transformed and formatted in native code.
+     * The buffers are enlarged if a line does not fit in a chunk. Points that can not be transformed are
+     * written as {@code NaN}. In such case, the whole file is written before a {@code TransformException}
+     * is thrown.
+     *
+     * @param  source  the file to read.
+     * @param  target  the file to write. Shall not be the source file. Overwritten if it exists.
+     * @return number of coordinate tuples transformed.
+     * @throws IOException if an error occurred while reading or writing a file.
+     * @throws IllegalArgumentException if the target is the source or if a coordinate value can not be parsed.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public long transform(final Path source, final Path target) throws IOException, TransformException {
+        if (Files.exists(target) && Files.isSameFile(source, target)) {
+            throw new IllegalArgumentException("The target file shall not be the source file.");
+        }
+        final int[] positions = new int[4];
+        TransformException failure = null;
+        long lineNumber = 0;
+        long count = 0;
+        try (FileChannel in  = FileChannel.open(source, StandardOpenOption.READ);
+             FileChannel out = FileChannel.open(target, StandardOpenOption.WRITE,
+                     StandardOpenOption.CREATE, StandardOpenOption.TRUNCATE_EXISTING))
+        {
+            ByteBuffer src = ByteBuffer.allocateDirect(CHUNK_SIZE);
+            ByteBuffer dst = ByteBuffer.allocateDirect(2 * CHUNK_SIZE);
+            boolean eof = false;
+            do {
+                while (!eof && src.hasRemaining()) {
+                    eof = in.read(src) < 0;
+                }
+                src.flip();
+                try {
+                    count += run(src, dst, positions, lineNumber, headerLines, eof);
+                } catch (TransformException e) {
+                    if (positions[2] == 0 && positions[3] == 0) {
+                        throw e;                        // Failure before any line has been processed.
+                    }
+                    if (failure == null) failure = e;
+                }
+                lineNumber += positions[2];
+                dst.flip();
+                while (dst.hasRemaining()) {
+                    out.write(dst);
+                }
+                dst.clear();
+                if (positions[3] > dst.capacity()) {
+                    // A line is too long for the target buffer, even when empty.
+                    dst = ByteBuffer.allocateDirect(Math.max(positions[3], 2 * dst.capacity()));
+                }
+                src.compact();
+                if (!src.hasRemaining() && positions[2] == 0 && positions[3] == 0) {
+                    // A line is too long for the source buffer.
+                    src.flip();
+                    src = ByteBuffer.allocateDirect(2 * src.capacity()).put(src);
+                }
+            } while (!eof || src.position() != 0);
+        }
+        if (failure != null) {
+            throw failure;
+        }
+        return count;
+    }
+
+    /**
+     * Transforms the coordinates of a text in a direct buffer and writes the result in another direct buffer.
+     * The characters between the source position and limit are processed line by line as described in
+     * {@link #transform(Path, Path)}, except that header lines are not recognized.
+     * If {@code endOfInput} is {@code false}, only the lines terminated by a line separator are processed.
+     * Lines are written in the target buffer until there is not enough room for the next line.
+     *
+     * <p>On return, the source position is after the last line consumed and the target position is after
+     * the last character written. The caller should continue with the remaining source characters, in
+     * the usual way of {@link java.nio.channels.ReadableByteChannel} loops. Giving a target buffer at
+     * least twice as large as the source is recommended, because lines that do not fit in the target
+     * are parsed and transformed again in the next call.</p>
+     *
+     * @param  source      the direct buffer containing the text to transform, in an ASCII-compatible encoding.
+     * @param  target      the direct buffer where to write the result.
+     * @param  endOfInput  whether the source buffer contains the end of the text.
+     * @return number of coordinate tuples written in the target buffer.
+     * @throws IllegalArgumentException if a buffer is not direct, if a coordinate value can not be parsed,
+     *         or if the next line would not fit in the target buffer even if it was empty.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public long transform(final ByteBuffer source, final ByteBuffer target, final boolean endOfInput)
+            throws TransformException
+    {
+        if (!source.isDirect() || !target.isDirect()) {
+            throw new IllegalArgumentException("The buffers shall be direct.");
+        }
+        if (target.isReadOnly()) {
+            throw new IllegalArgumentException("The target buffer is read-only.");
+        }
+        final int[] positions = new int[4];
+        final long count = run(source, target, positions, 0, 0, endOfInput);
+        if (positions[2] == 0 && positions[3] > target.capacity()) {
+            throw new IllegalArgumentException("The target buffer can not hold a line of " + positions[3] + " bytes.");
+        }
+        return count;
+    }
+
+    /**
+     * Transforms the text between the positions and limits of the given buffers, then updates the buffer
+     * positions. On return, {@code positions} contains the number of lines consumed at index 2 and the
+     * length of the first line which did not fit in the target at index 3.
+     *
+     * @param  source      the direct buffer containing the text to transform.
+     * @param  target      the direct buffer where to write the result.
+     * @param  positions   an array of length 4 where to store the positions, number of lines and overflow.
+     * @param  lineNumber  number of lines before the source position.
+     * @param  header      number of lines to copy unchanged at the beginning of the text.
+     * @param  endOfInput  whether the source buffer contains the end of the text.
+     * @return number of coordinate tuples written in the target buffer.
+     */
+    private long run(final ByteBuffer source, final ByteBuffer target, final int[] positions,
+                     final long lineNumber, final long header, final boolean endOfInput) throws TransformException
+    {
+        positions[0] = source.position();
+        positions[1] = target.position();
+        positions[2] = 0;
+        positions[3] = 0;
+        try {
+            return batch.execute((tr) -> tr.transformTextBuffer(source, positions[0], source.limit(),
+                                                                target, positions[1], target.limit(),
+                                                                columns, delimiter, lineNumber, header,
+                                                                fractionDigits, endOfInput, positions));
+        } finally {
+            source.position(positions[0]);
+            target.position(positions[1]);
+        }
+    }
+}
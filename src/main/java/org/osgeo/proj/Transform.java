@@ -22,7 +22,10 @@
  */
 package org.osgeo.proj;
 
+import java.nio.ByteBuffer;
+import java.lang.annotation.Native;
 import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.NoninvertibleTransformException;
 import org.opengis.referencing.operation.TransformException;
 
 
@@ -33,10 +36,45 @@ import org.opengis.referencing.operation.TransformException;
  * and should be used only in that context.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 2.0
+ * @version 2.1
  * @since   1.0
  */
 final class Transform extends NativeResource {
+    /**
+     * Identifies the type of Java arrays given to {@link #transformBatch transformBatch(…)}.
+     */
+    @Native
+    static final int DOUBLE = 0, FLOAT = 1, INT = 2, SHORT = 3;
+
+    /**
+     * Bitmask for the options of {@link #transformBatch transformBatch(…)}.
+     * {@code REORDER} transforms the points in the order of a Morton curve.
+     * {@code DEDUPLICATE} transforms only once the tuples which are repeated in the batch.
+     * {@code COMPACT} writes only the tuples retained by the reductions, consecutively.
+     */
+    @Native
+    static final int REORDER = 1, DEDUPLICATE = 2, COMPACT = 4;
+
+    /**
+     * The lane of the context for which this {@code PJ} has been created.
+     * This is used for giving back this {@code Transform} to the cache of the same lane.
+     */
+    final Priority priority;
+
+    /**
+     * Whether this {@code Transform} has been given back to a {@link TransformPool} cache at least once.
+     * A {@code false} value after acquisition means that the {@code PJ} has been created for the caller.
+     * Used only for {@link SlowCall} records.
+     */
+    boolean recycled;
+
+    /**
+     * Whether to execute the {@code PJ} in the inverse direction. The same {@code PJ} is used
+     * for a PROJ pipeline and its inverse; this flag is set by {@link TransformPool#acquire(Context, boolean)}
+     * and read by the native code at each transformation.
+     */
+    boolean inverse;
+
     /**
      * Creates a new {@code PJ}.
      *
@@ -47,6 +85,38 @@ final class Transform extends NativeResource {
      */
     Transform(final NativeResource operation, final Context context) throws FactoryException, TransformException {
         super(context.createPJ(operation));
+        priority = context.priority;
+    }
+
+    /**
+     * Creates a new {@code PJ} directly from a PROJ string, or from a CRS definition for checking
+     * the domain of validity of an operation having that CRS as its source.
+     *
+     * @param  definition  the PROJ string, typically a {@code "+proj=pipeline"} definition, or the CRS definition.
+     * @param  context     the thread context in which the operation will be executed.
+     * @param  kind        {@link TransformPool#PIPELINE}, {@link TransformPool#DOMAIN} or {@link TransformPool#FACTORS}.
+     * @throws FactoryException if the PROJ object can not be created.
+     */
+    Transform(final String definition, final Context context, final byte kind) throws FactoryException {
+        super(create(definition, context, kind));
+        priority = context.priority;
+    }
+
+    /**
+     * Creates the {@code PJ} of the given kind from the given definition.
+     *
+     * @param  definition  the PROJ string or the CRS definition.
+     * @param  context     the thread context in which the operation will be executed.
+     * @param  kind        {@link TransformPool#PIPELINE}, {@link TransformPool#DOMAIN} or {@link TransformPool#FACTORS}.
+     * @return address of the {@code PJ} created by this method.
+     * @throws FactoryException if the PROJ object can not be created.
+     */
+    private static long create(final String definition, final Context context, final byte kind) throws FactoryException {
+        switch (kind) {
+            case TransformPool.DOMAIN:  return context.createDomainPJ(definition);
+            case TransformPool.FACTORS: return context.createFactorsPJ(definition);
+            default:                    return context.createPipeline(definition);
+        }
     }
 
     /**
@@ -57,6 +127,13 @@ final class Transform extends NativeResource {
      */
     native void assign(Context context);
 
+    /**
+     * Returns whether the {@code PJ} wrapped by this {@code Transform} can be executed in the inverse direction.
+     *
+     * @return whether the {@code PJ} has an inverse operation.
+     */
+    native boolean hasInverse();
+
     /**
      * Transforms in-place the coordinates in the given array.
      * The coordinates array shall contain (<var>x</var>,<var>y</var>,<var>z</var>,<var>t</var>,…) tuples,
@@ -78,6 +155,182 @@ final class Transform extends NativeResource {
      */
     native void transform(int dimension, double[] coordinates, int offset, int numPts) throws TransformException;
 
+    /**
+     * Transforms coordinates from a source array to a target array, potentially of different types.
+     * The arrays can be {@code double[]}, {@code float[]}, {@code int[]} or {@code short[]}.
+     * The source values are converted by <var>x</var> = <var>q</var> × scale + offset before the transform,
+     * and the target values by <var>q</var> = round(<var>x</var> × scale + offset) after the transform,
+     * where rounding is applied only for integer types. The {@code dequantize} and {@code quantize}
+     * arrays contain the scale factors for all dimensions followed by the offsets for all dimensions.
+     *
+     * <p>It is caller's responsibility to ensure that the array types match the given type codes,
+     * that the array ranges are valid and that the source and target ranges do not overlap,
+     * unless they are in the same array at the same offset with the same number of dimensions.</p>
+     *
+     * <p>If the {@link #REORDER} flag is set, all coordinates are copied in a temporary native buffer
+     * and transformed in the order of a Morton (Z-order) curve, then written in their original order.
+     * If the {@link #DEDUPLICATE} flag is set, only the first occurrence of each distinct tuple is transformed
+     * and the result is copied to the duplicates, unless a sample shows that duplicates are rare.</p>
+     *
+     * <p>If {@code summary} is non-null, the transformed tuples are classified as failures (NaN or infinite values),
+     * outside the {@code extent} or retained. The {@code summary} array contains the number of failures, the number
+     * of tuples outside, the number of retained tuples, the minimal values and the maximal values of retained tuples.
+     * Those values are updated by this method. If {@code mask} is non-null, {@code mask[maskOff + i]} is set to
+     * whether tuple <var>i</var> is retained. If the {@link #COMPACT} flag is set, only retained tuples are written.
+     * Failures are counted in the summary instead of causing an exception.</p>
+     *
+     * <p>If {@code domain} is non-null, the source tuples are converted to geographic coordinates by that
+     * {@code PJ} and compared to the {@code bounds} of the domain of validity. Tuples outside the domain
+     * are not transformed by this {@code PJ}, but by the {@code fallback} if non-null. Otherwise their
+     * result is NaN, which is not reported as an error.</p>
+     *
+     * @param  srcDim      number of dimensions of source tuples.
+     * @param  srcPts      the source coordinates.
+     * @param  srcType     type of the source array as one of {@link #DOUBLE}, {@link #FLOAT}, {@link #INT} or {@link #SHORT}.
+     * @param  srcOff      index of the first coordinate value in the source array.
+     * @param  dequantize  scale factors and offsets for the source values, or {@code null} if none.
+     * @param  dstDim      number of dimensions of target tuples.
+     * @param  dstPts      the array where to write the transformed coordinates.
+     * @param  dstType     type of the target array as one of {@link #DOUBLE}, {@link #FLOAT}, {@link #INT} or {@link #SHORT}.
+     * @param  dstOff      index of the first coordinate value in the target array.
+     * @param  quantize    scale factors and offsets for the target values, or {@code null} if none.
+     * @param  numPts      number of points to transform.
+     * @param  flags       bitmask of {@link #REORDER}, {@link #DEDUPLICATE} and {@link #COMPACT}, or 0 if none.
+     * @param  extent      minimal values followed by maximal values of retained target tuples, or {@code null}.
+     * @param  mask        where to store whether each tuple is retained, or {@code null} if none.
+     * @param  maskOff     index in {@code mask} of the flag for the first tuple.
+     * @param  summary     counts and envelope to update, or {@code null} for no reduction.
+     * @param  domain      conversion of source tuples to geographic coordinates, or {@code null} for no check.
+     * @param  bounds      west, east, south and north bounds of the domain of validity, in degrees.
+     * @param  fallback    the transform to apply on tuples outside the domain, or {@code null} if none.
+     * @throws TransformException if the operation failed.
+     */
+    native void transformBatch(int srcDim, Object srcPts, int srcType, int srcOff, double[] dequantize,
+                               int dstDim, Object dstPts, int dstType, int dstOff, double[] quantize,
+                               int numPts, int flags, double[] extent, boolean[] mask, int maskOff,
+                               double[] summary, Transform domain, double[] bounds, Transform fallback)
+                               throws TransformException;
+
+    /**
+     * Transforms the coordinates of a GeoArrow array given by the addresses of its Arrow C Data Interface
+     * structures. The array can contain points, linestrings, polygons or their multi-geometry variants,
+     * in interleaved or separated coordinate layout. If the target addresses are non-zero, the source is
+     * copied in new {@code ArrowSchema} and {@code ArrowArray} structures written at the target addresses,
+     * then the copy is transformed. Otherwise the source coordinates are transformed in-place.
+     *
+     * <p>It is caller's responsibility to ensure that the addresses are valid, that the target structures
+     * are allocated and that the source buffers are writable if the transform is done in-place.</p>
+     *
+     * @param  srcSchema  address of the {@code ArrowSchema} describing the source array.
+     * @param  srcArray   address of the source {@code ArrowArray}.
+     * @param  dstSchema  address where to write the {@code ArrowSchema} of the result, or 0 for in-place.
+     * @param  dstArray   address where to write the result {@code ArrowArray}, or 0 for in-place.
+     * @param  extension  new GeoArrow extension metadata to store in the target schema, or {@code null}.
+     * @throws IllegalArgumentException if the source is not a supported GeoArrow array.
+     * @throws TransformException if the operation failed.
+     */
+    native void transformArrow(long srcSchema, long srcArray, long dstSchema, long dstArray, String extension)
+            throws TransformException;
+
+    /**
+     * Transforms a batch of WKB or EWKB geometries. The geometry <var>i</var> is stored in the source array
+     * from {@code offsets[i]} inclusive to {@code offsets[i+1]} exclusive, and is written in the target array
+     * at the same offsets with the same encoding. The target array can be the source array.
+     *
+     * <p>It is caller's responsibility to ensure that {@code offsets} contains at least {@code count + 1} elements
+     * and that all offsets are valid indices in both arrays. This method verifies that offsets are increasing.</p>
+     *
+     * @param  source    the source geometries in WKB or EWKB format.
+     * @param  target    the array where to write the transformed geometries. May be the same than {@code source}.
+     * @param  offsets   index of the first byte of each geometry, followed by the index after the last geometry.
+     * @param  count     number of geometries to transform.
+     * @param  srid      SRID to write in EWKB geometries, or a negative value for leaving the SRID unchanged.
+     * @param  failures  where to store whether each geometry failed, or {@code null} for throwing an exception instead.
+     * @throws IllegalArgumentException if a geometry is malformed.
+     * @throws TransformException if the operation failed and {@code failures} is null.
+     */
+    native void transformWKB(byte[] source, byte[] target, int[] offsets, int count, int srid, boolean[] failures)
+            throws TransformException;
+
+    /**
+     * Transforms in-place the coordinate tuples stored in many arrays of {@code double} or {@code float} values.
+     * Arrays of {@code double} values are given to PROJ without copy. Arrays of {@code float} values are copied
+     * in a temporary buffer of {@code double} values, then written back. The {@code layouts} array contains
+     * three values for each array: the type ({@link #DOUBLE} or {@link #FLOAT}), the number of values per tuple,
+     * and 1 if the third value of each tuple is the <var>z</var> coordinate or 0 otherwise.
+     * Values after <var>x</var>, <var>y</var> and the optional <var>z</var> are left unchanged.
+     *
+     * <p>It is caller's responsibility to ensure that all arrays are non-null
+     * and that {@code layouts} contains at least {@code 3*count} elements.</p>
+     *
+     * @param  arrays   the arrays of coordinates to transform in-place.
+     * @param  layouts  type, number of dimensions and <var>z</var> flag of each array.
+     * @param  count    number of arrays.
+     * @throws TransformException if a point can not be transformed.
+     */
+    native void transformPacked(Object[] arrays, int[] layouts, int count) throws TransformException;
+
+    /**
+     * Transforms the coordinates of a text stored in a direct buffer and writes the result in another buffer.
+     * Only complete lines are processed, unless {@code endOfInput} is true. Lines are written until the target
+     * is full. On return, {@code positions} contains the new source and target positions, the number of lines
+     * consumed, and the length of the first line which did not fit in the target (0 if none).
+     *
+     * @param  source          direct buffer containing the text to transform.
+     * @param  srcPos          position of the first character to transform.
+     * @param  srcLimit        position after the last character to transform.
+     * @param  target          direct buffer where to write the result.
+     * @param  dstPos          position where to write the first character.
+     * @param  dstLimit        position after the last character that can be written.
+     * @param  columns         index of the column of each coordinate value (2 or 3 values).
+     * @param  delimiter       the column delimiter, or 0 for sequences of spaces and tabulations.
+     * @param  lineNumber      number of lines before the source position.
+     * @param  headerLines     number of lines to copy unchanged at the beginning of the text.
+     * @param  fractionDigits  number of fraction digits, or a negative value for shortest round-trip.
+     * @param  endOfInput      whether the source contains the end of the text.
+     * @param  positions       where to store the new positions, the number of lines and the overflow (4 values).
+     * @return number of coordinate tuples transformed and written.
+     * @throws IllegalArgumentException if a coordinate value can not be parsed.
+     * @throws TransformException if a point can not be transformed.
+     */
+    native long transformTextBuffer(ByteBuffer source, int srcPos, int srcLimit,
+            ByteBuffer target, int dstPos, int dstLimit, int[] columns, int delimiter, long lineNumber,
+            long headerLines, int fractionDigits, boolean endOfInput, int[] positions) throws TransformException;
+
+    /**
+     * Transforms the given points forward then backward with this {@code PJ}, and computes statistics
+     * about the differences with the original coordinates. The given array is not modified.
+     * See {@link BatchTransform.Audit} for the content of the statistics array.
+     *
+     * @param  dimension    the dimension of each coordinate tuple.
+     * @param  coordinates  the coordinates to audit, as a sequence of (x,y,z,…) tuples.
+     * @param  offset       offset of the first coordinate in the given array.
+     * @param  numPts       number of points to audit.
+     * @param  statistics   where to store the failure counts and the error statistics.
+     * @param  worst        where to store the indices of the points having the largest errors.
+     * @param  worstErrors  where to store the errors of the points in the {@code worst} array.
+     * @throws NoninvertibleTransformException if the operation has no inverse.
+     * @throws TransformException if the audit can not be executed.
+     */
+    native void audit(int dimension, double[] coordinates, int offset, int numPts,
+            double[] statistics, int[] worst, double[] worstErrors) throws TransformException;
+
+    /**
+     * Computes the map projection distortion factors at the given geographic coordinates.
+     * This {@code Transform} shall have been created for {@link TransformPool#FACTORS}.
+     * See {@link BatchTransform#factors(double[], int, double[], int, int)} for the output values.
+     *
+     * @param  coordinates  the (longitude, latitude) tuples in degrees.
+     * @param  srcOff       offset of the first coordinate in the {@code coordinates} array.
+     * @param  factors      where to store the factors, {@link BatchTransform#NUM_FACTORS} values per point.
+     * @param  dstOff       offset of the first value to write in the {@code factors} array.
+     * @param  numPts       number of points for which to compute the factors.
+     * @return number of points for which the factors could not be computed.
+     * @throws TransformException if the computation can not be executed.
+     */
+    native int factors(double[] coordinates, int srcOff, double[] factors, int dstOff, int numPts)
+            throws TransformException;
+
     /**
      * Destroys the {@code PJ} object.
      */
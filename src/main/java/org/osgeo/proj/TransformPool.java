@@ -0,0 +1,456 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Set;
+import java.util.List;
+import java.util.ArrayList;
+import java.lang.ref.WeakReference;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * A cache of {@link Transform} instances created for the same coordinate operation.
+ * Each {@code Transform} instance can be used by only one thread at a time.
+ * We cache the {@code Transform} instances after use so they can be reused
+ * by the same thread or another thread.
+ *
+ * <p>The {@code PJ} objects can be created either from a wrapper of {@code CoordinateOperation}
+ * (in which case the operation is formatted as a PROJ string by PROJ), or directly from a PROJ string.
+ * The latter case avoid the creation of any metadata object. A pool can also provide the {@code PJ}
+ * which convert the source coordinates of an operation to geographic coordinates, for checking
+ * the domain of validity of that operation, or from a projected CRS definition for computing
+ * the map projection distortion factors.</p>
+ *
+ * <p>If the creation of a {@code PJ} fails (for example because of a missing datum shift grid),
+ * the failure is remembered and an exception with the same message is thrown by next calls to {@code acquire(…)}
+ * without new attempt, until the failure is {@linkplain #invalidateFailures() invalidated} or until
+ * the retry delay, if any, has elapsed.</p>
+ *
+ * <p><b>Reminder:</b> this class shall not contain any reference to the {@link Operation} or
+ * other object owning the pool, otherwise that owner would never be garbage collected.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+final class TransformPool {
+    /**
+     * The maximum number of {@link Transform} instances to cache in each lane. This maximum should be the expected
+     * maximum number of threads (or the "optimal" number of threads) using the same {@link Operation}
+     * concurrently. A low value does not necessarily block more threads from using {@code Operation},
+     * but the extra threads may observe a performance degradation.
+     */
+    private static final int NUM_THREADS;
+    static {
+        final Integer n = Integer.getInteger("org.osgeo.proj.maxThreadsPerInstance");
+        /*
+         * The default value below (4) is arbitrary. If that default value is modified,
+         * then the documentation in package-info.java file should be updated accordingly.
+         * The maximum is also arbitrary; we need to put a relatively low maximum because
+         * the simple algorithm used for the `transforms` array does not scale to a large
+         * number of entries. It should not be necessary to allow high numbers because it
+         * is only the maximum number of threads per Operation instance, not a global maximum.
+         */
+        NUM_THREADS = (n != null) ? Math.max(1, Math.min(16, n)) : 4;
+    }
+
+    /**
+     * Delay in nanoseconds before a new attempt to create a {@code PJ} after a failure, or 0 for no new attempt
+     * until the failures are {@linkplain #invalidateFailures() invalidated}. This is the value (in milliseconds)
+     * of the {@code "org.osgeo.proj.failureRetryDelay"} system property at startup time.
+     */
+    private static final long RETRY_DELAY;
+    static {
+        final Long n = Long.getLong("org.osgeo.proj.failureRetryDelay");
+        RETRY_DELAY = (n != null && n > 0) ? TimeUnit.MILLISECONDS.toNanos(n) : 0;
+    }
+
+    /**
+     * Incremented when all failures should be forgotten, for example after the installation of grid files.
+     * A {@link Failure} is valid only if its epoch is the current value of this counter.
+     */
+    private static final AtomicInteger FAILURE_EPOCH = new AtomicInteger();
+
+    /**
+     * Kinds of {@code PJ} to create from a {@linkplain #definition}, as values of the {@link #kind} field.
+     * {@code PIPELINE} is for a PROJ string, {@code DOMAIN} for a CRS to convert to geographic coordinates,
+     * and {@code FACTORS} for a projected CRS for which to compute the distortion factors.
+     */
+    static final byte PIPELINE = 0, DOMAIN = 1, FACTORS = 2;
+
+    /**
+     * The pools owned by objects which are not managed by {@link SharedObjects}.
+     * This set is needed for keeping the {@link Disposer} instances reachable
+     * until they are processed by the {@link CleanerThread}.
+     */
+    private static final Set<Disposer> DISPOSERS = ConcurrentHashMap.newKeySet();
+
+    /**
+     * The wrapper of the coordinate operation for which to create {@code PJ} objects,
+     * or {@code null} if the {@code PJ} are created from {@link #definition}.
+     */
+    private final NativeResource operation;
+
+    /**
+     * The PROJ string from which to create {@code PJ} objects,
+     * or {@code null} if the {@code PJ} are created from {@link #operation}.
+     */
+    private final String definition;
+
+    /**
+     * The kind of {@code PJ} objects to create from {@link #definition}.
+     * Shall be {@link #PIPELINE}, {@link #DOMAIN} or {@link #FACTORS}.
+     */
+    private final byte kind;
+
+    /**
+     * The {@code Transform} instances available for reuse, for each {@link Priority} lane.
+     * The array at index <var>i</var> contains the instances for the lane of ordinal <var>i</var>,
+     * so the {@code PJ} used by interactive requests are never taken by bulk jobs.
+     *
+     * <p>The array length is an arbitrary limit on the number of instances to cache,
+     * but this will not limit the number of concurrent threads doing transformations.
+     * It only means that the additional threads will go through the most costly process
+     * of creating new {@link Transform} instances.</p>
+     *
+     * <p><b>Design note:</b> the use of {@link java.util.concurrent.ArrayBlockingQueue}
+     * would be more efficient, but it is also a relatively heavy class for this simple need.
+     * We use arrays for now, with the requirement that all accesses to those arrays must be
+     * synchronized of {@code transforms}.</p>
+     */
+    private final Transform[][] transforms;
+
+    /**
+     * Whether {@link #dispose()} has been invoked. After that point, the {@link Transform}
+     * instances given back to the {@linkplain #transforms} cache shall be destroyed instead.
+     * All accesses to this field must be synchronized on {@link #transforms}.
+     */
+    private boolean disposed;
+
+    /**
+     * The last failure to create a {@code PJ}, or {@code null} if none.
+     * This is checked before each attempt to create a new {@code PJ}.
+     */
+    private volatile Failure failure;
+
+    /**
+     * Creates a pool of {@code PJ} for the given coordinate operation.
+     *
+     * @param  operation  wrapper of the coordinate operation for which to create {@code PJ} objects.
+     */
+    TransformPool(final NativeResource operation) {
+        this.operation  = operation;
+        this.definition = null;
+        this.kind       = PIPELINE;
+        this.transforms = new Transform[Priority.values().length][NUM_THREADS];
+    }
+
+    /**
+     * Creates a pool of {@code PJ} for the given PROJ string or CRS definition.
+     *
+     * @param  definition  the PROJ string or CRS definition from which to create {@code PJ} objects.
+     * @param  kind        {@link #PIPELINE}, {@link #DOMAIN} or {@link #FACTORS}.
+     */
+    TransformPool(final String definition, final byte kind) {
+        this.operation  = null;
+        this.definition = definition;
+        this.kind       = kind;
+        this.transforms = new Transform[Priority.values().length][NUM_THREADS];
+    }
+
+    /**
+     * Returns a {@code PJ} wrapper, creating a new one if none exist in the cache.
+     * The returned wrapper shall be used in a single thread.
+     * The {@link #release(Transform)} method must be invoked after usage,
+     * even on failure.
+     *
+     * @param  c  the current thread context.
+     * @return the {@code PJ} wrapper for the current thread.
+     * @throws FactoryException if the {@code PJ} object can not be allocated.
+     * @throws TransformException if the {@code PJ} object can not be created.
+     */
+    final Transform acquire(final Context c) throws FactoryException, TransformException {
+        return acquire(c, false);
+    }
+
+    /**
+     * Returns a {@code PJ} wrapper to be executed in the given direction.
+     * This is used by the inverse of a {@link Pipeline}, which shares the {@code PJ} objects of the forward pipeline.
+     *
+     * @param  c        the current thread context.
+     * @param  inverse  whether the {@code PJ} will be executed in the inverse direction.
+     * @return the {@code PJ} wrapper for the current thread.
+     * @throws FactoryException if the {@code PJ} object can not be allocated.
+     * @throws TransformException if the {@code PJ} object can not be created.
+     */
+    final Transform acquire(final Context c, final boolean inverse) throws FactoryException, TransformException {
+        final Transform tr = take(c);
+        tr.inverse = inverse;
+        return tr;
+    }
+
+    /**
+     * Implementation of {@link #acquire(Context, boolean)}, without setting the direction.
+     *
+     * @param  c  the current thread context.
+     * @return the {@code PJ} wrapper for the current thread.
+     * @throws FactoryException if the {@code PJ} object can not be allocated.
+     * @throws TransformException if the {@code PJ} object can not be created.
+     */
+    private Transform take(final Context c) throws FactoryException, TransformException {
+        synchronized (transforms) {
+            final Transform[] cache = transforms[c.priority.ordinal()];
+            for (int i=cache.length; --i >= 0;) {
+                final Transform tr = cache[i];
+                if (tr != null) {
+                    cache[i] = null;
+                    tr.assign(c);
+                    return tr;
+                }
+            }
+        }
+        final Failure f = failure;
+        if (f != null) {
+            if (f.isValid()) {
+                f.rethrow();
+            }
+            failure = null;
+        }
+        final long start = SlowCall.now();
+        final Transform tr;
+        Throwable error = null;
+        try {
+            tr = (definition != null) ? new Transform(definition, c, kind) : new Transform(operation, c);
+        } catch (FactoryException | TransformException e) {
+            failure = new Failure(e);
+            error = e;
+            throw e;
+        } catch (Throwable e) {
+            error = e;
+            throw e;
+        } finally {
+            if (SlowCall.isSlow(start)) {
+                final String subject;
+                if (definition != null) {
+                    subject = definition;
+                } else if (operation instanceof SharedPointer) {
+                    subject = ((SharedPointer) operation).getStringProperty(Property.NAME_STRING);
+                } else {
+                    subject = null;
+                }
+                SlowCall.record("Context.createPJ", subject, (definition != null) ? definition.length() : 0,
+                                (f != null) ? "retry after failure" : null, error,
+                                start, CREATE_PHASES, SlowCall.now(start));
+            }
+        }
+        return tr;
+    }
+
+    /**
+     * Phases of the {@code PJ} creation reported in {@link SlowCall} records.
+     */
+    private static final String[] CREATE_PHASES = {"create PJ"};
+
+    /**
+     * Forgets all failures to create {@code PJ} objects, in all pools. Next calls to {@code acquire(…)}
+     * will try again to create the {@code PJ}. This method should be invoked when the conditions that
+     * caused the failures may have changed, for example after grid files have been installed.
+     */
+    static void invalidateFailures() {
+        FAILURE_EPOCH.incrementAndGet();
+    }
+
+    /**
+     * A failure to create a {@code PJ}, with the exception of the failed attempt and the time of the failure.
+     * Next attempts throw a new exception with the original one as its cause, so the cached exception is not
+     * shared between threads and its stack trace is not modified by the callers.
+     */
+    private static final class Failure {
+        /**
+         * The message of the exception thrown by the failed attempt.
+         */
+        private final String message;
+
+        /**
+         * The exception thrown by the failed attempt, used as the cause of the exceptions thrown by next attempts.
+         * This is either a {@link FactoryException} or a {@link TransformException}.
+         */
+        private final Exception cause;
+
+        /**
+         * Value of {@link #FAILURE_EPOCH} at the time of the failure.
+         */
+        private final int epoch;
+
+        /**
+         * Value of {@link System#nanoTime()} at the time of the failure.
+         */
+        private final long time;
+
+        /**
+         * Records a failure which just happened.
+         *
+         * @param  cause  the exception thrown by the failed attempt.
+         */
+        Failure(final Exception cause) {
+            this.message = cause.getMessage();
+            this.cause   = cause;
+            this.epoch = FAILURE_EPOCH.get();
+            this.time  = System.nanoTime();
+        }
+
+        /**
+         * Returns whether this failure should still be reported instead of making a new attempt.
+         *
+         * @return whether this failure is still valid.
+         */
+        final boolean isValid() {
+            return epoch == FAILURE_EPOCH.get() && (RETRY_DELAY == 0 || System.nanoTime() - time < RETRY_DELAY);
+        }
+
+        /**
+         * Throws a new exception of the same kind and with the same message than the failed attempt.
+         * The exception of the failed attempt is the cause of the new exception.
+         *
+         * @throws FactoryException if the failed attempt threw a {@code FactoryException}.
+         * @throws TransformException if the failed attempt threw a {@code TransformException}.
+         */
+        final void rethrow() throws FactoryException, TransformException {
+            if (cause instanceof TransformException) {
+                throw new TransformException(message, cause);
+            }
+            throw new FactoryException(message, cause);
+        }
+    }
+
+    /**
+     * Releases the {@code PJ} wrapper, or destroys it if the cache is full or the pool has been disposed.
+     * The wrapper is given back to the cache of the lane for which it has been created. The destruction,
+     * if needed, is delegated to the {@link Reclaimer} thread, or done with the caller's context if the
+     * reclaimer can not accept more work.
+     *
+     * @param  tr  wrapper of the {@code PJ} to cache for reuse or to destroy.
+     */
+    final void release(final Transform tr) {
+        synchronized (transforms) {
+            if (!disposed) {
+                final Transform[] cache = transforms[tr.priority.ordinal()];
+                for (int i=cache.length; --i >= 0;) {
+                    if (cache[i] == null) {
+                        cache[i] = tr;
+                        tr.recycled = true;
+                        tr.assign(null);
+                        return;
+                    }
+                }
+            }
+        }
+        Reclaimer.destroy(tr, true);
+    }
+
+    /**
+     * Destroys all {@code PJ} objects in this pool. The {@code Transform} instances which are currently
+     * in use will be destroyed when they are {@linkplain #release(Transform) released}.
+     */
+    final void dispose() {
+        /*
+         * Synchronization should not be needed since the arrays should not be used anymore.
+         * But we still want the memory barrier effect, and the synchronization is a safety.
+         */
+        final List<Transform> removed = new ArrayList<>();
+        synchronized (transforms) {
+            disposed = true;
+            for (final Transform[] cache : transforms) {
+                for (int i=cache.length; --i >= 0;) {
+                    final Transform tr = cache[i];
+                    if (tr != null) {
+                        cache[i] = null;        // Needed if the owner has been closed explicitly.
+                        removed.add(tr);
+                    }
+                }
+            }
+        }
+        /*
+         * Destroy outside the synchronized block, because a synchronous destruction
+         * may wait for a context while other threads are releasing wrappers.
+         */
+        for (final Transform tr : removed) {
+            Reclaimer.destroy(tr, false);
+        }
+    }
+
+    /**
+     * Returns the number of pools waiting for the garbage collection of their owner.
+     * Used for diagnostic of memory growth.
+     *
+     * @return number of pools registered by {@link #disposeWhenUnreachable(Object)}.
+     */
+    static int disposerCount() {
+        return DISPOSERS.size();
+    }
+
+    /**
+     * Registers a task which will dispose this pool when the given owner is garbage collected.
+     * This is needed only for owners that are not {@link IdentifiableObject} instances,
+     * since the latter dispose their pool when their shared pointer is released.
+     *
+     * @param  owner  the object which owns this pool.
+     */
+    final void disposeWhenUnreachable(final Object owner) {
+        DISPOSERS.add(new Disposer(owner, this));
+    }
+
+    /**
+     * Task executed by the {@link CleanerThread} when the owner of a pool has been garbage collected.
+     */
+    static final class Disposer extends WeakReference<Object> {
+        /**
+         * The pool to dispose.
+         */
+        private final TransformPool pool;
+
+        /**
+         * Creates a new task for disposing the given pool after its owner has been garbage collected.
+         *
+         * @param  owner  the object which owns the pool.
+         * @param  pool   the pool to dispose.
+         */
+        private Disposer(final Object owner, final TransformPool pool) {
+            super(owner, CleanerThread.QUEUE);
+            this.pool = pool;
+        }
+
+        /**
+         * Invoked by the {@link CleanerThread} for disposing the pool.
+         */
+        final void dispose() {
+            DISPOSERS.remove(this);
+            pool.dispose();
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Objects;
+import org.opengis.referencing.operation.TransformException;
+
+
+/**
+ * Transforms geometries encoded in <cite>Well-Known Binary</cite> (WKB) or in the extended WKB (EWKB) of PostGIS.
+ * The geometries are transformed directly in their byte arrays, without decoding them as geometry objects.
+ * The geometries are parsed in native code, and all vertices of each geometry are transformed in a single
+ * call to PROJ. All geometry types of ISO 19125 are supported, including curves, surfaces and collections,
+ * with the <var>z</var> and <var>m</var> dimensions in ISO or EWKB convention. The <var>m</var> values
+ * are copied unchanged.
+ *
+ * <p>Instances of this class are thread-safe if the {@link BatchTransform} is not modified concurrently.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class WKBTransform {
+    /**
+     * The batch transform which provides the {@code PJ} and the execution lane.
+     */
+    private final BatchTransform batch;
+
+    /**
+     * Creates a new adapter for transforming WKB geometries with the given batch transform.
+     * Only the {@linkplain BatchTransform#getPriority() priority} of the batch transform is used;
+     * quantization, spatial ordering, deduplication, reductions and domain guard are not applied.
+     *
+     * @param  batch  the batch transform to use.
+     */
+    public WKBTransform(final BatchTransform batch) {
+        this.batch = Objects.requireNonNull(batch);
+    }
+
+    /**
+     * Transforms a geometry encoded in WKB or EWKB.
+     * See {@link #transform(byte[], int[], int, byte[], int, boolean[])} for details.
+     *
+     * @param  geometry  the geometry to transform in WKB or EWKB format.
+     * @param  srid      SRID to write in the result if the geometry contains a SRID, or -1 for no change.
+     * @return the transformed geometry, with the same encoding than the given geometry.
+     * @throws IllegalArgumentException if the geometry is malformed.
+     * @throws TransformException if a vertex can not be transformed.
+     */
+    public byte[] transform(final byte[] geometry, final int srid) throws TransformException {
+        final byte[] result = new byte[geometry.length];
+        transform(geometry, new int[] {0, geometry.length}, 1, result, srid, null);
+        return result;
+    }
+
+    /**
+     * Transforms a batch of geometries encoded in WKB or EWKB. The geometries are stored consecutively in
+     * the {@code source} array, and the geometry at index <var>i</var> is stored from {@code offsets[i]}
+     * inclusive to {@code offsets[i+1]} exclusive. Each transformed geometry is written in the {@code target}
+     * array at the same offsets, with the same encoding (byte order, dimensions and presence of SRID).
+     * The {@code target} array can be the {@code source} array for transforming the geometries in-place.
+     *
+     * <p>If an EWKB geometry contains a SRID and the {@code srid} argument is positive or zero,
+     * then the SRID is replaced by the given value. No SRID is added to geometries without SRID.</p>
+     *
+     * <p>If {@code failures} is non-null, then {@code failures[i]} is set to whether at least one vertex of the
+     * geometry at index <var>i</var> could not be transformed, and no exception is thrown for such failures.
+     * Otherwise, all geometries are transformed and an exception is thrown at the end if a vertex failed.</p>
+     *
+     * @param  source         the geometries to transform in WKB or EWKB format.
+     * @param  offsets        index of the first byte of each geometry, followed by the index after the last geometry.
+     * @param  numGeometries  number of geometries to transform.
+     * @param  target         the array where to write the transformed geometries. May be {@code source}.
+     * @param  srid           SRID to write in the geometries which contain a SRID, or -1 for no change.
+     * @param  failures       where to store whether each geometry failed, or {@code null} for throwing an exception.
+     * @throws IllegalArgumentException if an offset is invalid or if a geometry is malformed.
+     * @throws TransformException if a vertex can not be transformed and {@code failures} is null.
+     */
+    public void transform(final byte[] source, final int[] offsets, final int numGeometries,
+                          final byte[] target, final int srid, final boolean[] failures) throws TransformException
+    {
+        if (numGeometries > 0) {
+            if (offsets.length <= numGeometries) {
+                throw new IllegalArgumentException("Expected " + (numGeometries + 1) + " offsets but got " + offsets.length + '.');
+            }
+            final int start = offsets[0];
+            final int end   = offsets[numGeometries];
+            if (start < 0 || end > source.length || end > target.length) {
+                throw new IllegalArgumentException("Offsets are out of bounds.");
+            }
+            if (failures != null && failures.length < numGeometries) {
+                throw new IllegalArgumentException("The failures array is too small.");
+            }
+            batch.execute((tr) -> {
+                tr.transformWKB(source, target, offsets, numGeometries, srid, failures);
+                return null;
+            });
+        }
+    }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj.jts;
+
+import java.util.ArrayList;
+import java.util.List;
+import org.locationtech.jts.geom.CoordinateSequence;
+import org.locationtech.jts.geom.Geometry;
+import org.locationtech.jts.geom.GeometryCollection;
+import org.locationtech.jts.geom.LineString;
+import org.locationtech.jts.geom.Point;
+import org.locationtech.jts.geom.Polygon;
+import org.locationtech.jts.geom.impl.PackedCoordinateSequence;
+import org.opengis.referencing.operation.TransformException;
+import org.osgeo.proj.BatchTransform;
+import org.osgeo.proj.PackedTransform;
+
+
+/**
+ * Static methods for transforming JTS geometries with PROJ.
+ * All coordinate sequences of a geometry, including the rings of polygons and the members of collections,
+ * are given to the native library in a single call. The {@code double[]} or {@code float[]} arrays of
+ * {@link PackedCoordinateSequence} are transformed in-place without copy. The values of other sequences
+ * are copied in a temporary {@code double[]} array with {@link CoordinateSequence#getOrdinate getOrdinate(…)},
+ * transformed, then written back with {@link CoordinateSequence#setOrdinate setOrdinate(…)}.
+ * The {@code Coordinate} objects cached by the sequences are kept consistent. No {@code Coordinate} object is created.
+ *
+ * <p>The (<var>x</var>, <var>y</var>) values and the <var>z</var> value if present are transformed.
+ * A <var>z</var> value which is NaN, as in two-dimensional {@code Coordinate} objects, is handled as 0
+ * and is left NaN. The measures (<var>m</var> values) are left unchanged.</p>
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final class JTS {
+    /**
+     * Do not allow instantiation of this class.
+     */
+    private JTS() {
+    }
+
+    /**
+     * Returns a copy of the given geometry with all coordinates transformed.
+     * The given geometry is not modified.
+     *
+     * @param  <G>        the type of the geometry to transform.
+     * @param  geometry   the geometry to transform.
+     * @param  transform  the transform to apply.
+     * @return a transformed copy of the given geometry.
+     * @throws IllegalArgumentException if the geometry has less than 2 or more than 3 spatial dimensions.
+     * @throws TransformException if a point can not be transformed.
+     */
+    @SuppressWarnings("unchecked")
+    public static <G extends Geometry> G transform(final G geometry, final BatchTransform transform)
+            throws TransformException
+    {
+        final G copy = (G) geometry.copy();
+        transformInPlace(copy, transform);
+        return copy;
+    }
+
+    /**
+     * Transforms in-place all coordinates of the given geometry.
+     * If a point can not be transformed, the coordinates of some points may have been modified.
+     *
+     * @param  geometry   the geometry to transform.
+     * @param  transform  the transform to apply.
+     * @throws IllegalArgumentException if the geometry has less than 2 or more than 3 spatial dimensions.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public static void transformInPlace(final Geometry geometry, final BatchTransform transform)
+            throws TransformException
+    {
+        final List<CoordinateSequence> sequences = new ArrayList<>();
+        collect(geometry, sequences);
+        try {
+            transformInPlace(sequences.toArray(new CoordinateSequence[sequences.size()]), transform);
+        } finally {
+            geometry.geometryChanged();
+        }
+    }
+
+    /**
+     * Transforms in-place all coordinates of the given sequences in a single call to the native library.
+     *
+     * @param  sequences  the coordinate sequences to transform.
+     * @param  transform  the transform to apply.
+     * @throws IllegalArgumentException if a sequence has less than 2 or more than 3 spatial dimensions.
+     * @throws TransformException if a point can not be transformed.
+     */
+    public static void transformInPlace(final CoordinateSequence[] sequences, final BatchTransform transform)
+            throws TransformException
+    {
+        final int count = sequences.length;
+        final Object[] arrays     = new Object[count];
+        final int[]    dimensions = new int[count];
+        final int[]    measures   = new int[count];
+        final boolean[] packed    = new boolean[count];
+        for (int i=0; i<count; i++) {
+            final CoordinateSequence sequence = sequences[i];
+            final int dimension = sequence.getDimension();
+            if (sequence instanceof PackedCoordinateSequence.Double) {
+                arrays[i] = ((PackedCoordinateSequence.Double) sequence).getRawCoordinates();
+                packed[i] = true;
+            } else if (sequence instanceof PackedCoordinateSequence.Float) {
+                arrays[i] = ((PackedCoordinateSequence.Float) sequence).getRawCoordinates();
+                packed[i] = true;
+            } else {
+                final double[] copy = new double[sequence.size() * dimension];
+                for (int j=0; j<copy.length; j++) {
+                    copy[j] = sequence.getOrdinate(j / dimension, j % dimension);
+                }
+                arrays[i] = copy;
+            }
+            dimensions[i] = dimension;
+            measures[i]   = sequence.getMeasures();
+        }
+        try {
+            new PackedTransform(transform).transformInPlace(arrays, dimensions, measures);
+        } finally {
+            for (int i=0; i<count; i++) {
+                final CoordinateSequence sequence = sequences[i];
+                final Object array = arrays[i];
+                if (packed[i]) {
+                    /*
+                     * The raw array has been modified behind the back of the sequence, which may have
+                     * cached `Coordinate` objects. Writing a value with `setOrdinate(…)` discards that
+                     * cache. The value written is the one already in the array, so nothing else changes.
+                     */
+                    if (sequence.size() != 0) {
+                        sequence.setOrdinate(0, 0, (array instanceof float[]) ? ((float[]) array)[0]
+                                                                              : ((double[]) array)[0]);
+                    }
+                } else {
+                    // Write back the values, including the ones transformed before a failure.
+                    final int dimension = dimensions[i];
+                    final double[] copy = (double[]) array;
+                    for (int j=0; j<copy.length; j++) {
+                        sequence.setOrdinate(j / dimension, j % dimension, copy[j]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds all non-empty coordinate sequences of the given geometry in the given list.
+     *
+     * @param  geometry   the geometry from which to get the coordinate sequences.
+     * @param  sequences  where to add the coordinate sequences.
+     */
+    private static void collect(final Geometry geometry, final List<CoordinateSequence> sequences) {
+        if (geometry instanceof GeometryCollection) {
+            final int n = geometry.getNumGeometries();
+            for (int i=0; i<n; i++) {
+                collect(geometry.getGeometryN(i), sequences);
+            }
+        } else if (geometry instanceof Polygon) {
+            final Polygon polygon = (Polygon) geometry;
+            collect(polygon.getExteriorRing(), sequences);
+            final int n = polygon.getNumInteriorRing();
+            for (int i=0; i<n; i++) {
+                collect(polygon.getInteriorRingN(i), sequences);
+            }
+        } else {
+            final CoordinateSequence sequence;
+            if (geometry instanceof LineString) {
+                sequence = ((LineString) geometry).getCoordinateSequence();
+            } else if (geometry instanceof Point) {
+                sequence = ((Point) geometry).getCoordinateSequence();
+            } else {
+                throw new IllegalArgumentException("Unsupported geometry type: " + geometry.getGeometryType());
+            }
+            if (sequence.size() != 0) {
+                sequences.add(sequence);
+            }
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Integration with the <a href="https://locationtech.github.io/jts/">JTS Topology Suite</a>.
+ * This package requires JTS on the class-path or module-path, but JTS is an optional dependency
+ * of PROJ-JNI: applications that do not use this package do not need JTS. Example:
+ *
+ * {@snippet lang="java" :
+ * BatchTransform transform = new BatchTransform(operation.getMathTransform());
+ * Geometry projected = JTS.transform(geometry, transform);
+ * }
+ *
+ * All coordinates of a geometry tree are transformed with a single call to the native library.
+ * Coordinates stored in {@link org.locationtech.jts.geom.impl.PackedCoordinateSequence} are
+ * transformed directly in their backing arrays, without creating {@code Coordinate} objects.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+package org.osgeo.proj.jts;
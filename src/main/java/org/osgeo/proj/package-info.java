@@ -82,6 +82,15 @@
  * <p>Note that there is no limit on Java side in the amount of threads that can use <em>different</em>
  * {@link org.opengis.referencing.operation.MathTransform} instances concurrently.</p>
  *
+ * <p>Native work is executed in one of two {@linkplain Priority priority lanes}: interactive (the default)
+ * and bulk (selected with {@link BatchTransform#setPriority(Priority)}). Each lane has its own PROJ contexts
+ * and its own cache of {@code PJ} objects in each transform. The maximal number of threads executing native
+ * work concurrently in each lane can be set by the "{@systemProperty org.osgeo.proj.interactiveThreads}"
+ * and "{@systemProperty org.osgeo.proj.bulkThreads}" system properties. By default the interactive lane
+ * has no limit and the bulk lane is limited to the number of processors minus one. Bulk batches are split
+ * in chunks of "{@systemProperty org.osgeo.proj.bulkChunkSize}" points (65536 by default), and the bulk
+ * lane gives other threads an opportunity to run between two chunks when interactive work is in progress.</p>
+ *
  * <h2>String representation</h2>
  * <p>Referencing objects such as CRS, datum, <i>etc.</i>
  * implement the {@link org.opengis.referencing.IdentifiedObject#toWKT()} method,
@@ -103,6 +112,38 @@
  * If this property is not set, then the value specified by the {@code PROJ_DATA} environment variable is used.
  * If that environment variable is not set neither, then a PROJ hard-coded default path is used.</p>
  *
+ * <p>By default, Java wrappers around PROJ objects are cached with soft references, which are cleared
+ * only when the Java heap is under pressure. Since most of the memory used by PROJ objects is native memory
+ * that the garbage collector does not see, applications creating a large amount of CRS or operations may
+ * set the "{@systemProperty org.osgeo.proj.maxCachedObjects}" system property to a positive integer.
+ * In that mode, at most that number of wrappers are retained in the cache (the least recently used ones
+ * are evicted first) and the other wrappers are released as soon as they are no longer referenced.</p>
+ *
+ * <p>Authority codes for which no object exists are remembered in a cache, so that repeated requests for
+ * the same invalid codes fail fast without database query. The maximal number of codes in that cache can
+ * be set by the "{@systemProperty org.osgeo.proj.maxMissingCodes}" system property (10000 by default).
+ * A value of 0 disables the cache. The cache is cleared by {@link org.osgeo.proj.Proj#invalidateFailures()}
+ * and when the "{@code org.osgeo.proj.data}" search path changes.</p>
+ *
+ * <p>Coordinate operations that PROJ could not instantiate (for example because of a missing datum shift grid)
+ * are also remembered, so that repeated transforms fail fast with an exception caused by the first failure.
+ * By default, the failures are remembered until {@link org.osgeo.proj.Proj#invalidateFailures()} is invoked.
+ * A delay in milliseconds after which a new attempt is made can be set by the
+ * "{@systemProperty org.osgeo.proj.failureRetryDelay}" system property.</p>
+ *
+ * <p>Native resources that are no longer needed, such as idle {@code PJ_CONTEXT} instances with their
+ * database connections and grid files, are destroyed in a background thread. Destructions waiting for
+ * that thread are stored in a queue of bounded capacity, which can be set by the
+ * "{@systemProperty org.osgeo.proj.reclaimQueueSize}" system property (1024 by default).
+ * When the queue is full, the destruction is done in the thread that released the resource.
+ * A value of 0 makes all destructions synchronous.</p>
+ *
+ * <p>Calls to PROJ which take an unusual amount of time can be recorded for diagnostic by setting the
+ * "{@systemProperty org.osgeo.proj.slowCallThreshold}" system property to a duration in milliseconds.
+ * Calls exceeding that threshold are kept in a ring of capacity given by the
+ * "{@systemProperty org.osgeo.proj.slowCallCapacity}" system property (100 by default),
+ * and can be obtained by {@link org.osgeo.proj.Proj#getSlowCalls()}.</p>
+ *
  * <h2>Unsupported features</h2>
  * <p>The following method calls will cause an exception to be thrown:</p>
  * <ul>
@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.List;
+import java.util.ArrayList;
+import java.lang.reflect.Field;
+import java.nio.charset.StandardCharsets;
+import sun.misc.Unsafe;
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+import static org.junit.Assume.assumeTrue;
+
+
+/**
+ * Tests {@link ArrowTransform}. The Arrow C Data Interface structures are built in native memory
+ * by this test, without dependency to the Arrow library. The transform is a translation, which
+ * makes easy to see which points have been transformed. Only in-place transforms are tested,
+ * because the release callback of arrays created by native code can not be invoked from Java.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class ArrowTransformTest {
+    /**
+     * Provides access to native memory.
+     */
+    private static final Unsafe UNSAFE;
+    static {
+        try {
+            final Field field = Unsafe.class.getDeclaredField("theUnsafe");
+            field.setAccessible(true);
+            UNSAFE = (Unsafe) field.get(null);
+        } catch (ReflectiveOperationException e) {
+            throw new AssertionError(e);
+        }
+    }
+
+    /**
+     * Sizes of the {@code ArrowSchema} and {@code ArrowArray} structures on 64 bits platforms.
+     */
+    private static final int SCHEMA_SIZE = 72, ARRAY_SIZE = 80;
+
+    /**
+     * Value of the release callbacks. The callbacks of the source arrays are never invoked by
+     * the transforms; the native code only checks that they are non-null.
+     */
+    private static final long RELEASE = 1;
+
+    /**
+     * Addresses of all blocks of native memory allocated by the test.
+     */
+    private final List<Long> allocated = new ArrayList<>();
+
+    /**
+     * The adapter to test, which translates coordinates by (100, 10, 1000).
+     */
+    private ArrowTransform transform;
+
+    /**
+     * Creates the transform to test.
+     *
+     * @throws FactoryException if the PROJ string can not be parsed.
+     */
+    @Before
+    public void createTransform() throws FactoryException {
+        assumeTrue("Requires 64 bits pointers.", UNSAFE.addressSize() == Long.BYTES);
+        transform = new ArrowTransform(new BatchTransform(
+                Proj.createTransform("+proj=affine +xoff=100 +yoff=10 +zoff=1000", 3)));
+    }
+
+    /**
+     * Releases all native memory allocated by the test.
+     */
+    @After
+    public void free() {
+        allocated.forEach(UNSAFE::freeMemory);
+        allocated.clear();
+    }
+
+    /**
+     * Allocates a block of native memory initialized to zero.
+     */
+    private long allocate(final long size) {
+        final long address = UNSAFE.allocateMemory(size);
+        allocated.add(address);
+        UNSAFE.setMemory(address, size, (byte) 0);
+        return address;
+    }
+
+    /**
+     * Copies the given string in native memory as a null-terminated UTF-8 string.
+     */
+    private long string(final String text) {
+        final byte[] bytes = text.getBytes(StandardCharsets.UTF_8);
+        final long address = allocate(bytes.length + 1);
+        for (int i=0; i<bytes.length; i++) {
+            UNSAFE.putByte(address + i, bytes[i]);
+        }
+        return address;
+    }
+
+    /**
+     * Copies the given values in native memory.
+     */
+    private long doubles(final double... values) {
+        final long address = allocate(values.length * (long) Double.BYTES);
+        for (int i=0; i<values.length; i++) {
+            UNSAFE.putDouble(address + i * (long) Double.BYTES, values[i]);
+        }
+        return address;
+    }
+
+    /**
+     * Copies the given values in native memory.
+     */
+    private long ints(final int... values) {
+        final long address = allocate(values.length * (long) Integer.BYTES);
+        for (int i=0; i<values.length; i++) {
+            UNSAFE.putInt(address + i * (long) Integer.BYTES, values[i]);
+        }
+        return address;
+    }
+
+    /**
+     * Copies the given addresses in native memory, as an array of pointers.
+     */
+    private long pointers(final long... addresses) {
+        final long address = allocate(Math.max(1, addresses.length) * (long) Long.BYTES);
+        for (int i=0; i<addresses.length; i++) {
+            UNSAFE.putLong(address + i * (long) Long.BYTES, addresses[i]);
+        }
+        return address;
+    }
+
+    /**
+     * Reads values from native memory.
+     */
+    private static double[] read(final long address, final int count) {
+        final double[] values = new double[count];
+        for (int i=0; i<count; i++) {
+            values[i] = UNSAFE.getDouble(address + i * (long) Double.BYTES);
+        }
+        return values;
+    }
+
+    /**
+     * Creates an {@code ArrowSchema} structure.
+     *
+     * @param  format    the Arrow format string.
+     * @param  name      the field name, or {@code null} if none.
+     * @param  children  addresses of the children schemas.
+     * @return address of the new structure.
+     */
+    private long schema(final String format, final String name, final long... children) {
+        final long address = allocate(SCHEMA_SIZE);
+        UNSAFE.putLong(address,      string(format));
+        UNSAFE.putLong(address +  8, (name != null) ? string(name) : 0);
+        UNSAFE.putLong(address + 32, children.length);
+        UNSAFE.putLong(address + 40, pointers(children));
+        UNSAFE.putLong(address + 56, RELEASE);
+        return address;
+    }
+
+    /**
+     * Creates an {@code ArrowArray} structure.
+     *
+     * @param  length     number of elements, excluding the elements before the offset.
+     * @param  nullCount  number of null elements.
+     * @param  offset     index of the first element in the buffers.
+     * @param  buffers    addresses of the buffers, with 0 for a missing validity bitmap.
+     * @param  children   addresses of the children arrays.
+     * @return address of the new structure.
+     */
+    private long array(final long length, final long nullCount, final long offset,
+                       final long[] buffers, final long... children)
+    {
+        final long address = allocate(ARRAY_SIZE);
+        UNSAFE.putLong(address,      length);
+        UNSAFE.putLong(address +  8, nullCount);
+        UNSAFE.putLong(address + 16, offset);
+        UNSAFE.putLong(address + 24, buffers.length);
+        UNSAFE.putLong(address + 32, children.length);
+        UNSAFE.putLong(address + 40, pointers(buffers));
+        UNSAFE.putLong(address + 48, pointers(children));
+        UNSAFE.putLong(address + 64, RELEASE);
+        return address;
+    }
+
+    /**
+     * Tests points in the separated layout (a struct of "x" and "y" arrays). The struct is a slice
+     * of two points starting at offset 1, and the "x" child has its own offset of 1. Only the points
+     * in the slice shall be transformed.
+     *
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testSeparatedPoints() throws TransformException {
+        final long x = doubles(-1, 0, 1, 2, 3, 4);
+        final long y = doubles(   5, 6, 7, 8, 9);
+        final long schema = schema("+s", null, schema("g", "x"), schema("g", "y"));
+        final long array  = array(2, 0, 1, new long[] {0},
+                array(5, 0, 1, new long[] {0, x}),
+                array(5, 0, 0, new long[] {0, y}));
+        transform.transformInPlace(schema, array);
+        assertArrayEquals(new double[] {-1, 0, 101, 102, 3, 4}, read(x, 6), 1E-9);
+        assertArrayEquals(new double[] {5, 16, 17, 8, 9}, read(y, 5), 1E-9);
+    }
+
+    /**
+     * Tests points in the interleaved layout (a fixed-size list of "xyz" values). The list is a slice
+     * of three points starting at offset 1, with the second point of the slice null. Only the valid
+     * points in the slice shall be transformed.
+     *
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testInterleavedPoints() throws TransformException {
+        final long coordinates = doubles(
+                0, 0, 0,
+                1, 2, 3,
+                4, 5, 6,
+                7, 8, 9,
+                0, 0, 0);
+        final long validity = allocate(1);
+        UNSAFE.putByte(validity, (byte) 0b11011);           // Point at index 2 is null.
+        final long schema = schema("+w:3", null, schema("g", "xyz"));
+        final long array  = array(3, 1, 1, new long[] {validity},
+                array(15, 0, 0, new long[] {0, coordinates}));
+        transform.transformInPlace(schema, array);
+        assertArrayEquals(new double[] {
+                  0,  0,    0,
+                101, 12, 1003,
+                  4,  5,    6,
+                107, 18, 1009,
+                  0,  0,    0}, read(coordinates, 15), 1E-9);
+    }
+
+    /**
+     * Tests linestrings as a list of interleaved points. The list is a slice of one linestring starting
+     * at offset 1, so the range of points is given by the offsets buffer at that index. The points of the
+     * other linestrings shall not be transformed.
+     *
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testSlicedLineStrings() throws TransformException {
+        final long coordinates = doubles(
+                0, 0,   1, 1,                   // First linestring.
+                2, 2,   3, 3,   4, 4,           // Second linestring.
+                5, 5,   6, 6);                  // Third linestring.
+        final long schema = schema("+l", null, schema("+w:2", "vertices", schema("g", "xy")));
+        final long array  = array(1, 0, 1, new long[] {0, ints(0, 2, 5, 7)},
+                array(7, 0, 0, new long[] {0},
+                array(14, 0, 0, new long[] {0, coordinates})));
+        transform.transformInPlace(schema, array);
+        assertArrayEquals(new double[] {
+                  0,  0,     1,  1,
+                102, 12,   103, 13,   104, 14,
+                  5,  5,     6,  6}, read(coordinates, 14), 1E-9);
+    }
+
+    /**
+     * Tests linestrings as a list of separated points where the points array is itself a slice.
+     * The child offset shall be added to the range given by the offsets buffer of the parent.
+     *
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testSlicedChildren() throws TransformException {
+        final long x = doubles(0, 1, 2, 3, 4, 5);
+        final long y = doubles(0, 1, 2, 3, 4, 5);
+        final long schema = schema("+l", null, schema("+s", "vertices", schema("g", "x"), schema("g", "y")));
+        final long array  = array(2, 0, 0, new long[] {0, ints(0, 1, 3)},
+                array(4, 0, 2, new long[] {0},
+                        array(6, 0, 0, new long[] {0, x}),
+                        array(6, 0, 0, new long[] {0, y})));
+        transform.transformInPlace(schema, array);
+        assertArrayEquals(new double[] {0, 1, 102, 103, 104, 5}, read(x, 6), 1E-9);
+        assertArrayEquals(new double[] {0, 1,  12,  13,  14, 5}, read(y, 6), 1E-9);
+    }
+}
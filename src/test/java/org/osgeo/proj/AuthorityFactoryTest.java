@@ -260,6 +260,37 @@ public final strictfp class AuthorityFactoryTest {
         assertSame(cs, crs.getCoordinateSystem());
     }
 
+    /**
+     * Tests {@link Proj#tryCreate(String, String, Class)} with valid and invalid codes.
+     * The invalid codes are requested twice for testing the cache of missing codes.
+     * The exception thrown for a cached missing code shall be the same than for the first request.
+     * The cache is then cleared by {@link Proj#invalidateFailures()}.
+     *
+     * @throws FactoryException if the operation failed for another reason than an invalid code.
+     */
+    @Test
+    public void testTryCreate() throws FactoryException {
+        assertTrue (Proj.tryCreate(EPSG, "4326",   GeographicCRS.class).isPresent());
+        assertFalse(Proj.tryCreate(EPSG, "3395",   GeographicCRS.class).isPresent());     // Projected CRS.
+        assertTrue (Proj.tryCreate(EPSG, "3395",   ProjectedCRS .class).isPresent());
+        for (int i=0; i<2; i++) {
+            assertFalse(Proj.tryCreate(EPSG, "900913", CoordinateReferenceSystem.class).isPresent());
+        }
+        final AuthorityFactory.API factory = new AuthorityFactory.API(EPSG);
+        for (int i=0; i<2; i++) {
+            try {
+                factory.createCoordinateReferenceSystem("900913");
+                fail("An exception should have been thrown.");
+            } catch (NoSuchAuthorityCodeException e) {
+                assertEquals("getAuthority",     EPSG,     e.getAuthority());
+                assertEquals("getAuthorityCode", "900913", e.getAuthorityCode());
+                assertNotNull(e.getMessage());
+            }
+        }
+        Proj.invalidateFailures();          // Shall forget the missing code but still not find it.
+        assertFalse(Proj.tryCreate(EPSG, "900913", CoordinateReferenceSystem.class).isPresent());
+    }
+
     /**
      * Asserts that the given collection contains an identifier for the given code space with the given value.
      * If the collection contains also identifiers in other code spaces, those additional identifiers are ignored.
@@ -0,0 +1,423 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.util.Arrays;
+import java.util.Random;
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.crs.CoordinateReferenceSystem;
+import org.opengis.referencing.operation.CoordinateOperation;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+import static org.junit.Assume.assumeNotNull;
+
+
+/**
+ * Tests {@link BatchTransform}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class BatchTransformTest {
+    /**
+     * Coordinates to use for testing an operation, in (latitude, longitude) order.
+     */
+    static final double[] TEST_DATA = {
+        45.500,  -73.567,               // Montreal
+        49.250, -123.100,               // Vancouver
+        35.653,  139.839,               // Tokyo
+        48.865,    2.349,               // Paris
+       -12.046,  -77.043                // Lima
+    };
+
+    /**
+     * Returns the transform from EPSG:4326 to EPSG:3395 (World Mercator).
+     *
+     * @return the transform to test.
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     */
+    static MathTransform mercator() throws FactoryException {
+        final CoordinateReferenceSystem source = TestFactorySource.EPSG.createCoordinateReferenceSystem("4326");
+        final CoordinateReferenceSystem target = TestFactorySource.EPSG.createCoordinateReferenceSystem("3395");
+        return TestFactorySource.OPERATIONS.createOperation(source, target).getMathTransform();
+    }
+
+    /**
+     * Tests a transform with output written as integers after quantization.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testTargetQuantization() throws FactoryException, TransformException {
+        final MathTransform mt = mercator();
+        final int numPts = TEST_DATA.length / 2;
+        final double[] expected = new double[TEST_DATA.length];
+        mt.transform(TEST_DATA, 0, expected, 0, numPts);
+
+        final BatchTransform batch = new BatchTransform(mt);
+        batch.setTargetQuantization(new double[] {0.001, 0.001}, new double[] {100, 200});
+        final int[] actual = new int[TEST_DATA.length];
+        batch.transform(TEST_DATA, 0, actual, 0, numPts);
+        for (int i=0; i<actual.length; i++) {
+            assertEquals(Math.round(expected[i] * 0.001 + ((i & 1) == 0 ? 100 : 200)), actual[i]);
+        }
+    }
+
+    /**
+     * Tests a transform with input read from integers before dequantization.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testSourceQuantization() throws FactoryException, TransformException {
+        final MathTransform mt = mercator();
+        final int numPts = TEST_DATA.length / 2;
+        final double[] expected = new double[TEST_DATA.length];
+        mt.transform(TEST_DATA, 0, expected, 0, numPts);
+
+        final int[] microDegrees = new int[TEST_DATA.length];
+        for (int i=0; i<microDegrees.length; i++) {
+            microDegrees[i] = (int) Math.round(TEST_DATA[i] * 1E+6);
+        }
+        final BatchTransform batch = new BatchTransform(mt);
+        batch.setSourceQuantization(new double[] {1E-6, 1E-6}, null);
+        final double[] actual = new double[TEST_DATA.length];
+        batch.transform(microDegrees, 0, actual, 0, numPts);
+        assertArrayEquals(expected, actual, 0.01);
+    }
+
+    /**
+     * Tests a transform of points in random order with spatial ordering enabled.
+     * The number of points is large enough for requiring more than one chunk in native code.
+     * Results shall be identical to the results without spatial ordering.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testSpatialOrdering() throws FactoryException, TransformException {
+        final Random random = new Random(1234);
+        final double[] source = new double[5000 * 2];
+        for (int i=0; i<source.length; i += 2) {
+            source[i  ] = random.nextDouble() * 160 - 80;
+            source[i+1] = random.nextDouble() * 360 - 180;
+        }
+        final BatchTransform batch = new BatchTransform(mercator());
+        final double[] expected = new double[source.length];
+        batch.transform(source, 0, expected, 0, source.length / 2);
+        batch.setSpatialOrdering(true);
+        assertTrue(batch.isSpatialOrdering());
+        final double[] actual = new double[source.length];
+        batch.transform(source, 0, actual, 0, source.length / 2);
+        assertArrayEquals(expected, actual, 0);
+    }
+
+    /**
+     * Tests a transform of points with many duplicated tuples and deduplication enabled.
+     * Results shall be identical to the results without deduplication.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testDeduplication() throws FactoryException, TransformException {
+        final double[] source = new double[3000 * 2];
+        for (int i=0; i<source.length; i += 2) {
+            final int k = (i / 2) % 1000;                       // Each point is repeated 3 times.
+            source[i  ] = (k % 160) - 80;
+            source[i+1] = (k % 360) - 180 + k * 1E-4;
+        }
+        final BatchTransform batch = new BatchTransform(mercator());
+        final double[] expected = new double[source.length];
+        batch.transform(source, 0, expected, 0, source.length / 2);
+        batch.setDeduplication(true);
+        assertTrue(batch.isDeduplication());
+        final double[] actual = new double[source.length];
+        batch.transform(source, 0, actual, 0, source.length / 2);
+        assertArrayEquals(expected, actual, 0);
+    }
+
+    /**
+     * Tests a transform executed in the bulk lane with more points than the size of a chunk.
+     * Results shall be identical to the results in the interactive lane.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testBulkPriority() throws FactoryException, TransformException {
+        final double[] source = new double[100000 * 2];
+        for (int i=0; i<source.length; i += 2) {
+            final int k = i / 2;
+            source[i  ] = (k % 160) - 80;
+            source[i+1] = (k % 360) - 180 + k * 1E-6;
+        }
+        final BatchTransform batch = new BatchTransform(mercator());
+        assertEquals(Priority.INTERACTIVE, batch.getPriority());
+        final double[] expected = new double[source.length];
+        batch.transform(source, 0, expected, 0, source.length / 2);
+        batch.setPriority(Priority.BULK);
+        assertEquals(Priority.BULK, batch.getPriority());
+        final double[] actual = new double[source.length];
+        batch.transform(source, 0, actual, 0, source.length / 2);
+        assertArrayEquals(expected, actual, 0);
+    }
+
+    /**
+     * Tests the reductions computed together with the transform: failure count,
+     * points outside the target extent, envelope and compaction of retained points.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testReductions() throws FactoryException, TransformException {
+        final MathTransform mt = mercator();
+        final int numPts = TEST_DATA.length / 2;
+        final double[] expected = new double[TEST_DATA.length];
+        mt.transform(TEST_DATA, 0, expected, 0, numPts);
+
+        final double[] source = Arrays.copyOf(TEST_DATA, TEST_DATA.length + 2);
+        source[TEST_DATA.length] = 90;                              // North pole: can not be transformed.
+        final BatchTransform batch = new BatchTransform(mt);
+        batch.setTargetExtent(new double[] {-1E+7, Double.NEGATIVE_INFINITY}, new double[] {1E+7, Double.POSITIVE_INFINITY});
+        batch.setCompaction(true);
+        final boolean[] mask = new boolean[numPts + 1];
+        final double[] actual = new double[source.length];
+        final BatchTransform.Summary summary = batch.transform(source, 0, actual, 0, numPts + 1, mask);
+        assertEquals(1, summary.getFailureCount());
+        assertEquals(2, summary.getOutsideCount());                 // Vancouver and Tokyo.
+        assertEquals(3, summary.getRetainedCount());                // Montreal, Paris and Lima.
+        assertArrayEquals(new boolean[] {true, false, false, true, true, false}, mask);
+        int k = 0;
+        for (int i=0; i<numPts; i++) {
+            if (mask[i]) {
+                assertEquals(expected[i*2  ], actual[k++], 0.01);
+                assertEquals(expected[i*2+1], actual[k++], 0.01);
+            }
+        }
+        assertEquals(expected[8], summary.getMinimum()[0], 0.01);    // Lima.
+        assertEquals(expected[6], summary.getMaximum()[0], 0.01);    // Paris.
+        assertEquals(expected[9], summary.getMinimum()[1], 0.01);    // Lima.
+        assertEquals(expected[7], summary.getMaximum()[1], 0.01);    // Paris.
+    }
+
+    /**
+     * Tests the check of the domain of validity before the transform. The operation from EPSG:4326 to
+     * UTM zone 31N is valid only between 0°E and 6°E in the northern hemisphere, so only Paris is inside.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testDomainGuard() throws FactoryException, TransformException {
+        final CoordinateReferenceSystem source = TestFactorySource.EPSG.createCoordinateReferenceSystem("4326");
+        final CoordinateReferenceSystem target = TestFactorySource.EPSG.createCoordinateReferenceSystem("32631");
+        final CoordinateOperation op = TestFactorySource.OPERATIONS.createOperation(source, target);
+        assumeNotNull(op.getDomainOfValidity());
+        final MathTransform mt = op.getMathTransform();
+        final double[] paris = {TEST_DATA[6], TEST_DATA[7]};
+        mt.transform(paris, 0, paris, 0, 1);
+
+        final BatchTransform batch = new BatchTransform(mt);
+        batch.setDomainGuard(true, null);
+        assertTrue(batch.isDomainGuard());
+        final int numPts = TEST_DATA.length / 2;
+        final double[] actual = new double[TEST_DATA.length];
+        batch.transform(TEST_DATA, 0, actual, 0, numPts);
+        for (int i=0; i<actual.length; i++) {
+            if (i == 6 || i == 7) {
+                assertEquals(paris[i - 6], actual[i], 0.01);
+            } else {
+                assertTrue(Double.isNaN(actual[i]));
+            }
+        }
+        /*
+         * Route the points outside the domain to a World Mercator projection.
+         */
+        final MathTransform fallback = mercator();
+        final double[] expected = new double[TEST_DATA.length];
+        fallback.transform(TEST_DATA, 0, expected, 0, numPts);
+        expected[6] = paris[0];
+        expected[7] = paris[1];
+        batch.setDomainGuard(true, fallback);
+        batch.transform(TEST_DATA, 0, actual, 0, numPts);
+        assertArrayEquals(expected, actual, 0.01);
+    }
+
+    /**
+     * Tests the domain guard with a projected source CRS having northing before easting (New Zealand Transverse
+     * Mercator). The guard shall use the axis order of the source CRS for converting points to geographic
+     * coordinates, so that a point in Wellington is inside the domain and a point far west is outside.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testDomainGuardNorthingFirst() throws FactoryException, TransformException {
+        final CoordinateReferenceSystem source = TestFactorySource.EPSG.createCoordinateReferenceSystem("2193");
+        final CoordinateReferenceSystem target = TestFactorySource.EPSG.createCoordinateReferenceSystem("4326");
+        final CoordinateOperation op = TestFactorySource.OPERATIONS.createOperation(source, target);
+        assumeNotNull(op.getDomainOfValidity());
+        final MathTransform mt = op.getMathTransform();
+        final double[] points = {
+            5427916, 1748735,           // Wellington (northing, easting).
+            5427916,       0            // About 20° west of New Zealand.
+        };
+        final double[] expected = points.clone();
+        mt.transform(expected, 0, expected, 0, 1);
+
+        final BatchTransform batch = new BatchTransform(mt);
+        batch.setDomainGuard(true, null);
+        final double[] actual = new double[points.length];
+        batch.transform(points, 0, actual, 0, 2);
+        assertEquals(expected[0], actual[0], 1E-9);
+        assertEquals(expected[1], actual[1], 1E-9);
+        assertTrue(Double.isNaN(actual[2]));
+        assertTrue(Double.isNaN(actual[3]));
+    }
+
+    /**
+     * Tests the round-trip audit on the Mercator projection. Errors shall be very small, except for
+     * a latitude of 90° which can not be projected. The source array shall not be modified.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while auditing the points.
+     */
+    @Test
+    public void testAudit() throws FactoryException, TransformException {
+        final double[] points = Arrays.copyOf(TEST_DATA, TEST_DATA.length + 2);
+        points[TEST_DATA.length] = 90;                                        // Pole: forward failure.
+        final double[] copy = points.clone();
+        final BatchTransform batch = new BatchTransform(mercator());
+        final BatchTransform.Audit audit = batch.audit(points, 0, points.length / 2, 2);
+        assertArrayEquals(copy, points, 0);
+        assertEquals(TEST_DATA.length / 2, audit.getCount());
+        assertEquals(1, audit.getForwardFailureCount());
+        assertEquals(0, audit.getInverseFailureCount());
+        assertTrue(audit.getMaximum() < 1E-9);
+        assertTrue(audit.getMean() <= audit.getMaximum());
+        assertTrue(audit.getPercentile(50) <= audit.getPercentile(99));
+        final int[]    worst  = audit.getWorstIndices();
+        final double[] errors = audit.getWorstErrors();
+        assertEquals(2, worst.length);
+        assertEquals(audit.getMaximum(), errors[0], 0);
+        assertTrue(errors[0] >= errors[1]);
+        assertTrue(worst[0] < TEST_DATA.length / 2);
+    }
+
+    /**
+     * Tests the distortion factors of the Mercator projection. The projection is conformal,
+     * so the scale factors are the same in all directions and the areal scale is their square.
+     * The factors can not be computed at the pole.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while computing the factors.
+     */
+    @Test
+    public void testFactors() throws FactoryException, TransformException {
+        final double[] points = {0, 0, 10, 60, 0, 90};      // (λ,φ) tuples.
+        final double[] factors = new double[3 * BatchTransform.NUM_FACTORS];
+        final BatchTransform batch = new BatchTransform(mercator());
+        assertEquals(1, batch.factors(points, 0, factors, 0, 3));
+        assertEquals(1, factors[BatchTransform.MERIDIONAL_SCALE], 1E-9);
+        assertEquals(1, factors[BatchTransform.PARALLEL_SCALE],   1E-9);
+        final int i = BatchTransform.NUM_FACTORS;
+        final double k = factors[i + BatchTransform.PARALLEL_SCALE];
+        assertEquals(2, k, 0.01);                           // 1/cos(60°), ignoring the ellipsoid.
+        assertEquals(k,     factors[i + BatchTransform.MERIDIONAL_SCALE],     1E-6);
+        assertEquals(k * k, factors[i + BatchTransform.AREAL_SCALE],          1E-5);
+        assertEquals(0,     factors[i + BatchTransform.ANGULAR_DISTORTION],   1E-6);
+        assertEquals(0,     factors[i + BatchTransform.MERIDIAN_CONVERGENCE], 1E-6);
+        assertTrue(Double.isNaN(factors[2*i + BatchTransform.MERIDIONAL_SCALE]));
+        try {
+            new BatchTransform(Proj.createTransform("+proj=merc +ellps=WGS84", 2)).factors(points, 0, factors, 0, 1);
+            fail("Expected an exception since a pipeline has no target CRS.");
+        } catch (UnsupportedOperationException e) {
+            assertNotNull(e.getMessage());
+        }
+    }
+
+    /**
+     * Creates a batch transform from the geographic CRS to the projected CRS of the given EPSG code.
+     *
+     * @param  geographic  EPSG code of the base geographic CRS.
+     * @param  projected   EPSG code of the projected CRS.
+     * @return batch transform to the projected CRS.
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     */
+    private static BatchTransform projection(final String geographic, final String projected) throws FactoryException {
+        final CoordinateReferenceSystem source = TestFactorySource.EPSG.createCoordinateReferenceSystem(geographic);
+        final CoordinateReferenceSystem target = TestFactorySource.EPSG.createCoordinateReferenceSystem(projected);
+        return new BatchTransform(TestFactorySource.OPERATIONS.createOperation(source, target).getMathTransform());
+    }
+
+    /**
+     * Tests the distortion factors of a projected CRS with (northing, easting) axis order.
+     * The New Zealand Transverse Mercator has a scale factor of 0.9996 on the central meridian (173°E).
+     * The meridian convergence is zero on the central meridian and about Δλ⋅sin(φ) elsewhere.
+     * Those values would be wrong if the axis order was not normalized.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while computing the factors.
+     */
+    @Test
+    public void testFactorsNorthingFirst() throws FactoryException, TransformException {
+        final double[] points = {173, -41, 175, -41};       // (λ,φ) tuples.
+        final double[] factors = new double[2 * BatchTransform.NUM_FACTORS];
+        assertEquals(0, projection("4167", "2193").factors(points, 0, factors, 0, 2));
+        assertEquals(0.9996, factors[BatchTransform.MERIDIONAL_SCALE],     1E-5);
+        assertEquals(0.9996, factors[BatchTransform.PARALLEL_SCALE],       1E-5);
+        assertEquals(0,      factors[BatchTransform.MERIDIAN_CONVERGENCE], 1E-4);
+        final int i = BatchTransform.NUM_FACTORS;
+        final double expected = 2 * Math.sin(Math.toRadians(41));
+        assertEquals(expected, Math.abs(factors[i + BatchTransform.MERIDIAN_CONVERGENCE]), 0.01);
+        assertEquals(0, factors[i + BatchTransform.ANGULAR_DISTORTION], 1E-4);
+    }
+
+    /**
+     * Tests the distortion factors of a projected CRS in US survey feet. The Lambert Conic Conformal
+     * projection of California zone 3 has a scale factor of 1 on its standard parallels (37°04′N and 38°26′N).
+     * The scale factors would be about 3.28 if the linear unit was not normalized to metres.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while computing the factors.
+     */
+    @Test
+    public void testFactorsInFeet() throws FactoryException, TransformException {
+        final double[] points = {-120.5, 37 + 4/60d, -120.5, 37.75};     // (λ,φ) tuples.
+        final double[] factors = new double[2 * BatchTransform.NUM_FACTORS];
+        assertEquals(0, projection("4269", "2227").factors(points, 0, factors, 0, 2));
+        assertEquals(1, factors[BatchTransform.MERIDIONAL_SCALE], 1E-5);
+        assertEquals(1, factors[BatchTransform.PARALLEL_SCALE],   1E-5);
+        final int i = BatchTransform.NUM_FACTORS;
+        final double k = factors[i + BatchTransform.PARALLEL_SCALE];
+        assertTrue("Scale shall be lower than 1 between the standard parallels.", k < 1 && k > 0.999);
+    }
+}
@@ -43,7 +43,7 @@ import static org.junit.Assert.*;
  * Transformations of coordinate values are tested by another class, {@link OperationTest}.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 1.0
+ * @version 2.1
  * @since   1.0
  */
 public final strictfp class OperationFactoryTest {
@@ -116,6 +116,38 @@ public final strictfp class OperationFactoryTest {
         assertNotNull(accuracy(operation.getCoordinateOperationAccuracy()));
     }
 
+    /**
+     * Tests the selection of the fastest operation meeting a desired accuracy.
+     * We do not test which operation is selected since it depends on the datum shift grids
+     * which are installed and on the machine speed. We verify that the selected operation meets
+     * the accuracy requirement and that the result is stable when requested again (the second
+     * request uses the cached measurements).
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     */
+    @Test
+    public void testPreferFastest() throws FactoryException {
+        final CoordinateReferenceSystem  source  = crsFactory.createCoordinateReferenceSystem("4267");
+        final CoordinateReferenceSystem  target  = crsFactory.createCoordinateReferenceSystem("4326");
+        final CoordinateOperationContext context = new CoordinateOperationContext();
+        final double desiredAccuracy = 20;
+        context.setAreaOfInterest(-120, -75, 25, 42);
+        context.setDesiredAccuracy(desiredAccuracy);
+        final CoordinateOperationContext copy = context.clone();
+        context.setPreferFastest(true);
+        assertTrue(context.getPreferFastest());
+        assertNotEquals(copy, context);
+
+        final OperationFactory    factory = new OperationFactory(context);
+        final CoordinateOperation operation = factory.createOperation(source, target);
+        final CoordinateOperation again     = factory.createOperation(source, target);
+        assertSame("sourceCRS", source, operation.getSourceCRS());
+        assertSame("targetCRS", target, operation.getTargetCRS());
+        final double accuracy = Double.parseDouble(accuracy(operation.getCoordinateOperationAccuracy()));
+        assertTrue("Accuracy shall meet the desired one.", accuracy <= desiredAccuracy);
+        assertEquals(operation.toWKT(), again.toWKT());
+    }
+
     /**
      * Returns the first geographic bounding box found in the given extent.
      *
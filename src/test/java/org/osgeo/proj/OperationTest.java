@@ -107,6 +107,25 @@ public final strictfp class OperationTest extends TransformTestCase {
         verifyConsistency(testData());
     }
 
+    /**
+     * Tests the transform of {@code float} coordinates written directly in a {@code double[]} destination
+     * array at a non-zero offset. The values before the offset shall not be modified.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testFloatsToDoublesWithOffset() throws FactoryException, TransformException {
+        initialize("4326", "3395");
+        final double[] target = {-1, -2, -3, Double.NaN, Double.NaN};
+        transform.transform(new float[] {40, 60}, 0, target, 3, 1);
+        assertEquals(-1, target[0], 0);
+        assertEquals(-2, target[1], 0);
+        assertEquals(-3, target[2], 0);
+        assertEquals(6679169.45, target[3], 0.01);
+        assertEquals(4838471.40, target[4], 0.01);
+    }
+
     /**
      * Tests an operation that reduce the number of dimensions. The tested operation does (λ,φ,h) → (φ,λ).
      * The coordinate swapping performed by that operation is a simple way to verify that the transform is
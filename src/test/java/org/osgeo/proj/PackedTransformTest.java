@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests {@link PackedTransform}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class PackedTransformTest {
+    /**
+     * Tests the transform of a {@code double[]} array with a measure and a {@code float[]} array
+     * in a single call. The measures shall be left unchanged.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testDoubleAndFloat() throws FactoryException, TransformException {
+        final MathTransform mt = BatchTransformTest.mercator();
+        final double[] data = BatchTransformTest.TEST_DATA;
+        final int numPts = data.length / 2;
+        final double[] expected = new double[data.length];
+        mt.transform(data, 0, expected, 0, numPts);
+
+        final double[] measured = new double[numPts * 3];
+        final float[]  single   = new float [numPts * 2];
+        for (int i=0; i<numPts; i++) {
+            measured[i*3    ] = data[i*2];
+            measured[i*3 + 1] = data[i*2 + 1];
+            measured[i*3 + 2] = i;
+            single  [i*2    ] = (float) data[i*2];
+            single  [i*2 + 1] = (float) data[i*2 + 1];
+        }
+        final PackedTransform packed = new PackedTransform(new BatchTransform(mt));
+        packed.transformInPlace(new Object[] {measured, single}, new int[] {3, 2}, new int[] {1, 0});
+        for (int i=0; i<numPts; i++) {
+            assertEquals(expected[i*2    ], measured[i*3    ], 0.01);
+            assertEquals(expected[i*2 + 1], measured[i*3 + 1], 0.01);
+            assertEquals(i,                 measured[i*3 + 2], 0);
+            assertEquals(expected[i*2    ], single[i*2    ], 2);      // Float precision on values up to 1E7.
+            assertEquals(expected[i*2 + 1], single[i*2 + 1], 2);
+        }
+    }
+
+    /**
+     * Tests the in-place transform of a {@code double[]} array with <var>z</var> values.
+     * A NaN <var>z</var> value shall be handled as 0 and left NaN.
+     *
+     * @throws FactoryException if an error occurred while creating the transform.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testNaNHeight() throws FactoryException, TransformException {
+        final MathTransform mt = Proj.createTransform("+proj=affine +xoff=100 +yoff=10 +zoff=1000", 3);
+        final double[] data = {1, 2, 3, 4, 5, Double.NaN};
+        new PackedTransform(new BatchTransform(mt)).transformInPlace(new Object[] {data}, new int[] {3}, new int[] {0});
+        assertArrayEquals(new double[] {101, 12, 1003, 104, 15, Double.NaN}, data, 1E-9);
+    }
+
+    /**
+     * Verifies that illegal arrays are rejected.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test(expected = IllegalArgumentException.class)
+    public void testIllegalArray() throws FactoryException, TransformException {
+        new PackedTransform(new BatchTransform(BatchTransformTest.mercator()))
+                .transformInPlace(new Object[] {new int[4]}, new int[] {2}, new int[] {0});
+    }
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests {@link Pipeline}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class PipelineTest {
+    /**
+     * The PROJ string equivalent to the operation from EPSG:4326 to EPSG:3395 (World Mercator).
+     */
+    private static final String MERCATOR = "+proj=pipeline"
+            + " +step +proj=axisswap +order=2,1"
+            + " +step +proj=unitconvert +xy_in=deg +xy_out=rad"
+            + " +step +proj=merc +ellps=WGS84";
+
+    /**
+     * Tests {@link Pipeline#inverse()} on operations that already contain inverted steps.
+     * The inverse transform executes the same {@code PJ} in the inverse direction,
+     * so the inverse of an inverse step is the forward step.
+     *
+     * @throws FactoryException if an error occurred while creating a transform.
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testInverse() throws FactoryException, TransformException {
+        final MathTransform forward  = Proj.createTransform(MERCATOR, 2);
+        final MathTransform backward = Proj.createTransform("+proj=pipeline"
+                + " +step +proj=merc +ellps=WGS84 +inv"
+                + " +step +proj=unitconvert +xy_in=rad +xy_out=deg"
+                + " +step +proj=axisswap +order=2,1", 2);
+        final double[] source   = {45.5, -73.567, 35.653, 139.839};
+        final double[] expected = new double[source.length];
+        final double[] actual   = new double[source.length];
+        forward.transform(source, 0, expected, 0, 2);
+        backward.inverse().transform(source, 0, actual, 0, 2);
+        assertArrayEquals(expected, actual, 1E-6);
+        /*
+         * Same test with a single operation having the "+inv" flag.
+         */
+        final MathTransform single = Proj.createTransform("+proj=merc +ellps=WGS84 +inv", 2).inverse();
+        final double[] radians = {Math.toRadians(-73.567), Math.toRadians(45.5)};
+        single.transform(radians, 0, actual, 0, 1);
+        assertArrayEquals(new double[] {expected[0], expected[1]}, new double[] {actual[0], actual[1]}, 1E-6);
+        /*
+         * The inverse shall honor "+omit_inv": the second step is applied only in the forward direction.
+         */
+        final MathTransform omit = Proj.createTransform("+proj=pipeline"
+                + " +step +proj=affine +xoff=100"
+                + " +step +proj=affine +yoff=10 +omit_inv", 2);
+        final double[] point = {0, 0};
+        omit.transform(point, 0, point, 0, 1);
+        assertArrayEquals(new double[] {100, 10}, point, 1E-12);
+        omit.inverse().transform(point, 0, point, 0, 1);
+        assertArrayEquals(new double[] {0, 10}, point, 1E-12);
+        /*
+         * The inverse shall be usable in a batch, with the same PJ objects executed backward.
+         */
+        new BatchTransform(forward.inverse()).transform(expected, 0, actual, 0, 2);
+        assertArrayEquals(source, actual, 1E-9);
+    }
+
+    /**
+     * Tests {@link Proj#createTransform(String, int)} and compares the results
+     * with the transform created from the EPSG definitions.
+     *
+     * @throws FactoryException if an error occurred while creating a transform.
+     * @throws TransformException if an error occurred while transforming coordinates.
+     */
+    @Test
+    public void testCreateTransform() throws FactoryException, TransformException {
+        final MathTransform pipeline = Proj.createTransform(MERCATOR, 2);
+        assertEquals(2, pipeline.getSourceDimensions());
+        assertEquals(2, pipeline.getTargetDimensions());
+        final double[] source   = {45.5, -73.567, 35.653, 139.839};
+        final double[] expected = new double[source.length];
+        final double[] actual   = new double[source.length];
+        BatchTransformTest.mercator().transform(source, 0, expected, 0, 2);
+        pipeline.transform(source, 0, actual, 0, 2);
+        assertArrayEquals(expected, actual, 1E-6);
+        /*
+         * Inverse operation.
+         */
+        final MathTransform inverse = pipeline.inverse();
+        assertSame(pipeline, inverse.inverse());
+        inverse.transform(actual, 0, actual, 0, 2);
+        assertArrayEquals(source, actual, 1E-9);
+        /*
+         * Batch transform.
+         */
+        final BatchTransform batch = new BatchTransform(pipeline);
+        batch.transform(source, 0, actual, 0, 2);
+        assertArrayEquals(expected, actual, 1E-6);
+    }
+
+    /**
+     * Verifies that an invalid PROJ string or a CRS definition is rejected.
+     */
+    @Test
+    public void testInvalid() {
+        try {
+            Proj.createTransform("+proj=pipeline +step +proj=unknown_projection", 2);
+            fail("Expected an exception.");
+        } catch (FactoryException e) {
+            assertNotNull(e.getMessage());
+        }
+        try {
+            Proj.createTransform("+proj=longlat +datum=WGS84 +type=crs", 2);
+            fail("Expected an exception.");
+        } catch (FactoryException e) {
+            assertNotNull(e.getMessage());
+        }
+    }
+
+    /**
+     * Verifies that a failure to create a {@code PJ} is remembered by {@link TransformPool}
+     * until {@link Proj#invalidateFailures()} is invoked. The remembered failure shall be
+     * reported by a new exception having the original exception as its cause.
+     *
+     * @throws TransformException if an unexpected error occurred.
+     */
+    @Test
+    public void testFailureCache() throws TransformException {
+        final TransformPool pool = new TransformPool("+proj=pipeline +step +proj=unknown_projection", TransformPool.PIPELINE);
+        final FactoryException first  = acquireFailure(pool);
+        final FactoryException cached = acquireFailure(pool);
+        assertNotSame("Expected a new exception.", first, cached);
+        assertSame("Expected the cached failure as the cause.", first, cached.getCause());
+        assertEquals(first.getMessage(), cached.getMessage());
+        Proj.invalidateFailures();
+        final FactoryException retry = acquireFailure(pool);
+        assertNotSame("Expected a new attempt.", first, retry);
+        assertNotSame("Expected a new attempt.", first, retry.getCause());
+        assertEquals(first.getMessage(), retry.getMessage());
+    }
+
+    /**
+     * Invokes {@link TransformPool#acquire(Context)} and returns the exception, which is expected.
+     */
+    private static FactoryException acquireFailure(final TransformPool pool) throws TransformException {
+        try (Context c = Context.acquire()) {
+            pool.release(pool.acquire(c));
+            fail("Expected an exception.");
+            return null;
+        } catch (FactoryException e) {
+            return e;
+        }
+    }
+}
@@ -22,10 +22,16 @@
  */
 package org.osgeo.proj;
 
+import java.util.List;
+import java.util.Map;
 import java.util.Optional;
+import java.util.concurrent.TimeUnit;
 import org.junit.Test;
 import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.TransformException;
 import org.opengis.referencing.IdentifiedObject;
+import org.opengis.referencing.crs.GeographicCRS;
+import org.opengis.referencing.datum.Ellipsoid;
 
 import static org.junit.Assert.*;
 
@@ -34,7 +40,7 @@ import static org.junit.Assert.*;
  * Tests the {@link Proj} class.
  *
  * @author  Martin Desruisseaux (Geomatys)
- * @version 1.0
+ * @version 2.1
  * @since   1.0
  */
 public final strictfp class ProjTest {
@@ -63,4 +69,137 @@ public final strictfp class ProjTest {
         // Verify that the hash code value is stable.
         assertEquals(obj.hashCode(), obj.hashCode());
     }
+
+    /**
+     * Tests {@link Proj#scope()}. Objects created inside the scope shall be released on scope exit.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testScope() throws FactoryException {
+        final IdentifiableObject obj;
+        try (ProjScope scope = Proj.scope()) {
+            obj = (IdentifiableObject) Proj.createFromUserInput("EPSG:32631");
+            assertNotEquals(0, obj.impl.rawPointer());
+        }
+        assertEquals(0, obj.impl.rawPointer());
+        obj.close();                                // Shall have no effect.
+    }
+
+    /**
+     * Tests that the same PROJ object is wrapped by the same Java object,
+     * and that a new wrapper is created after the previous one has been closed.
+     * This test uses a CRS which is not shared with other tests, since the
+     * coordinate system of EPSG codes may be shared by many objects.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testSharedWrappers() throws FactoryException {
+        final CRS crs = (CRS) Proj.createFromUserInput("+proj=merc +lon_0=17 +ellps=GRS80 +type=crs");
+        final CS cs = (CS) crs.getCoordinateSystem();
+        assertSame(cs, crs.getCoordinateSystem());
+        cs.close();
+        final CS other = (CS) crs.getCoordinateSystem();
+        assertNotSame(cs, other);
+        assertNotEquals(0, other.impl.rawPointer());
+        assertSame(other, crs.getCoordinateSystem());
+    }
+
+    /**
+     * Tests the methods fetching one property for many objects in a single native call.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testColumns() throws FactoryException {
+        final GeographicCRS wgs84 = (GeographicCRS) Proj.createFromUserInput("EPSG:4326");
+        final IdentifiedObject[] objects = {
+            wgs84,
+            null,
+            Proj.createFromUserInput("EPSG:32631")
+        };
+        assertArrayEquals(new String[] {"WGS 84", null, "WGS 84 / UTM zone 31N"}, Proj.getNames(objects));
+        assertArrayEquals(new String[] {"EPSG:4326", null, "EPSG:32631"}, Proj.getIdentifiers(objects));
+        assertArrayEquals(new boolean[] {false, false, false}, Proj.areDeprecated(objects));
+
+        final double[] domains = Proj.getDomainsOfValidity(objects);
+        assertEquals(12, domains.length);
+        assertEquals(-180, domains[0], 0);
+        assertEquals(+180, domains[1], 0);
+        assertTrue(Double.isNaN(domains[4]));
+        assertEquals(0, domains[8], 0);
+        assertEquals(6, domains[9], 0);
+
+        final Ellipsoid ellipsoid = wgs84.getDatum().getEllipsoid();
+        assertArrayEquals(new double[] {6378137, Double.NaN}, Proj.getSemiMajorAxes(ellipsoid, null), 0);
+    }
+
+    /**
+     * Tests {@link Proj#getSlowCalls()} with a threshold so low that all calls are recorded.
+     *
+     * @throws FactoryException if an error occurred while creating the operation.
+     * @throws TransformException if an error occurred while transforming a point.
+     */
+    @Test
+    public void testSlowCalls() throws FactoryException, TransformException {
+        final double[] points = {45, 10};
+        SlowCall.setThreshold(1);
+        try {
+            BatchTransformTest.mercator().transform(points, 0, points, 0, 1);
+        } finally {
+            SlowCall.setThreshold(0);
+        }
+        final List<SlowCall> calls = Proj.getSlowCalls();
+        assertFalse(calls.isEmpty());
+        final SlowCall call = calls.get(calls.size() - 1);
+        assertEquals("Transform.transform", call.getCall());
+        assertEquals(1, call.getInputSize());
+        assertTrue(call.getSubject().contains("→"));
+        assertTrue(call.getPhases().containsKey("transform"));
+        assertNull(call.getFailure());
+        assertNotEquals(SlowCall.class.getName(), call.getStackTrace()[0].getClassName());
+    }
+
+    /**
+     * Tests {@link Proj#getSlowCalls()} with a call which fails. The failure shall be recorded.
+     */
+    @Test
+    public void testFailedSlowCall() {
+        SlowCall.setThreshold(1);
+        try {
+            Proj.createFromUserInput("Not a CRS definition");
+            fail("Expected an exception.");
+        } catch (FactoryException e) {
+            assertNotNull(e.getMessage());
+        } finally {
+            SlowCall.setThreshold(0);
+        }
+        final List<SlowCall> calls = Proj.getSlowCalls();
+        assertFalse(calls.isEmpty());
+        final SlowCall call = calls.get(calls.size() - 1);
+        assertEquals("Context.createFromUserInput", call.getCall());
+        assertNotNull(call.getFailure());
+        assertTrue(call.getDuration(TimeUnit.NANOSECONDS) >= 0);
+        for (final Long duration : call.getPhases().values()) {
+            assertTrue(duration >= 0);
+        }
+    }
+
+    /**
+     * Tests {@link Proj#getResourceCounts()} after the creation of a CRS.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testResourceCounts() throws FactoryException {
+        final IdentifiedObject crs = Proj.createFromUserInput("EPSG:4326");
+        final Map<String,Long> counts = Proj.getResourceCounts();
+        assertTrue(counts.get("sharedPointers") > 0);
+        assertTrue(counts.get("wrappers") > 0);
+        assertTrue(counts.get("contexts") > 0);
+        assertTrue(counts.containsKey("transforms"));
+        assertTrue(counts.containsKey("mallocInUse"));
+        assertNotNull(crs);
+    }
 }
@@ -0,0 +1,138 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.lang.ref.WeakReference;
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests the bounded mode of {@link SharedObjects}. Those tests use private instances
+ * instead of {@link SharedObjects#CACHE}, so they do not depend on the value of the
+ * {@code org.osgeo.proj.maxCachedObjects} system property.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class SharedObjectsTest {
+    /**
+     * Creates a new PROJ object which is not shared with other tests,
+     * then moves its wrapper from the global cache to the given cache.
+     *
+     * @param  cache      the cache where to register the wrapper.
+     * @param  longitude  an arbitrary number for making the object unique.
+     * @return the new wrapper, registered in the given cache.
+     * @throws FactoryException if the object creation failed.
+     */
+    private static IdentifiableObject create(final SharedObjects cache, final int longitude) throws FactoryException {
+        final IdentifiableObject object = (IdentifiableObject) Proj.createFromUserInput(
+                "+proj=merc +lon_0=" + longitude + " +ellps=GRS80 +type=crs");
+        SharedObjects.CACHE.discard(object);
+        cache.register(object);
+        return object;
+    }
+
+    /**
+     * Tests the eviction of wrappers when the cache is full,
+     * and the second chance given to the wrappers which have been recently used.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testEviction() throws FactoryException {
+        final SharedObjects cache = new SharedObjects(2);
+        final IdentifiableObject a = create(cache, 1);
+        final IdentifiableObject b = create(cache, 2);
+        assertTrue(cache.isPinned(a));
+        assertTrue(cache.isPinned(b));
+        a.recentlyUsed = true;
+        final IdentifiableObject c = create(cache, 3);
+        assertTrue ("Recently used wrapper shall have a second chance.", cache.isPinned(a));
+        assertFalse("Least recently used wrapper shall be evicted.",     cache.isPinned(b));
+        assertTrue (cache.isPinned(c));
+        assertFalse("Second chance shall clear the flag.", a.recentlyUsed);
+        final IdentifiableObject d = create(cache, 4);
+        assertFalse(cache.isPinned(a));
+        assertTrue (cache.isPinned(c));
+        assertTrue (cache.isPinned(d));
+        assertEquals(4, cache.size());
+    }
+
+    /**
+     * Verifies that evicted wrappers are retained only by weak references,
+     * and that the wrappers in the ring are still strongly reachable.
+     *
+     * @throws FactoryException if the object creation failed.
+     * @throws InterruptedException if the test has been interrupted while waiting for the garbage collector.
+     */
+    @Test
+    public void testWeakAfterEviction() throws FactoryException, InterruptedException {
+        final SharedObjects cache = new SharedObjects(1);
+        final WeakReference<IdentifiableObject> evicted = new WeakReference<>(create(cache, 11));
+        final WeakReference<IdentifiableObject> pinned  = new WeakReference<>(create(cache, 12));
+        for (int i=0; i<100 && evicted.get() != null; i++) {
+            System.gc();
+            Thread.sleep(50);
+        }
+        assertNull("Evicted wrapper shall be garbage collected.", evicted.get());
+        assertNotNull("Pinned wrapper shall be retained.", pinned.get());
+    }
+
+    /**
+     * Verifies that discarding a wrapper removes it from the ring.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testDiscard() throws FactoryException {
+        final SharedObjects cache = new SharedObjects(4);
+        final IdentifiableObject a = create(cache, 21);
+        assertTrue(cache.isPinned(a));
+        cache.discard(a);
+        assertFalse(cache.isPinned(a));
+        assertEquals(0, cache.size());
+        a.impl.release();
+    }
+
+    /**
+     * Verifies that discarding a wrapper which has been evicted does not remove
+     * the wrapper which took its slot.
+     *
+     * @throws FactoryException if the object creation failed.
+     */
+    @Test
+    public void testDiscardAfterEviction() throws FactoryException {
+        final SharedObjects cache = new SharedObjects(1);
+        final IdentifiableObject a = create(cache, 31);
+        final IdentifiableObject b = create(cache, 32);
+        assertFalse(cache.isPinned(a));
+        assertTrue (cache.isPinned(b));
+        cache.discard(a);
+        assertTrue(cache.isPinned(b));
+        a.impl.release();
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests {@link TextTransform}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class TextTransformTest {
+    /**
+     * Tests the transform of coordinates in a CSV file, then in direct buffers.
+     * The longitude and latitude columns are in reverse order compared to the operation axis order.
+     *
+     * @throws IOException if an error occurred while reading or writing the temporary files.
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testFileAndBuffers() throws IOException, FactoryException, TransformException {
+        final MathTransform mt = BatchTransformTest.mercator();
+        final double[] data = BatchTransformTest.TEST_DATA;
+        final int numPts = data.length / 2;
+        final double[] expected = new double[data.length];
+        mt.transform(data, 0, expected, 0, numPts);
+
+        final StringBuilder csv = new StringBuilder("name;longitude;latitude\n");
+        for (int i=0; i<numPts; i++) {
+            csv.append("P").append(i).append(';').append(data[i*2 + 1]).append(" ; ").append(data[i*2]).append('\n');
+        }
+        final TextTransform text = new TextTransform(new BatchTransform(mt), ';', 2, 1);
+        text.setHeaderLines(1);
+        text.setFractionDigits(3);
+
+        final Path source = Files.createTempFile("proj-source", ".csv");
+        final Path target = Files.createTempFile("proj-target", ".csv");
+        try {
+            Files.write(source, csv.toString().getBytes(StandardCharsets.US_ASCII));
+            assertEquals(numPts, text.transform(source, target));
+            final String[] lines = new String(Files.readAllBytes(target), StandardCharsets.US_ASCII).split("\n");
+            assertEquals(numPts + 1, lines.length);
+            assertEquals("name;longitude;latitude", lines[0]);
+            for (int i=0; i<numPts; i++) {
+                final String[] columns = lines[i+1].split(";");
+                assertEquals("P" + i, columns[0]);
+                assertEquals(expected[i*2 + 1], Double.parseDouble(columns[1].trim()), 0.001);
+                assertEquals(expected[i*2    ], Double.parseDouble(columns[2].trim()), 0.001);
+                assertTrue(columns[1].endsWith(" "));               // Spaces around values shall be preserved.
+            }
+        } finally {
+            Files.delete(source);
+            Files.delete(target);
+        }
+        /*
+         * Same test with direct buffers, without the header line
+         * and with a last line not terminated by a line separator.
+         */
+        final byte[] bytes = csv.substring(csv.indexOf("\n") + 1, csv.length() - 1).getBytes(StandardCharsets.US_ASCII);
+        final ByteBuffer in  = ByteBuffer.allocateDirect(bytes.length).put(bytes);
+        final ByteBuffer out = ByteBuffer.allocateDirect(bytes.length * 2);
+        in.flip();
+        assertEquals(numPts - 1, text.transform(in, out, false));
+        assertTrue(in.hasRemaining());
+        assertEquals(1, text.transform(in, out, true));
+        assertFalse(in.hasRemaining());
+        out.flip();
+        final byte[] result = new byte[out.remaining()];
+        out.get(result);
+        final String[] lines = new String(result, StandardCharsets.US_ASCII).split("\n");
+        assertEquals(numPts, lines.length);
+        assertEquals(expected[0], Double.parseDouble(lines[0].split(";")[2]), 0.001);
+    }
+
+    /**
+     * Tests that hexadecimal numbers are rejected, while the C library would parse {@code "0x10"} as 16.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testHexadecimalRejected() throws FactoryException, TransformException {
+        final TextTransform text = new TextTransform(new BatchTransform(BatchTransformTest.mercator()), ',', 1, 0);
+        final byte[] bytes = "0x10,45\n".getBytes(StandardCharsets.US_ASCII);
+        final ByteBuffer in  = ByteBuffer.allocateDirect(bytes.length).put(bytes);
+        final ByteBuffer out = ByteBuffer.allocateDirect(64);
+        in.flip();
+        try {
+            text.transform(in, out, true);
+            fail("Expected IllegalArgumentException.");
+        } catch (IllegalArgumentException e) {
+            assertTrue(e.getMessage().contains("column 0"));
+        }
+    }
+
+    /**
+     * Tests a point which can not be transformed in a line which does not fit in the target buffer.
+     * The failure shall be reported only by the call which writes that line.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testFailureInLineNotWritten() throws FactoryException, TransformException {
+        final TextTransform text = new TextTransform(new BatchTransform(BatchTransformTest.mercator()), ',', 1, 0);
+        final byte[] bytes = "0,0\n0,90,a pole which can not be projected by Mercator\n".getBytes(StandardCharsets.US_ASCII);
+        final ByteBuffer in  = ByteBuffer.allocateDirect(bytes.length).put(bytes);
+        final ByteBuffer out = ByteBuffer.allocateDirect(32);
+        in.flip();
+        assertEquals(1, text.transform(in, out, true));
+        assertEquals(4, in.position());
+        out.clear();
+        try {
+            text.transform(in, out, true);
+            fail("Expected TransformException.");
+        } catch (TransformException e) {
+            assertNotNull(e.getMessage());
+        }
+        assertFalse(in.hasRemaining());
+    }
+
+    /**
+     * Tests a line which does not fit in the target buffer even when that buffer is empty.
+     * The transform shall fail instead of returning without progress.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testLineLargerThanTarget() throws FactoryException, TransformException {
+        final TextTransform text = new TextTransform(new BatchTransform(BatchTransformTest.mercator()), ',', 1, 0);
+        final byte[] bytes = "10,50,a comment long enough for exceeding the target buffer\n".getBytes(StandardCharsets.US_ASCII);
+        final ByteBuffer in  = ByteBuffer.allocateDirect(bytes.length).put(bytes);
+        final ByteBuffer out = ByteBuffer.allocateDirect(16);
+        in.flip();
+        try {
+            text.transform(in, out, true);
+            fail("Expected IllegalArgumentException.");
+        } catch (IllegalArgumentException e) {
+            assertTrue(e.getMessage().contains("line"));
+        }
+        assertEquals(0, in.position());
+        assertEquals(0, out.position());
+    }
+}
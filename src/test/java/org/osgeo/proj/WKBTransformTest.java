@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import org.junit.Test;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests {@link WKBTransform}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class WKBTransformTest {
+    /**
+     * Tests the transform of WKB geometries: a point in big-endian order and a linestring
+     * in little-endian EWKB with a SRID. Results shall be the same as with {@link MathTransform}.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testPointAndLineString() throws FactoryException, TransformException {
+        final MathTransform mt = BatchTransformTest.mercator();
+        final double[] data = BatchTransformTest.TEST_DATA;
+        final int numPts = data.length / 2;
+        final double[] expected = new double[data.length];
+        mt.transform(data, 0, expected, 0, numPts);
+
+        final ByteBuffer buffer = ByteBuffer.allocate(21 + 13 + 16 * numPts);
+        buffer.put((byte) 0).putInt(1).putDouble(data[0]).putDouble(data[1]);
+        final int split = buffer.position();
+        buffer.order(ByteOrder.LITTLE_ENDIAN);
+        buffer.put((byte) 1).putInt(0x20000002).putInt(4326).putInt(numPts);
+        for (final double value : data) {
+            buffer.putDouble(value);
+        }
+        final byte[] source = buffer.array();
+        final byte[] target = new byte[source.length];
+        final boolean[] failures = new boolean[2];
+        final WKBTransform wkb = new WKBTransform(new BatchTransform(mt));
+        wkb.transform(source, new int[] {0, split, source.length}, 2, target, 3395, failures);
+        assertFalse(failures[0]);
+        assertFalse(failures[1]);
+
+        final ByteBuffer result = ByteBuffer.wrap(target);
+        assertEquals(0, result.get());
+        assertEquals(1, result.getInt());
+        assertEquals(expected[0], result.getDouble(), 0.01);
+        assertEquals(expected[1], result.getDouble(), 0.01);
+        result.order(ByteOrder.LITTLE_ENDIAN);
+        assertEquals(1, result.get());
+        assertEquals(0x20000002, result.getInt());
+        assertEquals(3395, result.getInt());
+        assertEquals(numPts, result.getInt());
+        for (final double value : expected) {
+            assertEquals(value, result.getDouble(), 0.01);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2019-2021 Agency for Data Supply and Efficiency
+ * Copyright © 2021-2023 Open Source Geospatial Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.osgeo.proj.jts;
+
+import org.junit.Test;
+import org.locationtech.jts.geom.Coordinate;
+import org.locationtech.jts.geom.CoordinateSequence;
+import org.locationtech.jts.geom.Geometry;
+import org.locationtech.jts.geom.GeometryFactory;
+import org.locationtech.jts.geom.LineString;
+import org.locationtech.jts.geom.Point;
+import org.locationtech.jts.geom.Polygon;
+import org.locationtech.jts.geom.impl.PackedCoordinateSequence;
+import org.locationtech.jts.geom.impl.PackedCoordinateSequenceFactory;
+import org.opengis.util.FactoryException;
+import org.opengis.referencing.crs.CoordinateReferenceSystem;
+import org.opengis.referencing.operation.MathTransform;
+import org.opengis.referencing.operation.TransformException;
+import org.osgeo.proj.BatchTransform;
+import org.osgeo.proj.Proj;
+
+import static org.junit.Assert.*;
+
+
+/**
+ * Tests {@link JTS}.
+ *
+ * @author  Martin Desruisseaux (Geomatys)
+ * @version 2.1
+ * @since   2.1
+ */
+public final strictfp class JTSTest {
+    /**
+     * Returns the transform from EPSG:4326 to EPSG:3395 (World Mercator).
+     * Source coordinates are in (latitude, longitude) order.
+     *
+     * @return the transform to test.
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     */
+    private static MathTransform mercator() throws FactoryException {
+        final CoordinateReferenceSystem source = (CoordinateReferenceSystem) Proj.createFromUserInput("EPSG:4326");
+        final CoordinateReferenceSystem target = (CoordinateReferenceSystem) Proj.createFromUserInput("EPSG:3395");
+        return Proj.createCoordinateOperation(source, target, null).getMathTransform();
+    }
+
+    /**
+     * Verifies that the given sequence contains the transformed coordinates of the given (latitude, longitude) values.
+     *
+     * @param  mt         the transform used for computing expected values.
+     * @param  source     the source coordinates in (latitude, longitude) order.
+     * @param  actual     the transformed sequence to verify.
+     * @param  tolerance  the tolerance threshold in metres.
+     * @throws TransformException if an error occurred while computing the expected values.
+     */
+    private static void verify(final MathTransform mt, final double[] source, final CoordinateSequence actual,
+                               final double tolerance) throws TransformException
+    {
+        final double[] expected = new double[source.length];
+        mt.transform(source, 0, expected, 0, source.length / 2);
+        assertEquals(source.length / 2, actual.size());
+        for (int i=0; i<actual.size(); i++) {
+            assertEquals(expected[i*2    ], actual.getX(i), tolerance);
+            assertEquals(expected[i*2 + 1], actual.getY(i), tolerance);
+        }
+    }
+
+    /**
+     * Tests the transformation of a geometry collection with packed and non-packed sequences.
+     * The measures shall be left unchanged.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testGeometryCollection() throws FactoryException, TransformException {
+        final MathTransform mt = mercator();
+        final BatchTransform batch = new BatchTransform(mt);
+        final double[] ring  = {45, -73, 46, -73, 46, -72, 45, -73};
+        final double[] line  = {49.25, -123.1, 35.653, 139.839};
+        final double[] point = {48.865, 2.349};
+
+        final GeometryFactory packed = new GeometryFactory(PackedCoordinateSequenceFactory.DOUBLE_FACTORY);
+        final GeometryFactory floats = new GeometryFactory(PackedCoordinateSequenceFactory.FLOAT_FACTORY);
+        final GeometryFactory arrays = new GeometryFactory();
+
+        final CoordinateSequence withMeasures = new PackedCoordinateSequence.Double(
+                new double[] {45, -73, 10, 46, -73, 20, 46, -72, 30, 45, -73, 40}, 3, 1);
+        final Polygon   polygon  = packed.createPolygon(withMeasures);
+        final LineString lines   = floats.createLineString(floats.getCoordinateSequenceFactory().create(
+                new PackedCoordinateSequence.Double(line, 2, 0)));
+        final Point     location = arrays.createPoint(new Coordinate(point[0], point[1]));
+        final Geometry  source   = arrays.createGeometryCollection(new Geometry[] {polygon, lines, location});
+
+        final Geometry result = JTS.transform(source, batch);
+        assertNotSame(source, result);
+        assertEquals(45, source.getGeometryN(0).getCoordinates()[0].x, 0);     // Source shall be unchanged.
+
+        final CoordinateSequence cs = ((Polygon) result.getGeometryN(0)).getExteriorRing().getCoordinateSequence();
+        verify(mt, ring, cs, 1E-6);
+        for (int i=0; i<cs.size(); i++) {
+            assertEquals((i+1) * 10, cs.getM(i), 0);
+        }
+        verify(mt, line,  ((LineString) result.getGeometryN(1)).getCoordinateSequence(), 4);
+        verify(mt, point, ((Point)      result.getGeometryN(2)).getCoordinateSequence(), 1E-6);
+        assertEquals(result.getGeometryN(2).getCoordinate().x, result.getGeometryN(2).getEnvelopeInternal().getMinX(), 0);
+    }
+
+    /**
+     * Tests the in-place transformation of a single packed sequence. The values shall be transformed
+     * in the raw array of the sequence, without being read with {@code getOrdinate(…)} in a staging copy.
+     * The {@code Coordinate} objects cached by the sequence shall be discarded.
+     *
+     * @throws FactoryException if an error occurred while creating a CRS or the operation.
+     * @throws TransformException if an error occurred while transforming a coordinate.
+     */
+    @Test
+    public void testInPlace() throws FactoryException, TransformException {
+        final MathTransform mt = mercator();
+        final double[] source = {45.5, -73.567, -12.046, -77.043};
+        final int[] reads = new int[1];
+        final PackedCoordinateSequence.Double sequence = new PackedCoordinateSequence.Double(source.clone(), 2, 0) {
+            @Override public double getOrdinate(final int index, final int ordinate) {
+                reads[0]++;
+                return super.getOrdinate(index, ordinate);
+            }
+        };
+        assertEquals(source[0], sequence.getCoordinate(0).x, 0);        // Cache a Coordinate object.
+        reads[0] = 0;
+        JTS.transformInPlace(new CoordinateSequence[] {sequence}, new BatchTransform(mt));
+        assertEquals("The values shall not be copied.", 0, reads[0]);
+        verify(mt, source, sequence, 1E-6);
+        assertEquals(sequence.getX(0), sequence.getCoordinate(0).x, 0);
+    }
+}